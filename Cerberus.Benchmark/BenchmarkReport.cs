@@ -0,0 +1,98 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using Newtonsoft.Json;
+
+namespace Cerberus.Benchmark
+{
+    /// <summary>
+    /// A class to hold the results of a benchmark run, also used as the stored baseline
+    /// </summary>
+    class BenchmarkReport
+    {
+        /// <summary>
+        /// Gets or Sets the version of Cerberus that was benchmarked
+        /// </summary>
+        public string Version { get; set; }
+
+        /// <summary>
+        /// Gets or Sets when the run was made
+        /// </summary>
+        public DateTime Date { get; set; }
+
+        /// <summary>
+        /// Gets or Sets the number of timed iterations, the best time of each is kept
+        /// </summary>
+        public int Iterations { get; set; }
+
+        /// <summary>
+        /// Gets or Sets the peak working set of the process over the whole run
+        /// </summary>
+        public long PeakWorkingSet { get; set; }
+
+        /// <summary>
+        /// Gets or Sets the totals for each game and stage
+        /// </summary>
+        public List<StageResult> Stages { get; set; } = new List<StageResult>();
+
+        /// <summary>
+        /// Gets or Sets the results for each script
+        /// </summary>
+        public List<ScriptResult> Scripts { get; set; } = new List<ScriptResult>();
+
+        /// <summary>
+        /// Gets or Sets the slowest functions to decompile
+        /// </summary>
+        public List<FunctionResult> Outliers { get; set; } = new List<FunctionResult>();
+    }
+
+    /// <summary>
+    /// A class to hold the totals of a stage for a game
+    /// </summary>
+    class StageResult
+    {
+        public string Game { get; set; }
+        public string Stage { get; set; }
+        public double Milliseconds { get; set; }
+        public long Instructions { get; set; }
+        public long AllocatedBytes { get; set; }
+
+        /// <summary>
+        /// Gets the number of instructions processed per second
+        /// </summary>
+        [JsonIgnore]
+        public double InstructionsPerSecond => Milliseconds > 0 ? Instructions / (Milliseconds / 1000.0) : 0;
+    }
+
+    /// <summary>
+    /// A class to hold the best times of a script
+    /// </summary>
+    class ScriptResult
+    {
+        public string Path { get; set; }
+        public string Game { get; set; }
+        public long Instructions { get; set; }
+        public double LoadMilliseconds { get; set; }
+        public double DisassembleMilliseconds { get; set; }
+        public double DecompileMilliseconds { get; set; }
+
+        /// <summary>
+        /// Gets or Sets the hash of each function's decompiled output, so changes to the output show up against the baseline
+        /// </summary>
+        public Dictionary<string, string> Outputs { get; set; } = new Dictionary<string, string>();
+    }
+
+    /// <summary>
+    /// A class to hold the best decompile time of a function
+    /// </summary>
+    class FunctionResult
+    {
+        public string Script { get; set; }
+        public string Name { get; set; }
+        public string Namespace { get; set; }
+        public int Instructions { get; set; }
+        public double Milliseconds { get; set; }
+    }
+}
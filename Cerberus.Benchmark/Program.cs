@@ -0,0 +1,465 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Reflection;
+using System.Text;
+using System.Threading.Tasks;
+using Cerberus.Logic;
+using CommandLine;
+using Newtonsoft.Json;
+
+namespace Cerberus.Benchmark
+{
+    class Program
+    {
+        /// <summary>
+        /// File Extensions we accept
+        /// </summary>
+        static readonly string[] AcceptedExtensions =
+        {
+            ".gsc",
+            ".csc",
+            ".gscc",
+            ".cscc",
+        };
+
+        /// <summary>
+        /// Stages we measure
+        /// </summary>
+        static readonly string[] Stages =
+        {
+            "Load",
+            "Disassemble",
+            "Decompile",
+        };
+
+        /// <summary>
+        /// Command Line Options
+        /// </summary>
+        static BenchmarkOptions Options { get; set; }
+
+        /// <summary>
+        /// Supported Hash Tables
+        /// </summary>
+        static readonly Dictionary<string, Dictionary<uint, string>> HashTables = new Dictionary<string, Dictionary<uint, string>>()
+        {
+            { "BlackOps2", new Dictionary<uint, string>() },
+            { "BlackOps3", new Dictionary<uint, string>() },
+        };
+
+        /// <summary>
+        /// Class to hold benchmark options
+        /// </summary>
+        class BenchmarkOptions
+        {
+            [Option('i', "input", Required = true, HelpText = "Folder of compiled scripts to benchmark, searched recursively.")]
+            public string InputDirectory { get; set; }
+            [Option('r', "iterations", Required = false, Default = 3, HelpText = "Number of timed iterations, the best time is kept.")]
+            public int Iterations { get; set; }
+            [Option('o', "output", Required = false, HelpText = "Saves the results to the given file, can be used as a baseline.")]
+            public string OutputFile { get; set; }
+            [Option('b', "baseline", Required = false, HelpText = "Compares the results against the given baseline and fails on regressions.")]
+            public string BaselineFile { get; set; }
+            [Option('t', "threshold", Required = false, Default = 10.0, HelpText = "Percentage a stage or script can slow down by before it's a regression.")]
+            public double Threshold { get; set; }
+            [Option('m', "min-ms", Required = false, Default = 5.0, HelpText = "Scripts must also slow down by at least this many milliseconds to be a regression.")]
+            public double MinimumMilliseconds { get; set; }
+            [Option('n', "outliers", Required = false, Default = 10, HelpText = "Number of slowest functions to report.")]
+            public int OutlierCount { get; set; }
+        }
+
+        /// <summary>
+        /// Loads in the hash tables from the working directory
+        /// </summary>
+        static void LoadHashTables()
+        {
+            foreach (var hashTable in HashTables)
+            {
+                ScriptBase.LoadHashTable(Path.Combine(Directory.GetCurrentDirectory(), hashTable.Key + ".txt"), hashTable.Value);
+            }
+        }
+
+        /// <summary>
+        /// Runs each stage on the script and records the times
+        /// </summary>
+        static void RunScript(string filePath, byte[] buffer, Dictionary<string, ScriptResult> scripts, Dictionary<string, FunctionResult> functions, Dictionary<string, StageResult> stages)
+        {
+            var watch = new Stopwatch();
+
+            watch.Start();
+            var allocated = AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize;
+            var script = ScriptBase.LoadScript(new BinaryReader(new MemoryStream(buffer)), HashTables);
+            watch.Stop();
+
+            using (script)
+            {
+                var instructions = script.Exports.Sum(x => (long)x.Operations.Count);
+
+                if (!scripts.TryGetValue(filePath, out var result))
+                {
+                    result = new ScriptResult()
+                    {
+                        Path                    = filePath,
+                        Game                    = script.Game,
+                        Instructions            = instructions,
+                        LoadMilliseconds        = double.MaxValue,
+                        DisassembleMilliseconds = double.MaxValue,
+                        DecompileMilliseconds   = double.MaxValue,
+                    };
+
+                    scripts[filePath] = result;
+                }
+
+                result.LoadMilliseconds = Math.Min(result.LoadMilliseconds, watch.Elapsed.TotalMilliseconds);
+                allocated = AddStage(stages, script.Game, "Load", watch.Elapsed.TotalMilliseconds, instructions, allocated);
+
+                watch.Restart();
+                script.Disassemble(TextWriter.Null);
+                watch.Stop();
+
+                result.DisassembleMilliseconds = Math.Min(result.DisassembleMilliseconds, watch.Elapsed.TotalMilliseconds);
+                allocated = AddStage(stages, script.Game, "Disassemble", watch.Elapsed.TotalMilliseconds, instructions, allocated);
+
+                // Decompile each function on its own so we can find the ones that are slow
+                var decompileTime = 0.0;
+
+                foreach (var function in script.Exports)
+                {
+                    string output;
+
+                    watch.Restart();
+
+                    try
+                    {
+                        output = script.DecompileFunction(function);
+                    }
+                    catch (Exception e)
+                    {
+                        Console.WriteLine(": Failed to decompile {0}::{1} in {2}: {3}", function.Namespace, function.Name, filePath, e.Message);
+                        output = e.Message;
+                    }
+
+                    watch.Stop();
+                    decompileTime += watch.Elapsed.TotalMilliseconds;
+
+                    var outputKey = function.Namespace + "::" + function.Name + "|" + function.ByteCodeOffset;
+
+                    if (!result.Outputs.ContainsKey(outputKey))
+                    {
+                        result.Outputs[outputKey] = ScriptStore.ComputeHash(Encoding.UTF8.GetBytes(output));
+                    }
+
+                    var key = filePath + "|" + function.Namespace + "::" + function.Name + "|" + function.ByteCodeOffset;
+
+                    if (!functions.TryGetValue(key, out var functionResult))
+                    {
+                        functionResult = new FunctionResult()
+                        {
+                            Script       = filePath,
+                            Name         = function.Name,
+                            Namespace    = function.Namespace,
+                            Instructions = function.Operations.Count,
+                            Milliseconds = double.MaxValue,
+                        };
+
+                        functions[key] = functionResult;
+                    }
+
+                    functionResult.Milliseconds = Math.Min(functionResult.Milliseconds, watch.Elapsed.TotalMilliseconds);
+                }
+
+                result.DecompileMilliseconds = Math.Min(result.DecompileMilliseconds, decompileTime);
+                AddStage(stages, script.Game, "Decompile", decompileTime, instructions, allocated);
+            }
+        }
+
+        /// <summary>
+        /// Adds the time and allocations to the stage's totals
+        /// </summary>
+        /// <returns>Total allocated bytes at the end of the stage</returns>
+        static long AddStage(Dictionary<string, StageResult> stages, string game, string stage, double milliseconds, long instructions, long allocatedBefore)
+        {
+            var allocated = AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize;
+            var key = game + "|" + stage;
+
+            if (!stages.TryGetValue(key, out var result))
+            {
+                result = new StageResult()
+                {
+                    Game  = game,
+                    Stage = stage,
+                };
+
+                stages[key] = result;
+            }
+
+            result.Milliseconds   += milliseconds;
+            result.Instructions   += instructions;
+            result.AllocatedBytes += allocated - allocatedBefore;
+
+            return allocated;
+        }
+
+        /// <summary>
+        /// Runs the benchmark over all scripts
+        /// </summary>
+        static BenchmarkReport Run(List<KeyValuePair<string, byte[]>> files)
+        {
+            var scripts   = new Dictionary<string, ScriptResult>();
+            var functions = new Dictionary<string, FunctionResult>();
+            var stages    = new Dictionary<string, StageResult>();
+
+            // First pass is a warm up so we aren't timing the JIT, it
+            // also drops anything that isn't a script we can load
+            Console.WriteLine(": Warming up..");
+
+            files.RemoveAll(file =>
+            {
+                try
+                {
+                    RunScript(file.Key, file.Value, new Dictionary<string, ScriptResult>(), new Dictionary<string, FunctionResult>(), new Dictionary<string, StageResult>());
+                    return false;
+                }
+                catch (Exception e)
+                {
+                    Console.WriteLine(": Skipping {0}: {1}", file.Key, e.Message);
+                    return true;
+                }
+            });
+
+            var best = new Dictionary<string, StageResult>();
+
+            for (int i = 0; i < Options.Iterations; i++)
+            {
+                Console.WriteLine(": Running iteration {0}/{1}..", i + 1, Options.Iterations);
+
+                // Settle the heap so one iteration's garbage isn't collected in the next
+                GC.Collect();
+                GC.WaitForPendingFinalizers();
+                GC.Collect();
+
+                stages.Clear();
+
+                foreach (var file in files)
+                {
+                    RunScript(file.Key, file.Value, scripts, functions, stages);
+                }
+
+                foreach (var stage in stages)
+                {
+                    if (!best.TryGetValue(stage.Key, out var current) || stage.Value.Milliseconds < current.Milliseconds)
+                    {
+                        best[stage.Key] = stage.Value;
+                    }
+                }
+            }
+
+            // The peak is process wide, so it's only meaningful for the run as a whole
+            long peakWorkingSet;
+
+            using (var process = Process.GetCurrentProcess())
+            {
+                peakWorkingSet = process.PeakWorkingSet64;
+            }
+
+            return new BenchmarkReport()
+            {
+                Version        = Assembly.GetExecutingAssembly().GetName().Version.ToString(),
+                Date           = DateTime.Now,
+                Iterations     = Options.Iterations,
+                PeakWorkingSet = peakWorkingSet,
+                Stages         = best.Values.OrderBy(x => x.Game).ThenBy(x => Array.IndexOf(Stages, x.Stage)).ToList(),
+                Scripts        = scripts.Values.OrderBy(x => x.Path).ToList(),
+                Outliers       = functions.Values.OrderByDescending(x => x.Milliseconds).Take(Options.OutlierCount).ToList(),
+            };
+        }
+
+        /// <summary>
+        /// Prints the report
+        /// </summary>
+        static void PrintReport(BenchmarkReport report)
+        {
+            Console.WriteLine(": ----------------------------------------------------------");
+            Console.WriteLine(": {0,-10} {1,-12} {2,12} {3,14} {4,14}", "Game", "Stage", "Time (ms)", "Inst/sec", "Alloc (MB)");
+
+            foreach (var stage in report.Stages)
+            {
+                Console.WriteLine(": {0,-10} {1,-12} {2,12:0.00} {3,14:0} {4,14:0.00}",
+                    stage.Game,
+                    stage.Stage,
+                    stage.Milliseconds,
+                    stage.InstructionsPerSecond,
+                    stage.AllocatedBytes / 1048576.0);
+            }
+
+            Console.WriteLine(": Peak working set: {0:0.00} MB", report.PeakWorkingSet / 1048576.0);
+
+            Console.WriteLine(": ----------------------------------------------------------");
+            Console.WriteLine(": Slowest functions to decompile:");
+
+            foreach (var function in report.Outliers)
+            {
+                Console.WriteLine(":\t{0,10:0.00}ms {1,6} inst {2}::{3} ({4})",
+                    function.Milliseconds,
+                    function.Instructions,
+                    function.Namespace,
+                    function.Name,
+                    function.Script);
+            }
+
+            Console.WriteLine(": ----------------------------------------------------------");
+        }
+
+        /// <summary>
+        /// Compares the report against the baseline
+        /// </summary>
+        /// <returns>Number of regressions</returns>
+        static int CompareReport(BenchmarkReport report, BenchmarkReport baseline)
+        {
+            var regressions = 0;
+            var threshold = Options.Threshold / 100.0;
+
+            Console.WriteLine(": Comparing against baseline from {0} (version {1})", baseline.Date, baseline.Version);
+
+            foreach (var stage in report.Stages)
+            {
+                var previous = baseline.Stages.FirstOrDefault(x => x.Game == stage.Game && x.Stage == stage.Stage);
+
+                if (previous == null || previous.InstructionsPerSecond <= 0)
+                {
+                    continue;
+                }
+
+                var change = (stage.InstructionsPerSecond - previous.InstructionsPerSecond) / previous.InstructionsPerSecond;
+
+                Console.WriteLine(": {0,-10} {1,-12} {2,14:0} -> {3,14:0} inst/sec ({4:+0.0;-0.0}%)",
+                    stage.Game,
+                    stage.Stage,
+                    previous.InstructionsPerSecond,
+                    stage.InstructionsPerSecond,
+                    change * 100.0);
+
+                if (change < -threshold)
+                {
+                    Console.WriteLine(": REGRESSION: {0} {1} throughput dropped by more than {2}%", stage.Game, stage.Stage, Options.Threshold);
+                    regressions++;
+                }
+            }
+
+            // Totals can hide a handful of scripts that got a lot slower, so check each one
+            var previousScripts = baseline.Scripts.ToDictionary(x => x.Path);
+
+            foreach (var script in report.Scripts)
+            {
+                if (!previousScripts.TryGetValue(script.Path, out var previous))
+                {
+                    continue;
+                }
+
+                var times = new[]
+                {
+                    Tuple.Create("Load", previous.LoadMilliseconds, script.LoadMilliseconds),
+                    Tuple.Create("Disassemble", previous.DisassembleMilliseconds, script.DisassembleMilliseconds),
+                    Tuple.Create("Decompile", previous.DecompileMilliseconds, script.DecompileMilliseconds),
+                };
+
+                foreach (var time in times)
+                {
+                    if (time.Item3 > time.Item2 * (1.0 + threshold) && time.Item3 - time.Item2 >= Options.MinimumMilliseconds)
+                    {
+                        Console.WriteLine(": REGRESSION: {0} {1} went from {2:0.00}ms to {3:0.00}ms", script.Path, time.Item1, time.Item2, time.Item3);
+                        regressions++;
+                    }
+                }
+
+                // Being faster doesn't count for much if the output isn't the same, baselines
+                // from before we stored the output won't have any to compare against
+                if (previous.Outputs == null)
+                {
+                    continue;
+                }
+
+                foreach (var output in script.Outputs)
+                {
+                    if (previous.Outputs.TryGetValue(output.Key, out var previousOutput) && previousOutput != output.Value)
+                    {
+                        Console.WriteLine(": REGRESSION: {0} {1} decompiles differently to the baseline", script.Path, output.Key);
+                        regressions++;
+                    }
+                }
+            }
+
+            return regressions;
+        }
+
+        /// <summary>
+        /// Main Entry Point
+        /// </summary>
+        static int Main(string[] args)
+        {
+            Console.WriteLine(": ----------------------------------------------------------");
+            Console.WriteLine(": Cerberus Benchmark - Black Ops II/III Script Decompiler");
+            Console.WriteLine(": Version: {0}", Assembly.GetExecutingAssembly().GetName().Version);
+            Console.WriteLine(": ----------------------------------------------------------");
+
+            Parser.Default.ParseArguments<BenchmarkOptions>(args).WithParsed(x => Options = x);
+
+            if (Options == null)
+            {
+                return 2;
+            }
+
+            // Required for per stage allocation counts
+            AppDomain.MonitoringIsEnabled = true;
+
+            LoadHashTables();
+
+            // Read everything up front so we're timing the decompiler, not the disk
+            var files = Directory.EnumerateFiles(Options.InputDirectory, "*", SearchOption.AllDirectories)
+                .Where(x => AcceptedExtensions.Contains(Path.GetExtension(x).ToLower()))
+                .OrderBy(x => x)
+                .Select(x => new KeyValuePair<string, byte[]>(x.Substring(Options.InputDirectory.Length).TrimStart('\\', '/'), File.ReadAllBytes(x)))
+                .ToList();
+
+            Console.WriteLine(": Found {0} scripts", files.Count);
+
+            if (files.Count == 0)
+            {
+                return 2;
+            }
+
+            var report = Run(files);
+
+            if (report.Scripts.Count == 0)
+            {
+                return 2;
+            }
+
+            PrintReport(report);
+
+            if (!string.IsNullOrWhiteSpace(Options.OutputFile))
+            {
+                File.WriteAllText(Options.OutputFile, JsonConvert.SerializeObject(report, Formatting.Indented));
+                Console.WriteLine(": Saved results to {0}", Options.OutputFile);
+            }
+
+            if (!string.IsNullOrWhiteSpace(Options.BaselineFile))
+            {
+                var baseline = JsonConvert.DeserializeObject<BenchmarkReport>(File.ReadAllText(Options.BaselineFile));
+                var regressions = CompareReport(report, baseline);
+
+                if (regressions > 0)
+                {
+                    Console.WriteLine(": {0} regression(s) found", regressions);
+                    return 1;
+                }
+
+                Console.WriteLine(": No regressions found");
+            }
+
+            return 0;
+        }
+    }
+}
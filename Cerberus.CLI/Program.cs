@@ -35,6 +35,16 @@ namespace Cerberus.CLI
         /// </summary>
         static CliOptions Options { get; set; }
 
+        /// <summary>
+        /// Decompiled function cache, null if not enabled
+        /// </summary>
+        static DecompilerCache Cache { get; set; }
+
+        /// <summary>
+        /// Content addressed script store, null if not enabled
+        /// </summary>
+        static ScriptStore Store { get; set; }
+
         /// <summary>
         /// Supported Hash Tables
         /// </summary>
@@ -55,6 +65,16 @@ namespace Cerberus.CLI
             public bool Disassemble { get; set; }
             [Option('n', "close", Required = false, HelpText = "Closes the program once execution has finished.")]
             public bool Close { get; set; }
+            [Option('c', "cache", Required = false, HelpText = "Caches decompiled functions in the given folder and reuses them across runs.")]
+            public string CacheDirectory { get; set; }
+            [Option('t', "trace", Required = false, HelpText = "Writes a Chrome/Perfetto trace of where time is spent to the given file.")]
+            public string TraceFile { get; set; }
+            [Option('s', "store", Required = false, HelpText = "Stores extracted scripts by content in the given folder and skips scripts that were already processed.")]
+            public string StoreDirectory { get; set; }
+            [Option('p', "serve", Required = false, HelpText = "Stays resident and serves decompile/disassemble/extract requests on the given named pipe.")]
+            public string PipeName { get; set; }
+            [Option('w', "watch", Required = false, HelpText = "Watches the given folder and reprocesses scripts as they change.")]
+            public string WatchDirectory { get; set; }
             [Option('h', "help", Required = false, HelpText = "Prints this message.")]
             public bool Help { get; set; }
         }
@@ -69,33 +89,9 @@ namespace Cerberus.CLI
             {
                 try
                 {
-                    string[] lines = File.ReadAllLines(Path.Combine(Directory.GetCurrentDirectory(), hashTable.Key + ".txt"));
-                    PrintVerbose(": Loading " + hashTable.Key + ".txt");
-                    foreach (string line in lines)
+                    if (ScriptBase.LoadHashTable(Path.Combine(Directory.GetCurrentDirectory(), hashTable.Key + ".txt"), hashTable.Value))
                     {
-                        try
-                        {
-                            string lineTrim = line.Trim();
-
-                            // Ignore comment lines
-                            if (!lineTrim.StartsWith("#"))
-                            {
-                                string[] lineSplit = lineTrim.Split(',');
-
-                                if (lineSplit.Length > 1)
-                                {
-                                    // Parse as hex, without 0x
-                                    if (uint.TryParse(lineSplit[0].TrimStart('0', 'x'), NumberStyles.HexNumber, CultureInfo.CurrentCulture, out var hash))
-                                    {
-                                        hashTable.Value[hash] = lineSplit[1];
-                                    }
-                                }
-                            }
-                        }
-                        catch
-                        {
-                            continue;
-                        }
+                        PrintVerbose(": Loaded " + hashTable.Key + ".txt");
                     }
                 }
                 catch
@@ -105,6 +101,23 @@ namespace Cerberus.CLI
             }
         }
 
+        /// <summary>
+        /// Prints the cache statistics and writes the trace, if enabled
+        /// </summary>
+        static void Finish()
+        {
+            if (Cache != null)
+            {
+                Console.WriteLine(": Decompiler cache: {0} hits, {1} misses", Cache.Hits, Cache.Misses);
+            }
+
+            if (PipelineTrace.Enabled)
+            {
+                PipelineTrace.Stop(Options.TraceFile);
+                Console.WriteLine(": Wrote trace to {0}", Path.GetFullPath(Options.TraceFile));
+            }
+        }
+
         /// <summary>
         /// Prints a message in verbose mode
         /// </summary>
@@ -146,10 +159,32 @@ namespace Cerberus.CLI
         /// <param name="filePath"></param>
         static void ProcessScript(string filePath)
         {
-            using(var reader = new BinaryReader(File.OpenRead(filePath)))
+            ProcessScript(filePath, File.ReadAllBytes(filePath), true);
+        }
+
+        /// <summary>
+        /// Processes a script file that has already been read
+        /// </summary>
+        /// <param name="filePath">Path of the script</param>
+        /// <param name="buffer">Script data</param>
+        /// <param name="skipProcessed">Whether to skip the script if the store has already processed identical content</param>
+        static void ProcessScript(string filePath, byte[] buffer, bool skipProcessed)
+        {
+            var hash = Store != null ? ScriptStore.ComputeHash(buffer) : null;
+
+            // Identical copies of shared scripts only need to be done once
+            if (hash != null && skipProcessed && Store.IsProcessed(hash))
+            {
+                PrintVerbose(string.Format(": Skipping {0}, identical script already processed.", filePath));
+                return;
+            }
+
+            using (PipelineTrace.Begin("CLI", "ProcessScript", filePath))
+            using (var reader = new BinaryReader(new MemoryStream(buffer)))
             {
                 using (var script = ScriptBase.LoadScript(reader, HashTables))
                 {
+                    script.Cache = Cache;
                     PrintVerbose(string.Format(": Processing {0} script.", script.Game));
                     var outputPath = Path.Combine(ProcessDirectory, script.Game, script.FilePath);
                     Directory.CreateDirectory(Path.GetDirectoryName(outputPath));
@@ -158,15 +193,50 @@ namespace Cerberus.CLI
                     if (Options.Disassemble)
                     {
                         PrintVerbose(": Disassembling script..");
-                        File.WriteAllText(outputPath + ".script_asm" + Path.GetExtension(outputPath), script.Disassemble());
+                        script.DisassembleToFile(outputPath + ".script_asm" + Path.GetExtension(outputPath));
                     }
 
                     PrintVerbose(": Decompiling script..");
-                    File.WriteAllText(outputPath + ".decompiled" + Path.GetExtension(outputPath), script.Decompile());
+                    var decompiled = script.Decompile();
+
+                    using (PipelineTrace.Begin("CLI", "WriteOutput", outputPath))
+                    {
+                        File.WriteAllText(outputPath + ".decompiled" + Path.GetExtension(outputPath), decompiled);
+                    }
+
+                    if (hash != null)
+                    {
+                        Store.MarkProcessed(hash);
+                    }
                 }
             }
         }
 
+        /// <summary>
+        /// Extracts the scripts from a fast file and processes them
+        /// </summary>
+        static void ProcessFastFile(string filePath)
+        {
+            PrintVerbose(": Decompressing and Processing Fast File.....");
+
+            var outputPath = filePath + ".output";
+
+            try
+            {
+                var files = FastFile.Decompress(filePath, outputPath, Store);
+
+                foreach (var file in files)
+                {
+                    PrintVerbose(string.Format(": Found {0}", file));
+                    ProcessScript(file);
+                }
+            }
+            finally
+            {
+                File.Delete(outputPath);
+            }
+        }
+
         /// <summary>
         /// Main Entry Point
         /// </summary>
@@ -188,8 +258,78 @@ namespace Cerberus.CLI
 
             Console.WriteLine(": Exporting to: {0}", Directory.GetCurrentDirectory());
 
+            if (!string.IsNullOrWhiteSpace(Options.TraceFile))
+            {
+                PipelineTrace.Start();
+            }
+
             LoadHashTables();
 
+            if (!string.IsNullOrWhiteSpace(Options.CacheDirectory))
+            {
+                Cache = new DecompilerCache(Options.CacheDirectory);
+                PrintVerbose(string.Format(": Using decompiler cache at {0}", Cache.Directory));
+            }
+
+            if (!string.IsNullOrWhiteSpace(Options.StoreDirectory))
+            {
+                Store = new ScriptStore(Options.StoreDirectory, ScriptStore.ComputeConfiguration(HashTables, "Disassemble=" + Options.Disassemble));
+                PrintVerbose(string.Format(": Using script store at {0}", Store.Directory));
+            }
+
+            if (!string.IsNullOrWhiteSpace(Options.PipeName))
+            {
+                Console.WriteLine(": Serving requests on pipe {0}, press Ctrl+C to stop", Options.PipeName);
+
+                var server = new ScriptServer(Options.PipeName, HashTables, Cache, Store);
+
+                // Stop cleanly so we still write the trace and statistics
+                Console.CancelKeyPress += (s, e) =>
+                {
+                    e.Cancel = true;
+                    server.Stop();
+                };
+
+                try
+                {
+                    server.Run(Environment.ProcessorCount);
+                }
+                finally
+                {
+                    Finish();
+                }
+
+                return;
+            }
+
+            if (!string.IsNullOrWhiteSpace(Options.WatchDirectory))
+            {
+                Console.WriteLine(": Watching {0}, press Ctrl+C to stop", Path.GetFullPath(Options.WatchDirectory));
+
+                try
+                {
+                    // The watcher compares each file against its own last content, so the store isn't
+                    // consulted, a file reverted to content processed earlier must still be rewritten
+                    using (var watcher = new ScriptWatcher(Options.WatchDirectory, AcceptedExtensions.Where(x => x != ".ff").ToArray(), ProcessDirectory, (path, data) => ProcessScript(path, data, false)))
+                    {
+                        // Stop cleanly so we still write the trace and statistics
+                        Console.CancelKeyPress += (s, e) =>
+                        {
+                            e.Cancel = true;
+                            watcher.Stop();
+                        };
+
+                        watcher.Run(Environment.ProcessorCount);
+                    }
+                }
+                finally
+                {
+                    Finish();
+                }
+
+                return;
+            }
+
             var files = Directory.GetFiles(Path.GetDirectoryName(Assembly.GetExecutingAssembly().Location), "*.*", SearchOption.AllDirectories);
 
             Console.WriteLine(files.Length);
@@ -215,6 +355,16 @@ namespace Cerberus.CLI
                                         ProcessScript(arg);
                                         break;
                                     }
+                                case ".ff":
+                                    {
+                                        // Only with a store, otherwise every zone rewrites and
+                                        // redecompiles the same shared scripts
+                                        if (Store != null)
+                                        {
+                                            ProcessFastFile(arg);
+                                        }
+                                        break;
+                                    }
                             }
 
                             Console.WriteLine(": Processed {0} successfully.", Path.GetFileName(arg));
@@ -298,6 +448,8 @@ namespace Cerberus.CLI
             //                }
             //            }
 
+            Finish();
+
             if (Options.Help || filesProcessed <= 0)
             {
                 PrintHelp(cliOptions);
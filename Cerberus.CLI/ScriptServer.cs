@@ -0,0 +1,319 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Pipes;
+using System.Text;
+using System.Threading;
+using Cerberus.Logic;
+
+namespace Cerberus.CLI
+{
+    /// <summary>
+    /// A class to serve decompile/disassemble/extract requests over a named pipe
+    ///
+    /// Every frame is a little endian int32 length followed by that many bytes.
+    ///
+    /// A request is one frame holding the command byte (1 = decompile, 2 = disassemble,
+    /// 3 = extract), a length prefixed UTF-8 path (BinaryWriter.Write(string)), and an
+    /// int32 size followed by the script data. If the size is 0 the script is read from
+    /// the path, extract always reads the fast file from the path.
+    ///
+    /// A response is the UTF-8 output as any number of frames, then an empty frame, then a
+    /// status frame holding one byte (0 = ok, 1 = error). The status is only sent once the
+    /// output is complete, an error status means the output is partial and is followed by the
+    /// UTF-8 error message as any number of frames, then an empty frame.
+    /// A connection can send any number of requests, a request frame must be between 1 byte
+    /// and <see cref="MaxRequestSize"/>, otherwise it gets an error status and is disconnected.
+    /// </summary>
+    class ScriptServer
+    {
+        /// <summary>
+        /// Largest request we accept, enough for any script sent with its data
+        /// </summary>
+        private const int MaxRequestSize = 0x4000000;
+
+        /// <summary>
+        /// Commands
+        /// </summary>
+        enum Command : byte
+        {
+            Decompile = 1,
+            Disassemble = 2,
+            Extract = 3,
+        }
+
+        /// <summary>
+        /// A stream that writes each write as a frame
+        /// </summary>
+        class FrameStream : Stream
+        {
+            private readonly BinaryWriter Writer;
+
+            public FrameStream(Stream stream) => Writer = new BinaryWriter(stream, Encoding.UTF8, true);
+
+            public override bool CanRead => false;
+            public override bool CanSeek => false;
+            public override bool CanWrite => true;
+            public override long Length => throw new NotSupportedException();
+            public override long Position { get => throw new NotSupportedException(); set => throw new NotSupportedException(); }
+
+            public override void Write(byte[] buffer, int offset, int count)
+            {
+                if (count > 0)
+                {
+                    Writer.Write(count);
+                    Writer.Write(buffer, offset, count);
+                }
+            }
+
+            /// <summary>
+            /// Writes the empty frame that ends the output
+            /// </summary>
+            public void Complete()
+            {
+                Writer.Write(0);
+                Writer.Flush();
+            }
+
+            public override void Flush() => Writer.Flush();
+            public override int Read(byte[] buffer, int offset, int count) => throw new NotSupportedException();
+            public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+            public override void SetLength(long value) => throw new NotSupportedException();
+        }
+
+        /// <summary>
+        /// Gets the name of the pipe
+        /// </summary>
+        public string PipeName { get; private set; }
+
+        /// <summary>
+        /// Hash tables shared by all workers
+        /// </summary>
+        private readonly Dictionary<string, Dictionary<uint, string>> HashTables;
+
+        /// <summary>
+        /// Optional decompiler cache
+        /// </summary>
+        private readonly DecompilerCache Cache;
+
+        /// <summary>
+        /// Optional script store used for extraction
+        /// </summary>
+        private readonly ScriptStore Store;
+
+        /// <summary>
+        /// Signaled when the server should stop
+        /// </summary>
+        private readonly ManualResetEvent Stopping = new ManualResetEvent(false);
+
+        /// <summary>
+        /// Initializes an instance of the Script Server
+        /// </summary>
+        public ScriptServer(string pipeName, Dictionary<string, Dictionary<uint, string>> hashTables, DecompilerCache cache, ScriptStore store)
+        {
+            PipeName = pipeName;
+            HashTables = hashTables;
+            Cache = cache;
+            Store = store;
+        }
+
+        /// <summary>
+        /// Runs the server with the given number of workers, blocks until <see cref="Stop"/> is called
+        /// </summary>
+        public void Run(int workerCount)
+        {
+            // Touch the op code tables so the first request doesn't pay for them
+            var _ = ScriptOpMetadata.OperationInfo.Length;
+
+            for (int i = 0; i < workerCount; i++)
+            {
+                new Thread(Worker)
+                {
+                    Name = "Server Worker " + i,
+                    IsBackground = true
+                }.Start();
+            }
+
+            // Workers are background threads blocked on the pipe, they end with the process
+            Stopping.WaitOne();
+        }
+
+        /// <summary>
+        /// Stops the server, <see cref="Run"/> returns once called
+        /// </summary>
+        public void Stop()
+        {
+            Stopping.Set();
+        }
+
+        /// <summary>
+        /// Accepts connections and handles their requests
+        /// </summary>
+        private void Worker()
+        {
+            while (true)
+            {
+                using (var pipe = new NamedPipeServerStream(PipeName, PipeDirection.InOut, NamedPipeServerStream.MaxAllowedServerInstances, PipeTransmissionMode.Byte))
+                {
+                    try
+                    {
+                        pipe.WaitForConnection();
+
+                        using (var reader = new BinaryReader(pipe, Encoding.UTF8, true))
+                        {
+                            while (pipe.IsConnected)
+                            {
+                                byte[] request;
+
+                                try
+                                {
+                                    var length = reader.ReadInt32();
+
+                                    // We can't trust anything after a bad length, so tell them and drop them
+                                    if (length <= 0 || length > MaxRequestSize)
+                                    {
+                                        WriteResponse(new FrameStream(pipe), pipe, "Invalid request size " + length);
+                                        break;
+                                    }
+
+                                    request = reader.ReadBytes(length);
+
+                                    if (request.Length != length)
+                                    {
+                                        break;
+                                    }
+                                }
+                                catch (EndOfStreamException)
+                                {
+                                    break;
+                                }
+
+                                HandleRequest(request, pipe);
+                            }
+                        }
+                    }
+                    catch (IOException)
+                    {
+                        // Client went away mid request
+                    }
+                    catch (Exception e)
+                    {
+                        // One bad connection shouldn't take the worker down with it
+                        Console.WriteLine(": An error has occured while serving a request: {0}", e.Message);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Handles a single request and writes the response
+        /// </summary>
+        private void HandleRequest(byte[] request, Stream pipe)
+        {
+            var output = new FrameStream(pipe);
+
+            string error = null;
+            Command command = 0;
+            string path = null;
+            byte[] data = null;
+
+            try
+            {
+                using (var reader = new BinaryReader(new MemoryStream(request)))
+                {
+                    command = (Command)reader.ReadByte();
+                    path = reader.ReadString();
+                    var size = reader.ReadInt32();
+                    data = size > 0 ? reader.ReadBytes(size) : null;
+                }
+
+                if (command == Command.Extract)
+                {
+                    // Unique per request, clients may extract the same zone at the same time
+                    var outputPath = path + "." + Guid.NewGuid().ToString("N") + ".output";
+
+                    try
+                    {
+                        var files = FastFile.Decompress(path, outputPath, Store);
+
+                        using (var writer = new StreamWriter(output, new UTF8Encoding(false), 0x10000, true))
+                        {
+                            foreach (var file in files)
+                            {
+                                writer.WriteLine(file);
+                            }
+                        }
+                    }
+                    finally
+                    {
+                        File.Delete(outputPath);
+                    }
+                }
+                else if (command == Command.Decompile || command == Command.Disassemble)
+                {
+                    using (PipelineTrace.Begin("Server", command.ToString(), path))
+                    using (var reader = new BinaryReader(new MemoryStream(data ?? File.ReadAllBytes(path))))
+                    using (var script = ScriptBase.LoadScript(reader, HashTables))
+                    {
+                        script.Cache = Cache;
+
+                        using (var writer = new StreamWriter(output, new UTF8Encoding(false), 0x10000, true))
+                        {
+                            if (command == Command.Disassemble)
+                            {
+                                script.Disassemble(writer);
+                            }
+                            else
+                            {
+                                writer.Write(script.Decompile());
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    error = "Unknown command " + (int)command;
+                }
+            }
+            catch (Exception e) when (!(e is IOException) || ((PipeStream)pipe).IsConnected)
+            {
+                error = e.Message;
+            }
+
+            WriteResponse(output, pipe, error);
+        }
+
+        /// <summary>
+        /// Ends the output, then reports how it went, anything that failed mid
+        /// stream has already sent part of its output
+        /// </summary>
+        private static void WriteResponse(FrameStream output, Stream pipe, string error)
+        {
+            var header = new BinaryWriter(pipe, Encoding.UTF8, true);
+
+            output.Complete();
+
+            if (error == null)
+            {
+                WriteStatus(header, 0);
+            }
+            else
+            {
+                WriteStatus(header, 1);
+                var message = Encoding.UTF8.GetBytes(error);
+                output.Write(message, 0, message.Length);
+                output.Complete();
+            }
+        }
+
+        /// <summary>
+        /// Writes the status frame
+        /// </summary>
+        private static void WriteStatus(BinaryWriter writer, byte status)
+        {
+            writer.Write(1);
+            writer.Write(status);
+            writer.Flush();
+        }
+    }
+}
@@ -0,0 +1,348 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using Cerberus.Logic;
+
+namespace Cerberus.CLI
+{
+    /// <summary>
+    /// A class to watch a directory and reprocess only the scripts that changed
+    ///
+    /// Each file's size, write time and content hash are kept, events are debounced per file
+    /// and then checked against that state on a pool of workers, a changed write time with the
+    /// same content is not reprocessed. Our own output is never watched, even if it's written
+    /// inside the watched directory.
+    /// </summary>
+    class ScriptWatcher : IDisposable
+    {
+        /// <summary>
+        /// A class to hold the last processed state of a file
+        /// </summary>
+        class FileState
+        {
+            public long Size;
+            public DateTime LastWriteTime;
+            public string Hash;
+        }
+
+        /// <summary>
+        /// Markers in the names of files we write, e.g. script.gsc.decompiled.gsc
+        /// </summary>
+        static readonly string[] OutputMarkers =
+        {
+            ".decompiled.",
+            ".script_asm.",
+        };
+
+        /// <summary>
+        /// Gets the directory being watched
+        /// </summary>
+        public string Directory { get; private set; }
+
+        /// <summary>
+        /// Gets or Sets how long a file must go without events before it's processed
+        /// </summary>
+        public TimeSpan Debounce { get; set; } = TimeSpan.FromMilliseconds(250);
+
+        /// <summary>
+        /// Extensions of the files to watch
+        /// </summary>
+        private readonly string[] Extensions;
+
+        /// <summary>
+        /// Directory our output is written to, ignored even if it's inside the watched directory
+        /// </summary>
+        private readonly string OutputDirectory;
+
+        /// <summary>
+        /// Processes the script
+        /// </summary>
+        private readonly Action<string, byte[]> Process;
+
+        /// <summary>
+        /// Last processed state of each file
+        /// </summary>
+        private readonly Dictionary<string, FileState> States = new Dictionary<string, FileState>(StringComparer.OrdinalIgnoreCase);
+
+        /// <summary>
+        /// Files waiting for events to settle and when they last had one
+        /// </summary>
+        private readonly Dictionary<string, DateTime> Pending = new Dictionary<string, DateTime>(StringComparer.OrdinalIgnoreCase);
+
+        /// <summary>
+        /// Files queued or being processed, a file is only ever handled by one worker at a time
+        /// </summary>
+        private readonly HashSet<string> Busy = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+
+        /// <summary>
+        /// Files ready to be checked
+        /// </summary>
+        private readonly BlockingCollection<string> Queue = new BlockingCollection<string>();
+
+        /// <summary>
+        /// File System Watcher
+        /// </summary>
+        private readonly FileSystemWatcher Watcher;
+
+        /// <summary>
+        /// Signaled when the watcher should stop
+        /// </summary>
+        private readonly ManualResetEvent Stopping = new ManualResetEvent(false);
+
+        /// <summary>
+        /// Initializes an instance of the Script Watcher
+        /// </summary>
+        /// <param name="directory">Directory to watch, including sub directories</param>
+        /// <param name="extensions">Extensions of the files to watch</param>
+        /// <param name="outputDirectory">Directory the processed scripts are written to</param>
+        /// <param name="process">Processes the script</param>
+        public ScriptWatcher(string directory, string[] extensions, string outputDirectory, Action<string, byte[]> process)
+        {
+            Directory = Path.GetFullPath(directory);
+            Extensions = extensions;
+            OutputDirectory = Path.GetFullPath(outputDirectory).TrimEnd(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar) + Path.DirectorySeparatorChar;
+            Process = process;
+
+            Watcher = new FileSystemWatcher(Directory)
+            {
+                IncludeSubdirectories = true,
+                NotifyFilter = NotifyFilters.FileName | NotifyFilters.LastWrite | NotifyFilters.Size,
+                InternalBufferSize = 0x10000,
+            };
+
+            Watcher.Changed += (s, e) => MarkPending(e.FullPath);
+            Watcher.Created += (s, e) => MarkPending(e.FullPath);
+            Watcher.Renamed += (s, e) => MarkPending(e.FullPath);
+            Watcher.Deleted += (s, e) => Forget(e.FullPath);
+            // Events were dropped, the state table tells us what actually changed
+            Watcher.Error += (s, e) => Rescan();
+        }
+
+        /// <summary>
+        /// Processes every script once, then watches for changes, blocks until <see cref="Stop"/> is called
+        /// </summary>
+        public void Run(int workerCount)
+        {
+            for (int i = 0; i < workerCount; i++)
+            {
+                new Thread(Worker)
+                {
+                    Name = "Watch Worker " + i,
+                    IsBackground = true
+                }.Start();
+            }
+
+            Watcher.EnableRaisingEvents = true;
+            Rescan();
+
+            while (!Stopping.WaitOne(50))
+            {
+                Dispatch();
+            }
+        }
+
+        /// <summary>
+        /// Stops dispatching changes, <see cref="Run"/> returns once called
+        /// </summary>
+        public void Stop()
+        {
+            Stopping.Set();
+        }
+
+        /// <summary>
+        /// Marks every script in the directory as pending
+        /// </summary>
+        public void Rescan()
+        {
+            foreach (var file in System.IO.Directory.EnumerateFiles(Directory, "*.*", SearchOption.AllDirectories))
+            {
+                MarkPending(file);
+            }
+        }
+
+        /// <summary>
+        /// Checks if the file is a script we should watch rather than one of our outputs
+        /// </summary>
+        private bool IsWatched(string filePath)
+        {
+            if (!Extensions.Contains(Path.GetExtension(filePath).ToLower()))
+            {
+                return false;
+            }
+
+            if (Path.GetFullPath(filePath).StartsWith(OutputDirectory, StringComparison.OrdinalIgnoreCase))
+            {
+                return false;
+            }
+
+            var fileName = Path.GetFileName(filePath);
+
+            return !OutputMarkers.Any(x => fileName.IndexOf(x, StringComparison.OrdinalIgnoreCase) >= 0);
+        }
+
+        /// <summary>
+        /// Marks the file as pending if it's a script, restarting its debounce
+        /// </summary>
+        private void MarkPending(string filePath)
+        {
+            if (IsWatched(filePath))
+            {
+                lock (Pending)
+                {
+                    Pending[filePath] = DateTime.UtcNow;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Drops the state of a deleted file
+        /// </summary>
+        private void Forget(string filePath)
+        {
+            lock (States)
+            {
+                States.Remove(filePath);
+            }
+        }
+
+        /// <summary>
+        /// Queues pending files that have settled and aren't already being processed
+        /// </summary>
+        private void Dispatch()
+        {
+            var now = DateTime.UtcNow;
+            var ready = new List<string>();
+
+            lock (Pending)
+            {
+                lock (Busy)
+                {
+                    foreach (var pending in Pending)
+                    {
+                        // Files being processed stay pending until their worker is done
+                        if (now - pending.Value >= Debounce && Busy.Add(pending.Key))
+                        {
+                            ready.Add(pending.Key);
+                        }
+                    }
+                }
+
+                foreach (var filePath in ready)
+                {
+                    Pending.Remove(filePath);
+                }
+            }
+
+            foreach (var filePath in ready)
+            {
+                Queue.Add(filePath);
+            }
+        }
+
+        /// <summary>
+        /// Checks queued files
+        /// </summary>
+        private void Worker()
+        {
+            foreach (var filePath in Queue.GetConsumingEnumerable())
+            {
+                try
+                {
+                    Check(filePath);
+                }
+                catch (Exception e)
+                {
+                    Console.WriteLine(": An error has occured while processing {0}: {1}", Path.GetFileName(filePath), e.Message);
+                }
+                finally
+                {
+                    lock (Busy)
+                    {
+                        Busy.Remove(filePath);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Processes the file if it differs from its last processed state
+        /// </summary>
+        private void Check(string filePath)
+        {
+            var info = new FileInfo(filePath);
+
+            if (!info.Exists)
+            {
+                Forget(filePath);
+                return;
+            }
+
+            FileState state;
+
+            lock (States)
+            {
+                States.TryGetValue(filePath, out state);
+            }
+
+            if (state != null && state.Size == info.Length && state.LastWriteTime == info.LastWriteTimeUtc)
+            {
+                return;
+            }
+
+            byte[] buffer;
+
+            try
+            {
+                buffer = File.ReadAllBytes(filePath);
+            }
+            catch (IOException)
+            {
+                // Most likely still being written, try again once it settles
+                MarkPending(filePath);
+                return;
+            }
+
+            var hash = ScriptStore.ComputeHash(buffer);
+
+            // Touched or rewritten with the same content, keep the existing output
+            if (state != null && state.Hash == hash)
+            {
+                lock (States)
+                {
+                    state.Size = info.Length;
+                    state.LastWriteTime = info.LastWriteTimeUtc;
+                }
+
+                return;
+            }
+
+            Console.WriteLine(": Processing {0}...", Path.GetFileName(filePath));
+
+            Process(filePath, buffer);
+
+            lock (States)
+            {
+                States[filePath] = new FileState()
+                {
+                    Size = info.Length,
+                    LastWriteTime = info.LastWriteTimeUtc,
+                    Hash = hash,
+                };
+            }
+
+            Console.WriteLine(": Processed {0} successfully.", Path.GetFileName(filePath));
+        }
+
+        /// <summary>
+        /// Stops watching
+        /// </summary>
+        public void Dispose()
+        {
+            Watcher.Dispose();
+            Queue.CompleteAdding();
+        }
+    }
+}
@@ -0,0 +1,613 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Cerberus.Logic
+{
+    /// <summary>
+    /// A class to hold the Control Flow Graph of a function
+    ///
+    /// The graph is built in a single pass over the operations, jumps
+    /// are resolved once and we compute dominator and post-dominator trees
+    /// so the decompiler passes can query structure rather than rescanning
+    /// the function for every candidate block
+    /// </summary>
+    internal class ControlFlowGraph
+    {
+        /// <summary>
+        /// A class to hold a node (basic block) within the graph
+        /// </summary>
+        public class Node
+        {
+            /// <summary>
+            /// Index of this node within the graph
+            /// </summary>
+            public int Index { get; set; }
+
+            /// <summary>
+            /// Index of the first instruction in this node
+            /// </summary>
+            public int StartIndex { get; set; }
+
+            /// <summary>
+            /// Index of the last instruction in this node
+            /// </summary>
+            public int EndIndex { get; set; }
+
+            /// <summary>
+            /// Nodes that control can flow to from this node
+            /// </summary>
+            public List<Node> Successors = new List<Node>();
+
+            /// <summary>
+            /// Nodes that control can flow from to this node
+            /// </summary>
+            public List<Node> Predecessors = new List<Node>();
+
+            /// <summary>
+            /// Gets or Sets the immediate dominator, null for the entry or unreachable nodes
+            /// </summary>
+            public Node ImmediateDominator { get; set; }
+
+            /// <summary>
+            /// Gets or Sets the immediate post-dominator, null for the exit or nodes that never exit
+            /// </summary>
+            public Node ImmediatePostDominator { get; set; }
+
+            /// <summary>
+            /// Gets whether or not this is the virtual exit node
+            /// </summary>
+            public bool IsExit => StartIndex < 0;
+        }
+
+        /// <summary>
+        /// Gets the Function this graph was built from
+        /// </summary>
+        public ScriptExport Function { get; private set; }
+
+        /// <summary>
+        /// Gets the nodes of the graph in instruction order, the virtual exit node is last
+        /// </summary>
+        public List<Node> Nodes { get; private set; }
+
+        /// <summary>
+        /// Gets the entry node
+        /// </summary>
+        public Node Entry => Nodes[0];
+
+        /// <summary>
+        /// Gets the virtual exit node, all returns and fall throughs from the end flow here
+        /// </summary>
+        public Node Exit => Nodes[Nodes.Count - 1];
+
+        /// <summary>
+        /// Gets the indices of all unconditional jumps
+        /// </summary>
+        public List<int> Jumps { get; private set; } = new List<int>();
+
+        /// <summary>
+        /// Gets the indices of all conditional jumps (JumpOnTrue/JumpOnFalse)
+        /// </summary>
+        public List<int> ConditionalJumps { get; private set; } = new List<int>();
+
+        /// <summary>
+        /// Gets the indices of all switch operations
+        /// </summary>
+        public List<int> Switches { get; private set; } = new List<int>();
+
+        /// <summary>
+        /// Gets the indices of all dev block operations
+        /// </summary>
+        public List<int> DevBlocks { get; private set; } = new List<int>();
+
+        /// <summary>
+        /// Resolved jump location for each instruction, -1 if it isn't a jump
+        /// </summary>
+        private readonly int[] JumpLocations;
+
+        /// <summary>
+        /// Node index for each instruction
+        /// </summary>
+        private readonly int[] InstructionNodes;
+
+        /// <summary>
+        /// Jump sources by jump location
+        /// </summary>
+        private readonly Dictionary<int, List<int>> JumpSources = new Dictionary<int, List<int>>();
+
+        /// <summary>
+        /// Dominator tree pre/post order numbers, used for constant time dominance checks
+        /// </summary>
+        private int[] DominatorEnter, DominatorLeave;
+
+        /// <summary>
+        /// Post-dominator tree pre/post order numbers, used for constant time dominance checks
+        /// </summary>
+        private int[] PostDominatorEnter, PostDominatorLeave;
+
+        /// <summary>
+        /// Builds the Control Flow Graph for the given function
+        /// </summary>
+        /// <param name="function">Function to build the graph for</param>
+        /// <param name="script">Script the function belongs to, used to resolve jumps</param>
+        /// <param name="instructionIndices">Instruction indices by offset</param>
+        public ControlFlowGraph(ScriptExport function, ScriptBase script, Dictionary<int, int> instructionIndices)
+        {
+            Function = function;
+
+            var operations = function.Operations;
+            var leaders = new bool[operations.Count + 1];
+            JumpLocations = new int[operations.Count];
+            InstructionNodes = new int[operations.Count];
+
+            leaders[0] = true;
+
+            // Our single pass over the operations, resolve jumps, bucket the ops the
+            // decompiler passes care about, and mark where nodes begin
+            for (int i = 0; i < operations.Count; i++)
+            {
+                var op = operations[i];
+
+                JumpLocations[i] = -1;
+
+                switch (op.Metadata.OpType)
+                {
+                    case ScriptOpType.Jump:
+                    case ScriptOpType.JumpCondition:
+                    case ScriptOpType.JumpExpression:
+                    case ScriptOpType.Switch:
+                        {
+                            if (op.Metadata.OpType == ScriptOpType.Jump)
+                                Jumps.Add(i);
+                            else if (op.Metadata.OpType == ScriptOpType.JumpCondition)
+                                ConditionalJumps.Add(i);
+                            else if (op.Metadata.OpType == ScriptOpType.Switch)
+                                Switches.Add(i);
+
+                            AddJump(i, script.GetJumpLocation(op.OpCodeOffset + op.OpCodeSize, op.Operands[0].IntValue), instructionIndices, leaders);
+                            break;
+                        }
+                    case ScriptOpType.SwitchCases:
+                        {
+                            foreach (var operand in op.Operands)
+                            {
+                                if (operand.SwitchCase is ScriptOpSwitch switchCase && instructionIndices.TryGetValue(switchCase.ByteCodeOffset, out var caseIndex))
+                                {
+                                    leaders[caseIndex] = true;
+                                }
+                            }
+
+                            leaders[i + 1] = true;
+                            break;
+                        }
+                    case ScriptOpType.Return:
+                        {
+                            leaders[i + 1] = true;
+                            break;
+                        }
+                    default:
+                        {
+                            if (op.Metadata.OpCode == ScriptOpCode.DevblockBegin)
+                            {
+                                DevBlocks.Add(i);
+                                AddJump(i, script.GetJumpLocation(op.OpCodeOffset + op.OpCodeSize, op.Operands[0].IntValue), instructionIndices, leaders);
+                            }
+                            break;
+                        }
+                }
+            }
+
+            Nodes = new List<Node>();
+
+            for (int i = 0; i < operations.Count; i++)
+            {
+                if (leaders[i])
+                {
+                    if (Nodes.Count > 0)
+                        Nodes[Nodes.Count - 1].EndIndex = i - 1;
+
+                    Nodes.Add(new Node() { Index = Nodes.Count, StartIndex = i });
+                }
+
+                InstructionNodes[i] = Nodes.Count - 1;
+            }
+
+            if (Nodes.Count > 0)
+                Nodes[Nodes.Count - 1].EndIndex = operations.Count - 1;
+
+            Nodes.Add(new Node() { Index = Nodes.Count, StartIndex = -1, EndIndex = -1 });
+
+            BuildEdges(instructionIndices);
+            ComputeDominators();
+            ComputePostDominators();
+        }
+
+        /// <summary>
+        /// Records a jump and marks the nodes it creates
+        /// </summary>
+        private void AddJump(int index, int jumpLocation, Dictionary<int, int> instructionIndices, bool[] leaders)
+        {
+            JumpLocations[index] = jumpLocation;
+
+            if (!JumpSources.TryGetValue(jumpLocation, out var sources))
+            {
+                sources = new List<int>();
+                JumpSources[jumpLocation] = sources;
+            }
+
+            sources.Add(index);
+
+            if (TryGetInstruction(jumpLocation, instructionIndices, out var targetIndex))
+            {
+                leaders[targetIndex] = true;
+            }
+
+            leaders[index + 1] = true;
+        }
+
+        /// <summary>
+        /// Links the nodes based off the last operation within each node
+        /// </summary>
+        private void BuildEdges(Dictionary<int, int> instructionIndices)
+        {
+            var operations = Function.Operations;
+
+            for (int i = 0; i < Nodes.Count - 1; i++)
+            {
+                var node = Nodes[i];
+                var last = operations[node.EndIndex];
+                var fallsThrough = true;
+
+                switch (last.Metadata.OpType)
+                {
+                    case ScriptOpType.Return:
+                        {
+                            fallsThrough = false;
+                            break;
+                        }
+                    case ScriptOpType.Jump:
+                    case ScriptOpType.Switch:
+                        {
+                            fallsThrough = false;
+                            LinkOffset(node, JumpLocations[node.EndIndex], instructionIndices);
+                            break;
+                        }
+                    case ScriptOpType.SwitchCases:
+                        {
+                            foreach (var operand in last.Operands)
+                            {
+                                if (operand.SwitchCase is ScriptOpSwitch switchCase)
+                                {
+                                    LinkOffset(node, switchCase.ByteCodeOffset, instructionIndices);
+                                }
+                            }
+                            break;
+                        }
+                    default:
+                        {
+                            if (JumpLocations[node.EndIndex] != -1)
+                            {
+                                LinkOffset(node, JumpLocations[node.EndIndex], instructionIndices);
+                            }
+                            break;
+                        }
+                }
+
+                if (fallsThrough)
+                {
+                    Link(node, Nodes[i + 1]);
+                }
+                else if (last.Metadata.OpType == ScriptOpType.Return)
+                {
+                    Link(node, Exit);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Links the node to the node at the given offset, or to the exit if it leaves the function
+        /// </summary>
+        private void LinkOffset(Node node, int offset, Dictionary<int, int> instructionIndices)
+        {
+            Link(node, TryGetInstruction(offset, instructionIndices, out var index) ? Nodes[InstructionNodes[index]] : Exit);
+        }
+
+        /// <summary>
+        /// Gets the index of the instruction at the given offset
+        ///
+        /// Switches jump to the case table of their EndSwitch, which is aligned
+        /// past the op code, so we also accept the EndSwitch just before it
+        /// </summary>
+        private bool TryGetInstruction(int offset, Dictionary<int, int> instructionIndices, out int index)
+        {
+            if (instructionIndices.TryGetValue(offset, out index))
+                return true;
+
+            for (int i = 1; i <= 4; i++)
+            {
+                if (instructionIndices.TryGetValue(offset - i, out index) && Function.Operations[index].Metadata.OpType == ScriptOpType.SwitchCases)
+                    return true;
+            }
+
+            return false;
+        }
+
+        /// <summary>
+        /// Links the two nodes
+        /// </summary>
+        private static void Link(Node from, Node to)
+        {
+            if (!from.Successors.Contains(to))
+            {
+                from.Successors.Add(to);
+                to.Predecessors.Add(from);
+            }
+        }
+
+        /// <summary>
+        /// Computes the dominator tree
+        /// </summary>
+        private void ComputeDominators()
+        {
+            var idoms = ComputeImmediateDominators(Entry.Index, x => Nodes[x].Successors, x => Nodes[x].Predecessors);
+
+            foreach (var node in Nodes)
+                node.ImmediateDominator = idoms[node.Index] >= 0 && idoms[node.Index] != node.Index ? Nodes[idoms[node.Index]] : null;
+
+            NumberTree(idoms, out DominatorEnter, out DominatorLeave);
+        }
+
+        /// <summary>
+        /// Computes the post-dominator tree (dominators of the reversed graph from the exit)
+        /// </summary>
+        private void ComputePostDominators()
+        {
+            var idoms = ComputeImmediateDominators(Exit.Index, x => Nodes[x].Predecessors, x => Nodes[x].Successors);
+
+            foreach (var node in Nodes)
+                node.ImmediatePostDominator = idoms[node.Index] >= 0 && idoms[node.Index] != node.Index ? Nodes[idoms[node.Index]] : null;
+
+            NumberTree(idoms, out PostDominatorEnter, out PostDominatorLeave);
+        }
+
+        /// <summary>
+        /// Computes immediate dominators using Cooper, Harvey and Kennedy's iterative algorithm
+        /// </summary>
+        /// <param name="root">Index of the root node</param>
+        /// <param name="successors">Successors in the direction we're walking</param>
+        /// <param name="predecessors">Predecessors in the direction we're walking</param>
+        /// <returns>Immediate dominator index per node, roots are their own</returns>
+        private int[] ComputeImmediateDominators(int root, Func<int, List<Node>> successors, Func<int, List<Node>> predecessors)
+        {
+            var count = Nodes.Count;
+            var postOrder = new int[count];
+            var order = new List<int>(count);
+            var visited = new bool[count];
+            var stack = new Stack<KeyValuePair<int, int>>();
+
+            for (int i = 0; i < count; i++)
+                postOrder[i] = -1;
+
+            // Code after a for(;;) or return can't be reached from the root, each run
+            // of it gets walked from its first node (moving away from the root) so
+            // it still has a tree of its own rather than no dominators at all
+            var step = root == 0 ? 1 : -1;
+            var tree = new int[count];
+            var roots = new List<int>();
+
+            for (int i = root; i >= 0 && i < count; i += step)
+            {
+                if (visited[i])
+                    continue;
+
+                roots.Add(i);
+
+                // Iterative DFS, functions can be large enough to blow the stack if done recursively
+                stack.Push(new KeyValuePair<int, int>(i, 0));
+                visited[i] = true;
+                tree[i] = i;
+
+                while (stack.Count > 0)
+                {
+                    var current = stack.Pop();
+                    var next = successors(current.Key);
+
+                    if (current.Value < next.Count)
+                    {
+                        stack.Push(new KeyValuePair<int, int>(current.Key, current.Value + 1));
+
+                        var child = next[current.Value].Index;
+
+                        if (!visited[child])
+                        {
+                            visited[child] = true;
+                            tree[child] = i;
+                            stack.Push(new KeyValuePair<int, int>(child, 0));
+                        }
+                    }
+                    else
+                    {
+                        postOrder[current.Key] = order.Count;
+                        order.Add(current.Key);
+                    }
+                }
+            }
+
+            var idoms = new int[count];
+
+            for (int i = 0; i < count; i++)
+                idoms[i] = -1;
+
+            foreach (var treeRoot in roots)
+                idoms[treeRoot] = treeRoot;
+
+            var changed = true;
+
+            while (changed)
+            {
+                changed = false;
+
+                // Reverse post order, skipping the roots
+                for (int i = order.Count - 1; i >= 0; i--)
+                {
+                    var node = order[i];
+                    var newIdom = -1;
+
+                    if (tree[node] == node)
+                        continue;
+
+                    foreach (var pred in predecessors(node))
+                    {
+                        // Edges in from another tree (dead code running into live code) don't count
+                        if (idoms[pred.Index] == -1 || tree[pred.Index] != tree[node])
+                            continue;
+
+                        newIdom = newIdom == -1 ? pred.Index : Intersect(pred.Index, newIdom, idoms, postOrder);
+                    }
+
+                    if (newIdom != -1 && idoms[node] != newIdom)
+                    {
+                        idoms[node] = newIdom;
+                        changed = true;
+                    }
+                }
+            }
+
+            return idoms;
+        }
+
+        /// <summary>
+        /// Walks both nodes up the tree until they meet
+        /// </summary>
+        private static int Intersect(int a, int b, int[] idoms, int[] postOrder)
+        {
+            while (a != b)
+            {
+                while (postOrder[a] < postOrder[b])
+                    a = idoms[a];
+                while (postOrder[b] < postOrder[a])
+                    b = idoms[b];
+            }
+
+            return a;
+        }
+
+        /// <summary>
+        /// Assigns enter/leave numbers to each node of the trees so ancestry checks are constant time
+        /// </summary>
+        private void NumberTree(int[] idoms, out int[] enter, out int[] leave)
+        {
+            var count = Nodes.Count;
+            var children = new List<int>[count];
+            enter = new int[count];
+            leave = new int[count];
+
+            for (int i = 0; i < count; i++)
+            {
+                enter[i] = -1;
+                leave[i] = -1;
+
+                if (idoms[i] >= 0 && idoms[i] != i)
+                {
+                    if (children[idoms[i]] == null)
+                        children[idoms[i]] = new List<int>();
+
+                    children[idoms[i]].Add(i);
+                }
+            }
+
+            var counter = 0;
+            var stack = new Stack<KeyValuePair<int, int>>();
+
+            for (int root = 0; root < count; root++)
+            {
+                if (idoms[root] != root)
+                    continue;
+
+                stack.Push(new KeyValuePair<int, int>(root, 0));
+                enter[root] = counter++;
+
+                while (stack.Count > 0)
+                {
+                    var current = stack.Pop();
+                    var next = children[current.Key];
+
+                    if (next != null && current.Value < next.Count)
+                    {
+                        stack.Push(new KeyValuePair<int, int>(current.Key, current.Value + 1));
+                        enter[next[current.Value]] = counter++;
+                        stack.Push(new KeyValuePair<int, int>(next[current.Value], 0));
+                    }
+                    else
+                    {
+                        leave[current.Key] = counter++;
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the resolved jump location of the instruction, -1 if it isn't a jump
+        /// </summary>
+        public int GetJumpLocation(int instructionIndex) => JumpLocations[instructionIndex];
+
+        /// <summary>
+        /// Gets the indices of the instructions that jump to the given offset
+        /// </summary>
+        public IReadOnlyList<int> GetJumpSources(int offset)
+        {
+            return JumpSources.TryGetValue(offset, out var sources) ? (IReadOnlyList<int>)sources : Array.Empty<int>();
+        }
+
+        /// <summary>
+        /// Gets the node the instruction belongs to
+        /// </summary>
+        public Node GetNode(int instructionIndex) => Nodes[InstructionNodes[instructionIndex]];
+
+        /// <summary>
+        /// Checks if node a dominates node b (every path from the entry to b goes through a)
+        /// </summary>
+        public bool Dominates(Node a, Node b)
+        {
+            return DominatorEnter[a.Index] >= 0 && DominatorEnter[b.Index] >= 0 &&
+                DominatorEnter[a.Index] <= DominatorEnter[b.Index] &&
+                DominatorLeave[b.Index] <= DominatorLeave[a.Index];
+        }
+
+        /// <summary>
+        /// Checks if node a post-dominates node b (every path from b to the exit goes through a)
+        /// </summary>
+        public bool PostDominates(Node a, Node b)
+        {
+            return PostDominatorEnter[a.Index] >= 0 && PostDominatorEnter[b.Index] >= 0 &&
+                PostDominatorEnter[a.Index] <= PostDominatorEnter[b.Index] &&
+                PostDominatorLeave[b.Index] <= PostDominatorLeave[a.Index];
+        }
+
+        /// <summary>
+        /// Checks if the instruction at the given index is a back edge, i.e. a jump
+        /// to a loop header that dominates it
+        /// </summary>
+        public bool IsBackEdge(int instructionIndex)
+        {
+            var jumpLocation = JumpLocations[instructionIndex];
+
+            if (jumpLocation == -1 || jumpLocation > Function.Operations[instructionIndex].OpCodeOffset)
+                return false;
+
+            var source = GetNode(instructionIndex);
+
+            foreach (var target in source.Successors)
+            {
+                if (!target.IsExit && Function.Operations[target.StartIndex].OpCodeOffset == jumpLocation)
+                {
+                    return Dominates(target, source);
+                }
+            }
+
+            return false;
+        }
+    }
+}
@@ -100,15 +100,56 @@ namespace Cerberus.Logic
         /// </summary>
         private List<DecompilerBlock> Blocks = new List<DecompilerBlock>();
 
+        /// <summary>
+        /// Instruction indices by Op Code offset
+        /// </summary>
+        private readonly Dictionary<int, int> InstructionIndices = new Dictionary<int, int>();
+
+        /// <summary>
+        /// First block index by block start offset, kept in sync with <see cref="Blocks"/>
+        /// </summary>
+        private readonly Dictionary<int, int> BlockIndices = new Dictionary<int, int>();
+
+        /// <summary>
+        /// Loops by header offset, used to tell a loop's own back edge from a continue
+        /// </summary>
+        private readonly Dictionary<int, DecompilerBlock> LoopHeaders = new Dictionary<int, DecompilerBlock>();
+
+        /// <summary>
+        /// Control Flow Graph of the function, built once and shared by the passes
+        /// </summary>
+        private ControlFlowGraph Graph { get; set; }
+
         /// <summary>
         /// List of local variable names
         /// </summary>
         private readonly List<string> LocalVariables = new List<string>();
 
         /// <summary>
-        /// The virtual script stack
+        /// The virtual script stack, holds expression nodes
+        /// </summary>
+        private readonly Stack<int> Stack = new Stack<int>();
+
+        /// <summary>
+        /// Expressions of the function, only rendered to text once they're written
         /// </summary>
-        private readonly Stack<string> Stack = new Stack<string>();
+        private ExpressionArena Expressions { get; set; }
+
+        /// <summary>
+        /// Call arguments, reused between calls
+        /// </summary>
+        private readonly List<int> CallArguments = new List<int>();
+
+        /// <summary>
+        /// Output buffer for the current thread, reused between functions
+        /// </summary>
+        [ThreadStatic]
+        private static StringBuilder PooledOutput;
+
+        /// <summary>
+        /// Output buffer
+        /// </summary>
+        private StringBuilder Output { get; set; }
 
         /// <summary>
         /// Current Variable Reference
@@ -137,19 +178,29 @@ namespace Cerberus.Logic
         /// <param name="script"></param>
         public Decompiler(ScriptExport function, ScriptBase script)
         {
+            Expressions = ExpressionArena.Rent();
+            Output = PooledOutput ?? new StringBuilder();
+            PooledOutput = null;
+            Output.Clear();
+
             try
             {
                 Function = function;
                 Script = script;
 
                 // Preprocess some operations
-                foreach (var operation in Function.Operations)
+                for (int i = 0; i < Function.Operations.Count; i++)
                 {
+                    var operation = Function.Operations[i];
+
+                    // Build our offset lookup, the passes below query it heavily
+                    InstructionIndices[operation.OpCodeOffset] = i;
+
                     if (operation.Metadata.OpCode == ScriptOpCode.SafeCreateLocalVariables)
                     {
                         foreach (var var in operation.Operands)
                         {
-                            LocalVariables.Add((string)var.Value);
+                            LocalVariables.Add(var.ToString());
                         }
 
                         operation.Visited = true;
@@ -168,8 +219,15 @@ namespace Cerberus.Logic
                     Function.Operations[Function.Operations.Count - 1].Visited = true;
                 }
 
+                // Build the graph in one pass, the passes below query it
+                // rather than rescanning the operations
+                using (PipelineTrace.Begin("Decompiler", "BuildGraph", function.Name))
+                {
+                    Graph = new ControlFlowGraph(Function, Script, InstructionIndices);
+                }
+
                 // Add the root of this function, the main block of execution
-                Blocks.Add(new BasicBlock(function.ByteCodeOffset, function.ByteCodeOffset + function.ByteCodeSize + 1));
+                AddBlock(new BasicBlock(function.ByteCodeOffset, function.ByteCodeOffset + function.ByteCodeSize + 1));
 
                 // This performs several passes over the operations
                 // we detect the most basic and easy to find first
@@ -182,32 +240,44 @@ namespace Cerberus.Logic
                 // and therefore it's NOT a for loop
                 // but we need to resolve for loops before them
                 // so this is the best way to ensure that
-                FindSwitchCase();
-                FindDevBlocks();
-                FindWhileLoops();
-                FindDoWhileLoops();
-                FindIfStatements();
-                FindJumpBlocks();
-                // FindForEachLoops();
-                // FindForLoops();
-                // Now that we've done what need to do we can remove jump blocks
-                // to process them properly
-                Blocks.RemoveAll(x => x is BasicBlock && x.StartOffset != Function.ByteCodeOffset);
-                FindElseIfStatements();
-                ResolveParentBlocks();
-                Stack.Clear();
-                RestoreCaseOrder();
-
-                InternalWriter = new StringWriter();
+                using (PipelineTrace.Begin("Decompiler", "FindBlocks", function.Name))
+                {
+                    FindSwitchCase();
+                    FindDevBlocks();
+                    FindWhileLoops();
+                    FindDoWhileLoops();
+                    FindIfStatements();
+                    FindJumpBlocks();
+                    // FindForEachLoops();
+                    // FindForLoops();
+                    // Now that we've done what need to do we can remove jump blocks
+                    // to process them properly
+                    Blocks.RemoveAll(x => x is BasicBlock && x.StartOffset != Function.ByteCodeOffset);
+                    RebuildBlockIndices();
+                }
+
+                using (PipelineTrace.Begin("Decompiler", "ResolveBlocks", function.Name))
+                {
+                    FindElseIfStatements();
+                    ResolveParentBlocks();
+                    Stack.Clear();
+                    RestoreCaseOrder();
+                }
+
+                InternalWriter = new StringWriter(Output);
                 Writer = new IndentedTextWriter(InternalWriter, "\t");
 
-                Writer.WriteLine(BuildFunctionDefinition());
-                DecompileBlock(Blocks[0], 1);
+                using (PipelineTrace.Begin("Decompiler", "WriteBlocks", function.Name))
+                {
+                    WriteFunctionDefinition();
+                    DecompileBlock(Blocks[0], 1);
+                }
             }
             catch(Exception e)
             {
                 InternalWriter?.Dispose();
-                InternalWriter = new StringWriter();
+                Output.Clear();
+                InternalWriter = new StringWriter(Output);
                 Writer?.Dispose();
                 Writer = new IndentedTextWriter(InternalWriter, "\t");
                 Writer.WriteLine("function {0}()", Function.Name);
@@ -226,31 +296,56 @@ namespace Cerberus.Logic
         }
 
         /// <summary>
-        /// Builds the function definition
+        /// Writes the function definition
         /// </summary>
-        private string BuildFunctionDefinition()
+        private void WriteFunctionDefinition()
         {
-            var result = "function ";
+            Writer.Write("function ");
 
             // Flags, currently only 2 are known (Private/Autoexec)
             if(Function.Flags.HasFlag(ScriptExportFlags.Private))
             {
-                result += "private ";
+                Writer.Write("private ");
             }
             if (Function.Flags.HasFlag(ScriptExportFlags.AutoExec))
             {
-                result += "autoexec ";
+                Writer.Write("autoexec ");
             }
 
-            result += Function.Name + "(";
+            Writer.Write(Function.Name);
+            Writer.Write("(");
 
             // Build paramters (TODO: Some checks for default args, it'll be an isdefined check after the call)
             for (int i = 0; i < Function.ParameterCount; i++)
             {
-                result += string.Format("{0}{1}", LocalVariables[i], i == Function.ParameterCount - 1 ? "" : ", ");
+                Writer.Write(LocalVariables[i]);
+
+                if (i != Function.ParameterCount - 1)
+                {
+                    Writer.Write(", ");
+                }
             }
 
-            return result + ")";
+            Writer.WriteLine(")");
+        }
+
+        /// <summary>
+        /// Pops an expression off the stack as a string, for values stored outside the tree
+        /// </summary>
+        private string PopString()
+        {
+            return Expressions.Render(Stack.Pop());
+        }
+
+        /// <summary>
+        /// Writes the expression directly to the writer, if we have one
+        /// </summary>
+        private void Write(int expression)
+        {
+            if (Writer != null)
+            {
+                Expressions.Render(expression, Writer);
+            }
         }
 
         /// <summary>
@@ -284,20 +379,20 @@ namespace Cerberus.Logic
 
         private void FindJumpBlocks()
         {
-            foreach(var instruction in Function.Operations)
+            foreach(var index in Graph.Jumps)
             {
+                var instruction = Function.Operations[index];
+
                 if(instruction.Metadata.OpCode == ScriptOpCode.Jump && instruction.Visited == false)
                 {
                     // Check positive jump
-                    if((int)instruction.Operands[0].Value > 0)
+                    if(instruction.Operands[0].IntValue > 0)
                     {
 
                         // Add it as a basic block
-                        Blocks.Add(new BasicBlock(
+                        AddBlock(new BasicBlock(
                             instruction.OpCodeOffset + instruction.OpCodeSize,
-                            Script.GetJumpLocation(
-                                instruction.OpCodeOffset + instruction.OpCodeSize,
-                                (int)instruction.Operands[0].Value)));
+                            Graph.GetJumpLocation(index)));
                     }
                 }
             }
@@ -305,19 +400,19 @@ namespace Cerberus.Logic
 
         private void FindIfStatements()
         {
-            for (int i = 0; i < Function.Operations.Count; i++)
+            foreach (var i in Graph.ConditionalJumps)
             {
                 var op = Function.Operations[i];
 
                 if (op.Metadata.OpType == ScriptOpType.JumpCondition)
                 {
-                    if (!op.Visited && (int)op.Operands[0].Value > 0)
+                    if (!op.Visited && op.Operands[0].IntValue > 0)
                     {
                         op.Visited = true;
 
                         var startIndex = FindStartIndexEx(i - 1);
 
-                        Blocks.Add(new IfBlock(Function.Operations[startIndex].OpCodeOffset, Script.GetJumpLocation(op.OpCodeOffset + op.OpCodeSize, (int)op.Operands[0].Value))
+                        AddBlock(new IfBlock(Function.Operations[startIndex].OpCodeOffset, Graph.GetJumpLocation(i))
                         {
                             Comparison = BuildCondition(startIndex)
                         });
@@ -352,21 +447,14 @@ namespace Cerberus.Logic
 
         private bool LoopHasReferences(WhileLoop loop)
         {
-            foreach(var op in Function.Operations)
+            // Only the jumps that actually land on the continue location matter
+            foreach(var index in Graph.GetJumpSources(loop.ContinueOffset))
             {
-                if(!op.Visited)
-                {
-                    if(op.Metadata.OpCode == ScriptOpCode.Jump)
-                    {
-                        var jumpLocation = Script.GetJumpLocation(
-                                op.OpCodeOffset + op.OpCodeSize,
-                                (int)op.Operands[0].Value);
+                var op = Function.Operations[index];
 
-                        if(jumpLocation == loop.ContinueOffset)
-                        {
-                            return true;
-                        }
-                    }
+                if(!op.Visited && op.Metadata.OpCode == ScriptOpCode.Jump)
+                {
+                    return true;
                 }
             }
 
@@ -394,13 +482,16 @@ namespace Cerberus.Logic
                         var blockIndex = GetBlockIndexAt(Blocks[i].EndOffset);
                         var jumpLocation = Script.GetJumpLocation(
                                 op.OpCodeOffset + op.OpCodeSize,
-                                (int)op.Operands[0].Value);
+                                op.Operands[0].IntValue);
 
-                        if (!IsContinue(op.OpCodeOffset, jumpLocation) && !IsBreak(op.OpCodeOffset, jumpLocation))
+                        // Breaks and jumps back to a loop (continues or the back edge of a loop the if
+                        // ends with) aren't its end, a forward jump to the continue location is the same
+                        // as an else that runs to it
+                        if (jumpLocation > op.OpCodeOffset && !IsBreak(op.OpCodeOffset, jumpLocation))
                         {
                             Function.Operations[index - 1].Visited = true;
 
-                            if (blockIndex > 0 && Blocks[blockIndex] is IfBlock elseIf && jumpLocation != Blocks[i].EndOffset)
+                            if (blockIndex > 0 && Blocks[blockIndex] is IfBlock elseIf && jumpLocation != Blocks[i].EndOffset && IsElseIfChain(elseIf, jumpLocation))
                             {
                                 // Mark this block
                                 Blocks[blockIndex] = new ElseIfBlock(elseIf.StartOffset, elseIf.EndOffset)
@@ -411,11 +502,11 @@ namespace Cerberus.Logic
                             else
                             {
                                 // Mark this block
-                                Blocks.Add(new ElseBlock(
+                                AddBlock(new ElseBlock(
                                     op.OpCodeOffset + op.OpCodeSize,
                                 Script.GetJumpLocation(
                                     op.OpCodeOffset + op.OpCodeSize,
-                                    (int)op.Operands[0].Value)));
+                                    op.Operands[0].IntValue)));
                             }
                         }
                     }
@@ -431,18 +522,23 @@ namespace Cerberus.Logic
         /// </summary>
         private void FindDoWhileLoops()
         {
-            for(int i = 0; i < Function.Operations.Count; i++)
+            foreach(var i in Graph.ConditionalJumps)
             {
                 var op = Function.Operations[i];
 
                 if (op.Metadata.OpType == ScriptOpType.JumpCondition)
                 {
-                    if(!op.Visited && (int)op.Operands[0].Value < 0)
+                    if(!op.Visited && op.Operands[0].IntValue < 0)
                     {
                         op.Visited = true;
-                        Blocks.Add(new DoWhileLoop(Script.GetJumpLocation(op.OpCodeOffset + op.OpCodeSize, (int)op.Operands[0].Value), op.OpCodeOffset)
+
+                        var startIndex = FindStartIndexEx(i - 1);
+
+                        AddBlock(new DoWhileLoop(Graph.GetJumpLocation(i), op.OpCodeOffset)
                         {
-                            Comparison = BuildCondition(FindStartIndexEx(i - 1))
+                            ContinueOffset = Function.Operations[startIndex].OpCodeOffset,
+                            BreakOffset = op.OpCodeOffset + op.OpCodeSize,
+                            Comparison = BuildCondition(startIndex)
                         });
                     }
                 }
@@ -450,16 +546,16 @@ namespace Cerberus.Logic
         }
         private void FindSwitchCase()
         {
-            foreach (var operation in Function.Operations)
+            foreach (var index in Graph.Switches)
             {
+                var operation = Function.Operations[index];
+
                 if (operation.Metadata.OpCode == ScriptOpCode.Switch)
                 {
                     var switchBlock = new SwitchBlock(
                         operation.OpCodeOffset, 
-                        Script.GetJumpLocation(
-                            operation.OpCodeOffset + operation.OpCodeSize, 
-                            (int)operation.Operands[0].Value));
-                    Blocks.Add(switchBlock);
+                        Graph.GetJumpLocation(index));
+                    AddBlock(switchBlock);
 
                     Script.Reader.BaseStream.Position = switchBlock.EndOffset;
                     var cases = Script.LoadEndSwitch();
@@ -484,21 +580,49 @@ namespace Cerberus.Logic
                             caseBlock.EndOffset = cases[i + 1].ByteCodeOffset;
                         }
 
-                        Blocks.Add(caseBlock);
+                        AddBlock(caseBlock);
                     }
 
                     switchBlock.BreakOffset = switchBlock.EndOffset + (cases.Count * 8) + 4;
+
+                    // The last case ends with a jump over the case table, it's how the
+                    // switch is laid out rather than a break within the script
+                    for (int j = index + 1; j < Function.Operations.Count; j++)
+                    {
+                        var endSwitch = Function.Operations[j];
+
+                        if (endSwitch.Metadata.OpCode == ScriptOpCode.EndSwitch && endSwitch.OpCodeOffset <= switchBlock.EndOffset && endSwitch.OpCodeOffset + 4 >= switchBlock.EndOffset)
+                        {
+                            if (Function.Operations[j - 1].Metadata.OpCode == ScriptOpCode.Jump && Graph.GetJumpLocation(j - 1) == switchBlock.BreakOffset)
+                            {
+                                Function.Operations[j - 1].Visited = true;
+                            }
+
+                            break;
+                        }
+                    }
                 }
             }
         }
 
         private void ResolveParentBlocks()
         {
-            // Sort it
-            Blocks = Blocks.OrderBy(x => x.StartOffset).ToList();
+            // Sort it, blocks that share a start go outermost first so the
+            // reverse scan below finds the innermost parent
+            Blocks = Blocks.OrderBy(x => x.StartOffset).ThenByDescending(x => x.EndOffset).ThenByDescending(x => CanStartWithBlock(x)).ToList();
+            RebuildBlockIndices();
 
             for(int i = Blocks.Count - 1; i >= 0; i--)
             {
+                // Blocks that start with another block share its start offset
+                var parent = GetSameStartParent(i);
+
+                if (parent != -1)
+                {
+                    Blocks[parent].ChildBlockIndices.Add(i);
+                    continue;
+                }
+
                 for(int j = Blocks.Count - 1; j >= 0; j--)
                 {
                     if (Blocks[j] is CaseBlock && !(Blocks[i] is SwitchBlock) && !(Blocks[i] is CaseBlock))
@@ -525,40 +649,94 @@ namespace Cerberus.Logic
             }
         }
 
+        /// <summary>
+        /// Checks if the block can start with another block, i.e. its header isn't code
+        /// </summary>
+        private static bool CanStartWithBlock(DecompilerBlock block)
+        {
+            return block is ForEver || block is DoWhileLoop || block is ElseBlock;
+        }
+
+        /// <summary>
+        /// Gets the innermost block that starts at the same offset as the block and contains it,
+        /// such as a for(;;) or else that starts with an if
+        /// </summary>
+        private int GetSameStartParent(int index)
+        {
+            var block = Blocks[index];
+            var result = -1;
+
+            if (block is CaseBlock)
+            {
+                return -1;
+            }
+
+            for (int j = 0; j < Blocks.Count && Blocks[j].StartOffset <= block.StartOffset; j++)
+            {
+                var candidate = Blocks[j];
+
+                if (j == index || candidate.StartOffset != block.StartOffset || !CanStartWithBlock(candidate))
+                {
+                    continue;
+                }
+
+                // If they're both able to hold the other, the larger one is the parent
+                if (CanStartWithBlock(block) ? block.EndOffset >= candidate.EndOffset : block.EndOffset > candidate.EndOffset)
+                {
+                    continue;
+                }
+
+                if (result == -1 || candidate.EndOffset < Blocks[result].EndOffset)
+                {
+                    result = j;
+                }
+            }
+
+            return result;
+        }
+
         /// <summary>
         /// Generates a source function call (i.e. Func(p1, p2, p3))
         /// 
         /// Method means we're calling on something
         /// </summary>
-        private string GenerateFunctionCall(string functionName, int paramCount, bool threaded, bool method)
+        private int GenerateFunctionCall(int functionName, int paramCount, bool threaded, bool method)
         {
-            string result = "";
+            // Pop everything first, we can't create nodes while building this one
+            var target = method ? Stack.Pop() : -1;
+
+            CallArguments.Clear();
+
+            for(int i = 0; i < paramCount; i++)
+            {
+                CallArguments.Add(Stack.Pop());
+            }
+
+            Expressions.Begin();
 
             if(method)
             {
-                result += Stack.Pop() + " ";
+                Expressions.Append(target).Append(" ");
             }
 
             if(threaded)
             {
-                result += "thread ";
+                Expressions.Append("thread ");
             }
 
-            result += functionName + "(";
+            Expressions.Append(functionName).Append("(");
 
-            for(int i = 0; i < paramCount; i++)
+            for(int i = 0; i < CallArguments.Count; i++)
             {
-                result += Stack.Pop();
+                Expressions.Append(CallArguments[i]);
 
-                if(i != paramCount - 1)
+                if(i != CallArguments.Count - 1)
                 {
-                    result += ", ";
+                    Expressions.Append(", ");
                 }
             }
 
-            result += ")";
-
-            return result;
+            return Expressions.Append(")").End();
         }
 
         private void WriteHeader(DecompilerBlock block)
@@ -601,27 +779,103 @@ namespace Cerberus.Logic
             }
         }
 
+        /// <summary>
+        /// Gets the innermost loop, or switch if loops only is false, the instruction is inside of
+        /// </summary>
+        private DecompilerBlock GetEnclosingBlock(int ip, bool loopsOnly)
+        {
+            DecompilerBlock result = null;
+
+            foreach(var block in Blocks)
+            {
+                if (block.BreakOffset == -1 || (loopsOnly && block.ContinueOffset == -1))
+                {
+                    continue;
+                }
+
+                if (ip < block.StartOffset || ip >= block.EndOffset)
+                {
+                    continue;
+                }
+
+                // Blocks that start together, such as a do {} starting with a for(;;), nest by their ends
+                if (result == null || block.StartOffset > result.StartOffset || (block.StartOffset == result.StartOffset && block.EndOffset < result.EndOffset))
+                {
+                    result = block;
+                }
+            }
+
+            return result;
+        }
+
         private bool IsContinue(int ip, int offset)
         {
-            return Blocks.FindIndex(x => (x.StartOffset >= offset && x.EndOffset < offset) && x.ContinueOffset == offset && (x.StartOffset >= ip && x.EndOffset < ip)) >= 0;
+            var loop = GetEnclosingBlock(ip, true);
+
+            // Going back to the top of a for(;;) is the same as going to its end
+            return loop != null && (loop.ContinueOffset == offset || (loop is ForEver && loop.StartOffset == offset));
         }
 
         private bool IsBreak(int ip, int offset)
         {
-            return Blocks.FindIndex(x => (x.StartOffset >= offset && x.EndOffset < offset) && x.BreakOffset == offset && (x.StartOffset >= ip && x.EndOffset < ip)) >= 0;
+            var block = GetEnclosingBlock(ip, false);
+
+            return block != null && block.BreakOffset == offset;
+        }
+
+        /// <summary>
+        /// Checks if the if statement is the whole of the else it starts, rather than just
+        /// the first statement within it, by checking if it joins at the end of the else
+        /// </summary>
+        private bool IsElseIfChain(DecompilerBlock block, int join)
+        {
+            var start = GetInstructionAt(block.StartOffset);
+
+            for (int i = start; i >= 0 && i < Function.Operations.Count; i++)
+            {
+                if (Function.Operations[i].Metadata.OpType != ScriptOpType.JumpCondition)
+                {
+                    continue;
+                }
+
+                // If both paths of the condition meet again at the end of the else
+                // there's nothing else to it, a loop that's only left by returning
+                // can post-dominate a join that isn't on every path so this can
+                // only confirm it, and only if we can get to the exit at all
+                var node = Graph.GetNode(i);
+                var postDominator = node.ImmediatePostDominator;
+
+                if (postDominator != null && !postDominator.IsExit && Graph.PostDominates(Graph.Exit, node) &&
+                    Function.Operations[postDominator.StartIndex].OpCodeOffset == join)
+                {
+                    return true;
+                }
+
+                break;
+            }
+
+            // Otherwise check where the if and its else end
+            var end = GetInstructionAt(block.EndOffset);
+
+            if (end > 0 && Function.Operations[end - 1].Metadata.OpCode == ScriptOpCode.Jump && Graph.GetJumpLocation(end - 1) == join)
+            {
+                return true;
+            }
+
+            return block.EndOffset == join;
         }
 
         private void DecompileBlock(DecompilerBlock decompilerBlock, int tabs)
         {
             if(decompilerBlock is SwitchBlock switchBlock)
             {
-                switchBlock.Value = Stack.Pop();
+                switchBlock.Value = PopString();
             }
 
             WriteHeader(decompilerBlock);
             Writer.Indent = tabs;
 
-            for(int i = GetInstructionAt(decompilerBlock.StartOffset); i < Function.Operations.Count && Function.Operations[i].OpCodeOffset <= decompilerBlock.EndOffset; i++)
+            for(int i = GetInstructionAt(decompilerBlock.StartOffset); i < Function.Operations.Count && Function.Operations[i].OpCodeOffset < decompilerBlock.EndOffset; i++)
             {
                 var operation = Function.Operations[i];
 
@@ -657,13 +911,12 @@ namespace Cerberus.Logic
         /// </summary>
         void FindDevBlocks()
         {
-            foreach(var operation in Function.Operations)
+            foreach(var index in Graph.DevBlocks)
             {
-                if(operation.Metadata.OpCode == ScriptOpCode.DevblockBegin)
-                {
-                    // Dev Blocks are simple, just a size
-                    Blocks.Add(new DevBlock(operation.OpCodeOffset, Script.GetJumpLocation(operation.OpCodeOffset + operation.OpCodeSize, (int)operation.Operands[0].Value)));
-                }
+                var operation = Function.Operations[index];
+
+                // Dev Blocks are simple, just a size
+                AddBlock(new DevBlock(operation.OpCodeOffset, Graph.GetJumpLocation(index)));
             }
         }
 
@@ -687,28 +940,28 @@ namespace Cerberus.Logic
         {
             // We perform a reverse scan, since we're looking for negative jumps
             // If we come across a negative jump it can be one of 2 things: a continue
-            // statement, or a loop. We can determine if it's a continue if we can find
-            // the jump location within our list of blocks, if we can't, it's a new loop
+            // statement, or a loop. The last back edge to a header is the loop itself,
+            // so any we come across after it that the header dominates are continues
 
             // We don't check for break statements here as we first need to ensure we've
             // resolved for loops, etc. later
-            for(int i = Function.Operations.Count - 1; i >= 0; i--)
+            for(int k = Graph.Jumps.Count - 1; k >= 0; k--)
             {
+                var i = Graph.Jumps[k];
+
                 switch(Function.Operations[i].Metadata.OpCode)
                 {
                     case ScriptOpCode.Jump:
                         {
                             // Check for a negative jumps, is almost always a loop
-                            if((int)Function.Operations[i].Operands[0].Value < 0)
+                            if(Function.Operations[i].Operands[0].IntValue < 0)
                             {
-                                // Compute the jump location based as some games align the value
-                                var offset = Script.GetJumpLocation(
-                                    Function.Operations[i].OpCodeOffset + Function.Operations[i].OpCodeSize, 
-                                    (int)Function.Operations[i].Operands[0].Value);
+                                // The index has already resolved it, as some games align the value
+                                var offset = Graph.GetJumpLocation(i);
 
                                 // Attempt to locate the block at the current location, if we fail we're
                                 // creating a new loop, otherwise this is probably continue statement
-                                if(!IsContinue(Function.Operations[i].OpCodeOffset, offset))
+                                if(!IsLoopContinue(i, offset))
                                 {
                                     Function.Operations[i].Visited = true;
 
@@ -722,10 +975,11 @@ namespace Cerberus.Logic
                                     {
                                         var op = Function.Operations[j];
 
-                                        // Check if we hit a JumpOn, if we do, we're probably a while(...)
+                                        // Check if we hit a JumpOn, if we do and it leaves the loop we're a while(...)
+                                        // otherwise it's an if at the top of a for(;;)
                                         if (op.Metadata.OpType == ScriptOpType.JumpCondition)
                                         {
-                                            hasCondition = true;
+                                            hasCondition = Graph.GetJumpLocation(j) == end + Function.Operations[i].OpCodeSize;
                                             break;
                                         }
 
@@ -746,14 +1000,15 @@ namespace Cerberus.Logic
                                             BreakOffset = end + Function.Operations[i].OpCodeSize
                                         };
 
-                                        Blocks.Add(whileLoop);
+                                        AddLoop(whileLoop);
                                     }
                                     else
                                     {
                                         // We're an infinite for(;;)
-                                        Blocks.Add(new ForEver(offset, end)
+                                        AddLoop(new ForEver(offset, end)
                                         {
-                                            ContinueOffset = end
+                                            ContinueOffset = end,
+                                            BreakOffset = end + Function.Operations[i].OpCodeSize
                                         });
                                     }
                                 }
@@ -764,14 +1019,45 @@ namespace Cerberus.Logic
             }
         }
 
+        /// <summary>
+        /// Adds a loop found from its back edge
+        /// </summary>
+        private void AddLoop(DecompilerBlock loop)
+        {
+            if (!LoopHeaders.ContainsKey(loop.StartOffset))
+            {
+                LoopHeaders[loop.StartOffset] = loop;
+            }
+
+            AddBlock(loop);
+        }
+
+        /// <summary>
+        /// Checks if the back edge is a continue, i.e. it jumps to the header
+        /// of a loop we've already found that contains and dominates it
+        /// </summary>
+        private bool IsLoopContinue(int index, int offset)
+        {
+            if (!LoopHeaders.TryGetValue(offset, out var loop) || Function.Operations[index].OpCodeOffset >= loop.EndOffset)
+            {
+                return false;
+            }
+
+            var header = GetInstructionAt(offset);
+            var node = Graph.GetNode(index);
+
+            // Dead code (after a return or a for(;;)) isn't dominated by the header, so it goes by where it is
+            return header >= 0 && (Graph.Dominates(Graph.GetNode(header), node) || !Graph.Dominates(Graph.Entry, node));
+        }
+
         /// <summary>
         /// Builds an expression jump
         /// </summary>
-        private string BuildExpression(ScriptOp startOp)
+        private int BuildExpression(ScriptOp startOp)
         {
             // JumpOnTrue is || JumpOnFalse is &&
             var requiresBraces = false;
-            var endOffset = Script.GetJumpLocation(startOp.OpCodeOffset + startOp.OpCodeSize, (int)startOp.Operands[0].Value);
+            var endOffset = Script.GetJumpLocation(startOp.OpCodeOffset + startOp.OpCodeSize, startOp.Operands[0].IntValue);
 
             var startIndex = GetInstructionAt(startOp.OpCodeOffset + startOp.OpCodeSize);
             var endIndex = GetInstructionAt(endOffset);
@@ -805,14 +1091,14 @@ namespace Cerberus.Logic
 
             // Determine if it needs braces (nested expressions)
             if (requiresBraces)
-                result = "(" + result + ")";
+                result = Expressions.Begin().Append("(").Append(result).Append(")").End();
 
             return result;
         }
 
         private string BuildCondition(int startIndex)
         {
-            var result = "";
+            var result = -1;
             var requiresBraces = false;
 
             for(int j = startIndex; j < Function.Operations.Count; j++)
@@ -826,7 +1112,7 @@ namespace Cerberus.Logic
 
                 if (op.Metadata.OpType == ScriptOpType.JumpCondition)
                 {
-                    result += Stack.Pop();
+                    result = Stack.Pop();
                     // If it's a forward JumpOnTrue, we add ! since the block won't execute if the
                     // the condition is true, however for dowhile this will be JumpOnTrue because
                     // we want to continue with the execution (back to start) if it's true
@@ -834,10 +1120,12 @@ namespace Cerberus.Logic
                     {
                         if(requiresBraces)
                         {
-                            result = "(" + result + ")";
+                            result = Expressions.Begin().Append("!(").Append(result).Append(")").End();
+                        }
+                        else
+                        {
+                            result = Expressions.Begin().Append("!").Append(result).End();
                         }
-
-                        result = "!" + result;
                     }
 
                     op.Visited = true;
@@ -859,7 +1147,7 @@ namespace Cerberus.Logic
                 op.Visited = true;
             }
 
-            return result;
+            return result == -1 ? "" : Expressions.Render(result);
         }
 
         /// <summary>
@@ -945,7 +1233,7 @@ namespace Cerberus.Logic
 
                             Blocks[index] = new ForEach(loop.StartOffset, loop.EndOffset)
                             {
-                                ArrayName = Stack.Pop(),
+                                ArrayName = PopString(),
                                 IteratorName = GetVariableName(Function.Operations[i + 9]),
                                 ContinueOffset = continueOffset,
                                 BreakOffset = loop.BreakOffset
@@ -1131,7 +1419,7 @@ namespace Cerberus.Logic
 
                                         if (op.Metadata.OpType == ScriptOpType.SetVariable)
                                         {
-                                            forLoop.Initializer = string.Format("{0} = {1}", CurrentReference, Stack.Pop());
+                                            forLoop.Initializer = string.Format("{0} = {1}", CurrentReference, PopString());
                                             CurrentReference = "";
                                             break;
                                         }
@@ -1187,7 +1475,7 @@ namespace Cerberus.Logic
             {
                 case ScriptOpType.SetVariable:
                     {
-                        loop.Modifier = string.Format("{0} = {1}", CurrentReference, Stack.Pop());
+                        loop.Modifier = string.Format("{0} = {1}", CurrentReference, PopString());
                         CurrentReference = "";
                         return true;
                     }
@@ -1310,40 +1598,69 @@ namespace Cerberus.Logic
                 case ScriptOpCode.EvalLocalVariableCached:
                 case ScriptOpCode.EvalLocalVariableRefCached:
                 case ScriptOpCode.SetWaittillVariableFieldCached:
-                    return GetLocalVariable((int)op.Operands[0].Value);
+                    return GetLocalVariable(op.Operands[0].IntValue);
                 case ScriptOpCode.EvalFieldVariable:
                 case ScriptOpCode.EvalFieldVariableRef:
-                    return CurrentObject + "." + (string)op.Operands[0].Value;
+                    return CurrentObject + "." + op.Operands[0].ToString();
                 case ScriptOpCode.EvalLevelFieldVariable:
                 case ScriptOpCode.EvalLevelFieldVariableRef:
-                    return "level." + (string)op.Operands[0].Value;
+                    return "level." + op.Operands[0].ToString();
                 case ScriptOpCode.EvalSelfFieldVariable:
                 case ScriptOpCode.EvalSelfFieldVariableRef:
-                    return "level." + (string)op.Operands[0].Value;
+                    return "level." + op.Operands[0].ToString();
                 default:
                     throw new ArgumentException("Invalid Op Code for GetVariableName");
             }
         }
 
         /// <summary>
-        /// 
+        /// Adds a block and records its start offset if it's the first block there
         /// </summary>
-        /// <param name="offset"></param>
-        /// <returns></returns>
-        private int GetBlockIndexAt(int offset)
+        /// <param name="block">Block to add</param>
+        private void AddBlock(DecompilerBlock block)
         {
-            return Blocks.FindIndex(x => x.StartOffset == offset);
+            if (!BlockIndices.ContainsKey(block.StartOffset))
+            {
+                BlockIndices[block.StartOffset] = Blocks.Count;
+            }
+
+            Blocks.Add(block);
         }
 
+        /// <summary>
+        /// Rebuilds the block offset lookup after blocks are removed or reordered
+        /// </summary>
+        private void RebuildBlockIndices()
+        {
+            BlockIndices.Clear();
+
+            for (int i = 0; i < Blocks.Count; i++)
+            {
+                if (!BlockIndices.ContainsKey(Blocks[i].StartOffset))
+                {
+                    BlockIndices[Blocks[i].StartOffset] = i;
+                }
+            }
+        }
 
         /// <summary>
-        /// 
+        /// Gets the index of the first block that starts at the given offset
         /// </summary>
-        /// <param name="offset"></param>
-        /// <returns></returns>
+        /// <param name="offset">Block start offset</param>
+        /// <returns>Block index if found, otherwise -1</returns>
+        private int GetBlockIndexAt(int offset)
+        {
+            return BlockIndices.TryGetValue(offset, out var index) ? index : -1;
+        }
+
+        /// <summary>
+        /// Gets the index of the instruction at the given offset
+        /// </summary>
+        /// <param name="offset">Op Code offset</param>
+        /// <returns>Instruction index if found, otherwise -1</returns>
         private int GetInstructionAt(int offset)
         {
-            return Function.Operations.FindIndex(x => x.OpCodeOffset == offset);
+            return InstructionIndices.TryGetValue(offset, out var index) ? index : -1;
         }
 
         private bool IsStackOperation(ScriptOp op)
@@ -1395,26 +1712,30 @@ namespace Cerberus.Logic
                         }
                         else
                         {
-                            Writer?.WriteLine("return {0};", Stack.Pop());
+                            var value = Stack.Pop();
+                            Writer?.Write("return ");
+                            Write(value);
+                            Writer?.WriteLine(";");
                         }
 
                         return false;
                     }
                 case ScriptOpType.StackPop:
                     {
-                        Writer?.WriteLine("{0};", Stack.Pop());
+                        Write(Stack.Pop());
+                        Writer?.WriteLine(";");
                         break;
                     }
                 case ScriptOpType.SizeOf:
                     {
-                        Stack.Push(Stack.Pop() + ".size");
+                        Stack.Push(Expressions.Begin().Append(Stack.Pop()).Append(".size").End());
                         break;
                     }
                 case ScriptOpType.Jump:
                     {
                         var jumpLoc = Script.GetJumpLocation(
                             operation.OpCodeOffset + operation.OpCodeSize,
-                            (int)operation.Operands[0].Value);
+                            operation.Operands[0].IntValue);
 
                         if (IsBreak(operation.OpCodeOffset, jumpLoc))
                         {
@@ -1429,7 +1750,14 @@ namespace Cerberus.Logic
                     }
                 case ScriptOpType.JumpExpression:
                     {
-                        Stack.Push(Stack.Pop() + (operation.Metadata.OpCode == ScriptOpCode.JumpOnFalseExpr ? " && " : " || ") + BuildExpression(operation));
+                        var left = Stack.Pop();
+                        var right = BuildExpression(operation);
+
+                        Stack.Push(Expressions.Begin()
+                            .Append(left)
+                            .Append(operation.Metadata.OpCode == ScriptOpCode.JumpOnFalseExpr ? " && " : " || ")
+                            .Append(right)
+                            .End());
                         break;
                     }
                 case ScriptOpType.ObjectReference:
@@ -1452,31 +1780,36 @@ namespace Cerberus.Logic
                             switch (operation.Metadata.OpCode)
                             {
                                 case ScriptOpCode.GetUndefined:
-                                    Stack.Push("undefined");
+                                    Stack.Push(Expressions.Literal("undefined"));
                                     break;
                                 case ScriptOpCode.GetZero:
-                                    Stack.Push("0");
+                                    Stack.Push(Expressions.Literal("0"));
                                     break;
                                 case ScriptOpCode.GetSelf:
-                                    Stack.Push("self");
+                                    Stack.Push(Expressions.Literal("self"));
                                     break;
                                 case ScriptOpCode.GetLevel:
-                                    Stack.Push("level");
+                                    Stack.Push(Expressions.Literal("level"));
                                     break;
                                 case ScriptOpCode.GetGame:
-                                    Stack.Push("game");
+                                    Stack.Push(Expressions.Literal("game"));
                                     break;
                                 case ScriptOpCode.GetAnim:
-                                    Stack.Push("anim");
+                                    Stack.Push(Expressions.Literal("anim"));
                                     break;
                                 case ScriptOpCode.GetWorld:
-                                    Stack.Push("world");
+                                    Stack.Push(Expressions.Literal("world"));
                                     break;
                                 case ScriptOpCode.GetEmptyArray:
-                                    Stack.Push("[]");
+                                    Stack.Push(Expressions.Literal("[]"));
                                     break;
                                 case ScriptOpCode.Vector:
-                                    Stack.Push(string.Format("({0}, {1}, {2})", Stack.Pop(), Stack.Pop(), Stack.Pop()));
+                                    {
+                                        var x = Stack.Pop();
+                                        var y = Stack.Pop();
+                                        var z = Stack.Pop();
+                                        Stack.Push(Expressions.Begin().Append("(").Append(x).Append(", ").Append(y).Append(", ").Append(z).Append(")").End());
+                                    }
                                     break;
                             }
                         }
@@ -1496,13 +1829,13 @@ namespace Cerberus.Logic
                                             functionName = import.Namespace + "::" + functionName;
                                         }
 
-                                        Stack.Push("&" + functionName);
+                                        Stack.Push(Expressions.Begin().Append("&").Append(functionName).End());
                                         break;
                                     }
                                 default:
                                     {
                                         // We have a value
-                                        Stack.Push(operation.Operands[0].Value.ToString());
+                                        Stack.Push(Expressions.Literal(operation.Operands[0].ToString()));
                                         break;
                                     }
                             }
@@ -1529,7 +1862,7 @@ namespace Cerberus.Logic
                                 CurrentObject = "classes";
                                 break;
                             case ScriptOpCode.CastFieldObject:
-                                CurrentObject = Stack.Pop();
+                                CurrentObject = PopString();
                                 break;
                         }
                         break;
@@ -1540,12 +1873,15 @@ namespace Cerberus.Logic
                         {
                             case ScriptOpCode.ClearFieldVariable:
                                 {
-                                    Writer?.WriteLine("{0}.{1} = undefined;", CurrentObject, operation.Operands[0].Value);
+                                    Writer?.WriteLine("{0}.{1} = undefined;", CurrentObject, operation.Operands[0].ToString());
                                     break;
                                 }
                             case ScriptOpCode.ClearArray:
                                 {
-                                    Writer?.WriteLine("{0}[{1}] = undefined;", CurrentReference, Stack.Pop());
+                                    var key = Stack.Pop();
+                                    Writer?.Write("{0}[", CurrentReference);
+                                    Write(key);
+                                    Writer?.WriteLine("] = undefined;");
                                     CurrentReference = "";
                                     break;
                                 }
@@ -1553,17 +1889,11 @@ namespace Cerberus.Logic
                         break;
                     }
                 case ScriptOpType.Comparison:
-                    {
-                        var right = Stack.Pop();
-                        var left = Stack.Pop();
-                        Stack.Push(string.Format("{0}{1}{2}", left, Operators[operation.Metadata.OpCode], right));
-                        break;
-                    }
                 case ScriptOpType.DoubleOperand:
                     {
                         var right = Stack.Pop();
                         var left = Stack.Pop();
-                        Stack.Push(string.Format("{0}{1}{2}", left, Operators[operation.Metadata.OpCode], right));
+                        Stack.Push(Expressions.Begin().Append(left).Append(Operators[operation.Metadata.OpCode]).Append(right).End());
                         break;
                     }
                 case ScriptOpType.SingleOperand:
@@ -1599,12 +1929,14 @@ namespace Cerberus.Logic
                                 {
                                     var value = Stack.Pop();
 
-                                    if(value.Contains("&&") || value.Contains("||"))
+                                    if(Expressions.HasLogicalOperator(value))
                                     {
-                                        value = "(" + value + ")";
+                                        Stack.Push(Expressions.Begin().Append("!(").Append(value).Append(")").End());
+                                    }
+                                    else
+                                    {
+                                        Stack.Push(Expressions.Begin().Append("!").Append(value).End());
                                     }
-
-                                    Stack.Push(string.Format("!{0}", value));
                                     break;
                                 }
                         }
@@ -1613,7 +1945,7 @@ namespace Cerberus.Logic
                 case ScriptOpType.Call:
                     {
                         // Store here as we'll resolve the method type
-                        string functionName;
+                        int functionName;
                         int paramCount;
                         bool threaded = false;
                         bool method = false;
@@ -1626,8 +1958,8 @@ namespace Cerberus.Logic
                             case ScriptOpCode.ScriptMethodThreadCallPointer:
                                 {
                                     // Pointers are wrapped
-                                    functionName = "[[" + Stack.Pop() + "]]";
-                                    paramCount = (int)operation.Operands[0].Value;
+                                    functionName = Expressions.Begin().Append("[[").Append(Stack.Pop()).Append("]]").End();
+                                    paramCount = operation.Operands[0].IntValue;
 
                                     // Check for thread calls
                                     if (
@@ -1653,13 +1985,16 @@ namespace Cerberus.Logic
                                 {
                                     var functionImport = Script.GetImport(operation.OpCodeOffset);
 
-                                    functionName = functionImport.Name;
                                     paramCount = functionImport.ParameterCount;
 
                                     // Check if we can omit the namespace, if it's the same as this, otherwise we need to add it
                                     if (!string.IsNullOrWhiteSpace(functionImport.Namespace) && functionImport.Namespace != Function.Namespace)
                                     {
-                                        functionName = functionImport.Namespace + "::" + functionName;
+                                        functionName = Expressions.Begin().Append(functionImport.Namespace).Append("::").Append(functionImport.Name).End();
+                                    }
+                                    else
+                                    {
+                                        functionName = Expressions.Literal(functionImport.Name);
                                     }
 
                                     // Check for thread calls
@@ -1681,15 +2016,15 @@ namespace Cerberus.Logic
                                 }
                             case ScriptOpCode.ClassFunctionCall:
                                 {
-                                    functionName = (string)operation.Operands[0].Value;
-                                    paramCount = (int)operation.Operands[1].Value;
+                                    functionName = Expressions.Literal(operation.Operands[0].ToString());
+                                    paramCount = operation.Operands[1].IntValue;
                                     break;
                                 }
                             default:
                                 {
                                     // Everything else take from the instruction table
                                     var opFunc = InstructionFunctions[operation.Metadata.OpCode];
-                                    functionName = opFunc.Item1;
+                                    functionName = Expressions.Literal(opFunc.Item1);
                                     paramCount = opFunc.Item2;
                                     break;
                                 }
@@ -1699,7 +2034,8 @@ namespace Cerberus.Logic
                         // wait is not pushed, it's technically not a call
                         if (operation.Metadata.OpCode == ScriptOpCode.Wait || operation.Metadata.OpCode == ScriptOpCode.WaitRealTime)
                         {
-                            Writer?.WriteLine("{0};", GenerateFunctionCall(functionName, paramCount, threaded, method));
+                            Write(GenerateFunctionCall(functionName, paramCount, threaded, method));
+                            Writer?.WriteLine(";");
                         }
                         else
                         {
@@ -1714,16 +2050,26 @@ namespace Cerberus.Logic
                         {
                             case ScriptOpCode.EndOn:
                                 {
-                                    Writer?.WriteLine("{0} endon({1});", Stack.Pop(), Stack.Pop());
+                                    var entity = Stack.Pop();
+                                    var notification = Stack.Pop();
+                                    Write(entity);
+                                    Writer?.Write(" endon(");
+                                    Write(notification);
+                                    Writer?.WriteLine(");");
                                     break;
                                 }
                             case ScriptOpCode.Notify:
                                 {
-                                    Writer?.Write("{0} notify({1}", Stack.Pop(), Stack.Pop());
+                                    var entity = Stack.Pop();
+                                    var notification = Stack.Pop();
+                                    Write(entity);
+                                    Writer?.Write(" notify(");
+                                    Write(notification);
 
                                     while (Stack.Count > 0)
                                     {
-                                        Writer.Write(", {0}", Stack.Pop());
+                                        Writer.Write(", ");
+                                        Write(Stack.Pop());
                                     }
 
                                     Writer.WriteLine(");");
@@ -1733,7 +2079,11 @@ namespace Cerberus.Logic
                             case ScriptOpCode.WaitTill:
                             case ScriptOpCode.WaitTillMatch:
                                 {
-                                    Writer.Write("{0} {1}({2}", Stack.Pop(), operation.Metadata.OpCode == ScriptOpCode.WaitTill ? "waittill" : "waittillmatch", Stack.Pop());
+                                    var entity = Stack.Pop();
+                                    var notification = Stack.Pop();
+                                    Write(entity);
+                                    Writer.Write(operation.Metadata.OpCode == ScriptOpCode.WaitTill ? " waittill(" : " waittillmatch(");
+                                    Write(notification);
 
                                     // Parse the variables created by a waittill
                                     var index = GetInstructionAt(operation.OpCodeOffset) + 1;
@@ -1761,23 +2111,23 @@ namespace Cerberus.Logic
                         {
                             case ScriptOpCode.EvalLocalVariableCached:
                                 {
-                                    Stack.Push(LocalVariables[LocalVariables.Count + ~(int)operation.Operands[0].Value]);
+                                    Stack.Push(Expressions.Literal(LocalVariables[LocalVariables.Count + ~operation.Operands[0].IntValue]));
                                     break;
                                 }
                             case ScriptOpCode.EvalFieldVariable:
                                 {
-                                    Stack.Push(CurrentObject + "." + (string)operation.Operands[0].Value);
+                                    Stack.Push(Expressions.Begin().Append(CurrentObject).Append(".").Append(operation.Operands[0].ToString()).End());
                                     break;
                                 }
                             // Black Ops 3 merges level/self eval into 1
                             case ScriptOpCode.EvalLevelFieldVariable:
                                 {
-                                    Stack.Push("level." + (string)operation.Operands[0].Value);
+                                    Stack.Push(Expressions.Begin().Append("level.").Append(operation.Operands[0].ToString()).End());
                                     break;
                                 }
                             case ScriptOpCode.EvalSelfFieldVariable:
                                 {
-                                    Stack.Push("self." + (string)operation.Operands[0].Value);
+                                    Stack.Push(Expressions.Begin().Append("self.").Append(operation.Operands[0].ToString()).End());
                                     break;
                                 }
                         }
@@ -1789,23 +2139,23 @@ namespace Cerberus.Logic
                         {
                             case ScriptOpCode.EvalLocalVariableRefCached:
                                 {
-                                    CurrentReference = LocalVariables[LocalVariables.Count - (int)operation.Operands[0].Value - 1];
+                                    CurrentReference = LocalVariables[LocalVariables.Count - operation.Operands[0].IntValue - 1];
                                     break;
                                 }
                             case ScriptOpCode.EvalFieldVariableRef:
                                 {
-                                    CurrentReference = CurrentObject + "." + (string)operation.Operands[0].Value;
+                                    CurrentReference = CurrentObject + "." + operation.Operands[0].ToString();
                                     break;
                                 }
                             // Black Ops 3 merges level/self eval into 1
                             case ScriptOpCode.EvalLevelFieldVariableRef:
                                 {
-                                    CurrentReference = "level." + (string)operation.Operands[0].Value;
+                                    CurrentReference = "level." + operation.Operands[0].ToString();
                                     break;
                                 }
                             case ScriptOpCode.EvalSelfFieldVariableRef:
                                 {
-                                    CurrentReference = "self." + (string)operation.Operands[0].Value;
+                                    CurrentReference = "self." + operation.Operands[0].ToString();
                                     break;
                                 }
                         }
@@ -1815,17 +2165,20 @@ namespace Cerberus.Logic
                     {
                         var var = Stack.Pop();
                         var key = Stack.Pop();
-                        Stack.Push(var + "[" + key + "]");
+                        Stack.Push(Expressions.Begin().Append(var).Append("[").Append(key).Append("]").End());
                         break;
                     }
                 case ScriptOpType.ArrayReference:
                     {
-                        CurrentReference += "[" + Stack.Pop() + "]";
+                        CurrentReference += "[" + PopString() + "]";
                         break;
                     }
                 case ScriptOpType.SetVariable:
                     {
-                        Writer?.WriteLine("{0} = {1};", CurrentReference, Stack.Pop());
+                        var value = Stack.Pop();
+                        Writer?.Write("{0} = ", CurrentReference);
+                        Write(value);
+                        Writer?.WriteLine(";");
                         break;
                     }
             }
@@ -1840,6 +2193,22 @@ namespace Cerberus.Logic
         {
             InternalWriter?.Dispose();
             Writer?.Dispose();
+
+            // Hand the buffers back for the next function on this thread, unless
+            // this function was so large we'd rather not hold onto it
+            if (Expressions != null)
+            {
+                ExpressionArena.Return(Expressions);
+                Expressions = null;
+            }
+
+            if (Output != null && Output.Capacity <= 0x100000)
+            {
+                Output.Clear();
+                PooledOutput = Output;
+            }
+
+            Output = null;
         }
     }
 }
@@ -0,0 +1,221 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Cerberus.Logic
+{
+    /// <summary>
+    /// A class to handle caching decompiled functions on disk
+    ///
+    /// Entries are keyed by game, export checksum, byte code size, and a digest
+    /// of every name/string the function resolves, so a hash table update only
+    /// invalidates the functions whose names actually changed. Each entry is its
+    /// own file and is written to a temporary file first then renamed into place,
+    /// so multiple processes can share the same cache directory
+    /// </summary>
+    public class DecompilerCache
+    {
+        /// <summary>
+        /// FNV1a 64bit offset basis
+        /// </summary>
+        private const ulong OffsetBasis = 0xCBF29CE484222325;
+
+        /// <summary>
+        /// FNV1a 64bit prime
+        /// </summary>
+        private const ulong Prime = 0x100000001B3;
+
+        /// <summary>
+        /// Gets the root directory of the cache, entries are stored under a folder keyed on the
+        /// module version id of this assembly, deterministic builds only change it when the
+        /// code does, so a rebuilt decompiler never serves output from an older one
+        /// </summary>
+        public string Directory { get; private set; }
+
+        /// <summary>
+        /// Gets the number of functions served from the cache
+        /// </summary>
+        public int Hits => _Hits;
+
+        /// <summary>
+        /// Gets the number of functions that had to be decompiled
+        /// </summary>
+        public int Misses => _Misses;
+
+        /// <summary>
+        /// Internal hit/miss counters
+        /// </summary>
+        private int _Hits, _Misses;
+
+        /// <summary>
+        /// Initializes an instance of the Decompiler Cache at the given directory
+        /// </summary>
+        public DecompilerCache(string directory)
+        {
+            Directory = Path.Combine(directory, typeof(DecompilerCache).Assembly.ManifestModule.ModuleVersionId.ToString("N"));
+        }
+
+        /// <summary>
+        /// Gets the path of the entry for the given function
+        /// </summary>
+        public string GetEntryPath(ScriptBase script, ScriptExport function)
+        {
+            return Path.Combine(
+                Directory,
+                script.Game,
+                string.Format("{0:X8}_{1:X}_{2:X16}.txt", function.Checksum, function.ByteCodeSize, ComputeNameDigest(script, function)));
+        }
+
+        /// <summary>
+        /// Attempts to load the entry at the given path
+        /// </summary>
+        /// <returns>True if the entry exists and is valid, otherwise false</returns>
+        public bool TryLoad(string entryPath, out string result, out int lineCount)
+        {
+            result = null;
+            lineCount = 0;
+
+            try
+            {
+                var text = File.ReadAllText(entryPath);
+                var split = text.IndexOf('\n');
+
+                if (split > 0 && int.TryParse(text.Substring(0, split), out lineCount))
+                {
+                    result = text.Substring(split + 1);
+                    System.Threading.Interlocked.Increment(ref _Hits);
+                    return true;
+                }
+            }
+            catch (IOException) { }
+            catch (UnauthorizedAccessException) { }
+
+            System.Threading.Interlocked.Increment(ref _Misses);
+            return false;
+        }
+
+        /// <summary>
+        /// Stores the decompiled function at the given path
+        /// </summary>
+        public void Store(string entryPath, string result, int lineCount)
+        {
+            // Write to a unique temporary file first, the rename is atomic so readers
+            // either see the full entry or nothing, and if another writer beat us
+            // to it, it's the same output so we can just drop ours
+            var tempPath = entryPath + "." + Guid.NewGuid().ToString("N") + ".tmp";
+
+            try
+            {
+                System.IO.Directory.CreateDirectory(Path.GetDirectoryName(entryPath));
+                File.WriteAllText(tempPath, lineCount.ToString() + "\n" + result);
+
+                if (!File.Exists(entryPath))
+                {
+                    File.Move(tempPath, entryPath);
+                }
+            }
+            catch (IOException) { }
+            catch (UnauthorizedAccessException) { }
+            finally
+            {
+                try
+                {
+                    if (File.Exists(tempPath))
+                    {
+                        File.Delete(tempPath);
+                    }
+                }
+                catch (IOException) { }
+                catch (UnauthorizedAccessException) { }
+            }
+        }
+
+        /// <summary>
+        /// Computes a digest of everything the decompiled output depends on that isn't
+        /// covered by the byte code checksum: resolved hashes, strings, and imports
+        /// </summary>
+        private static ulong ComputeNameDigest(ScriptBase script, ScriptExport function)
+        {
+            var hash = OffsetBasis;
+
+            hash = Update(hash, function.Name);
+            hash = Update(hash, function.Namespace);
+            hash = Update(hash, function.ParameterCount);
+            hash = Update(hash, (int)function.Flags);
+
+            foreach (var operation in function.Operations)
+            {
+                foreach (var operand in operation.Operands)
+                {
+                    switch (operand.Kind)
+                    {
+                        case ScriptOpOperandKind.String:
+                            hash = Update(hash, operand.Text);
+                            break;
+                        case ScriptOpOperandKind.Hash:
+                            hash = operand.IsResolved ? Update(hash, operand.Text) : Update(hash, operand.IntValue);
+                            break;
+                        case ScriptOpOperandKind.Switch:
+                            hash = Update(hash, operand.SwitchCase.CaseValue);
+                            break;
+                    }
+                }
+
+                // Calls and pointers are resolved through the import table
+                if (operation.Metadata.OpType == ScriptOpType.Call || operation.Metadata.OperandType == ScriptOperandType.FunctionPointer)
+                {
+                    var import = script.GetImport(operation.OpCodeOffset);
+
+                    if (import != null)
+                    {
+                        hash = Update(hash, import.Name);
+                        hash = Update(hash, import.Namespace);
+                        hash = Update(hash, import.ParameterCount);
+                    }
+                }
+            }
+
+            return hash;
+        }
+
+        /// <summary>
+        /// Updates the FNV1a hash with the given string, including a terminator so
+        /// adjacent values can't run into each other
+        /// </summary>
+        private static ulong Update(ulong hash, string value)
+        {
+            if (value != null)
+            {
+                foreach (var c in value)
+                {
+                    hash ^= (byte)c;
+                    hash *= Prime;
+                    hash ^= (byte)(c >> 8);
+                    hash *= Prime;
+                }
+            }
+
+            hash ^= 0xFF;
+            hash *= Prime;
+
+            return hash;
+        }
+
+        /// <summary>
+        /// Updates the FNV1a hash with the given integer
+        /// </summary>
+        private static ulong Update(ulong hash, int value)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                hash ^= (byte)(value >> (i * 8));
+                hash *= Prime;
+            }
+
+            return hash;
+        }
+    }
+}
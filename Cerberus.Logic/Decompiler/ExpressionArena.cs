@@ -0,0 +1,260 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Cerberus.Logic
+{
+    /// <summary>
+    /// A class to hold the expressions of a function as a tree of nodes
+    ///
+    /// Nodes and their parts are structs stored in flat arrays that are reused
+    /// across functions, an expression is only turned into text when it's written
+    /// so long call chains and array literals no longer build a new string for
+    /// every level they're nested in
+    /// </summary>
+    internal class ExpressionArena
+    {
+        /// <summary>
+        /// A struct to hold a node, a run of parts
+        /// </summary>
+        private struct Node
+        {
+            public int PartStart;
+            public int PartCount;
+            public bool HasLogicalOperator;
+        }
+
+        /// <summary>
+        /// A struct to hold part of a node, either text or a child node
+        /// </summary>
+        private struct Part
+        {
+            public string Text;
+            public int Node;
+        }
+
+        /// <summary>
+        /// Arena for the current thread, each thread decompiles one function at a time
+        /// </summary>
+        [ThreadStatic]
+        private static ExpressionArena Pooled;
+
+        /// <summary>
+        /// Nodes
+        /// </summary>
+        private Node[] Nodes = new Node[256];
+
+        /// <summary>
+        /// Parts of the nodes
+        /// </summary>
+        private Part[] Parts = new Part[1024];
+
+        /// <summary>
+        /// Number of nodes and parts in use
+        /// </summary>
+        private int NodeCount, PartCount;
+
+        /// <summary>
+        /// Whether or not we're building a node
+        /// </summary>
+        private bool Building;
+
+        /// <summary>
+        /// Render stack, reused so rendering deep expressions doesn't recurse or allocate
+        /// </summary>
+        private readonly Stack<KeyValuePair<int, int>> RenderStack = new Stack<KeyValuePair<int, int>>();
+
+        /// <summary>
+        /// Buffer used when an expression is needed as a string
+        /// </summary>
+        private readonly StringBuilder Buffer = new StringBuilder();
+
+        /// <summary>
+        /// Writer over the buffer
+        /// </summary>
+        private readonly StringWriter BufferWriter;
+
+        /// <summary>
+        /// Initializes an instance of the Expression Arena Class
+        /// </summary>
+        private ExpressionArena()
+        {
+            BufferWriter = new StringWriter(Buffer);
+        }
+
+        /// <summary>
+        /// Gets an empty arena for the current thread
+        /// </summary>
+        public static ExpressionArena Rent()
+        {
+            var arena = Pooled ?? new ExpressionArena();
+            Pooled = null;
+            arena.Reset();
+            return arena;
+        }
+
+        /// <summary>
+        /// Returns the arena so the next function on this thread can reuse it
+        /// </summary>
+        public static void Return(ExpressionArena arena)
+        {
+            arena.Reset();
+            Pooled = arena;
+        }
+
+        /// <summary>
+        /// Clears all nodes
+        /// </summary>
+        public void Reset()
+        {
+            // Drop string references so they can be collected
+            Array.Clear(Parts, 0, PartCount);
+            NodeCount = 0;
+            PartCount = 0;
+            Building = false;
+        }
+
+        /// <summary>
+        /// Creates a node that's just the given text
+        /// </summary>
+        public int Literal(string text)
+        {
+            return Begin().Append(text).End();
+        }
+
+        /// <summary>
+        /// Begins a new node, child nodes must be created before calling this
+        /// </summary>
+        public ExpressionArena Begin()
+        {
+            if (Building)
+            {
+                throw new InvalidOperationException("Expression nodes cannot be nested while building.");
+            }
+
+            if (NodeCount == Nodes.Length)
+            {
+                Array.Resize(ref Nodes, Nodes.Length * 2);
+            }
+
+            Building = true;
+            Nodes[NodeCount] = new Node()
+            {
+                PartStart = PartCount
+            };
+
+            return this;
+        }
+
+        /// <summary>
+        /// Appends text to the node being built
+        /// </summary>
+        public ExpressionArena Append(string text)
+        {
+            if (string.IsNullOrEmpty(text))
+            {
+                return this;
+            }
+
+            if (text.IndexOf("&&", StringComparison.Ordinal) >= 0 || text.IndexOf("||", StringComparison.Ordinal) >= 0)
+            {
+                Nodes[NodeCount].HasLogicalOperator = true;
+            }
+
+            return AddPart(new Part() { Text = text, Node = -1 });
+        }
+
+        /// <summary>
+        /// Appends a child node to the node being built
+        /// </summary>
+        public ExpressionArena Append(int node)
+        {
+            if (Nodes[node].HasLogicalOperator)
+            {
+                Nodes[NodeCount].HasLogicalOperator = true;
+            }
+
+            return AddPart(new Part() { Node = node });
+        }
+
+        /// <summary>
+        /// Finishes the node being built
+        /// </summary>
+        /// <returns>Index of the node</returns>
+        public int End()
+        {
+            Building = false;
+            Nodes[NodeCount].PartCount = PartCount - Nodes[NodeCount].PartStart;
+            return NodeCount++;
+        }
+
+        /// <summary>
+        /// Adds a part to the node being built
+        /// </summary>
+        private ExpressionArena AddPart(Part part)
+        {
+            if (PartCount == Parts.Length)
+            {
+                Array.Resize(ref Parts, Parts.Length * 2);
+            }
+
+            Parts[PartCount++] = part;
+            return this;
+        }
+
+        /// <summary>
+        /// Checks if the rendered node would contain && or ||
+        /// </summary>
+        public bool HasLogicalOperator(int node) => Nodes[node].HasLogicalOperator;
+
+        /// <summary>
+        /// Renders the node to a string
+        /// </summary>
+        public string Render(int node)
+        {
+            // Single text nodes are the common case, no need to copy them
+            if (Nodes[node].PartCount == 1 && Parts[Nodes[node].PartStart].Node < 0)
+            {
+                return Parts[Nodes[node].PartStart].Text;
+            }
+
+            Buffer.Clear();
+            Render(node, BufferWriter);
+            return Buffer.ToString();
+        }
+
+        /// <summary>
+        /// Renders the node directly to the writer
+        /// </summary>
+        public void Render(int node, TextWriter writer)
+        {
+            RenderStack.Clear();
+            RenderStack.Push(new KeyValuePair<int, int>(node, 0));
+
+            while (RenderStack.Count > 0)
+            {
+                var current = RenderStack.Pop();
+                var currentNode = Nodes[current.Key];
+
+                if (current.Value < currentNode.PartCount)
+                {
+                    RenderStack.Push(new KeyValuePair<int, int>(current.Key, current.Value + 1));
+
+                    var part = Parts[currentNode.PartStart + current.Value];
+
+                    if (part.Node < 0)
+                    {
+                        writer.Write(part.Text);
+                    }
+                    else
+                    {
+                        RenderStack.Push(new KeyValuePair<int, int>(part.Node, 0));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -9,6 +9,45 @@ namespace Cerberus.Logic
 {
     public static class FastFile
     {
+        /// <summary>
+        /// A stream that reads a bounded block of another stream from its current position
+        /// </summary>
+        class BlockStream : Stream
+        {
+            private readonly Stream Source;
+            private long Remaining;
+
+            public BlockStream(Stream source) => Source = source;
+
+            /// <summary>
+            /// Starts a new block at the source's current position
+            /// </summary>
+            public void Reset(long length) => Remaining = length;
+
+            public override bool CanRead => true;
+            public override bool CanSeek => false;
+            public override bool CanWrite => false;
+            public override long Length => throw new NotSupportedException();
+            public override long Position { get => throw new NotSupportedException(); set => throw new NotSupportedException(); }
+
+            public override int Read(byte[] buffer, int offset, int count)
+            {
+                if (Remaining <= 0)
+                {
+                    return 0;
+                }
+
+                var bytesRead = Source.Read(buffer, offset, (int)Math.Min(count, Remaining));
+                Remaining -= bytesRead;
+                return bytesRead;
+            }
+
+            public override void Flush() { }
+            public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+            public override void SetLength(long value) => throw new NotSupportedException();
+            public override void Write(byte[] buffer, int offset, int count) => throw new NotSupportedException();
+        }
+
         /// <summary>
         /// Invalid Characters from C# Reference Source
         /// </summary>
@@ -41,6 +80,11 @@ namespace Cerberus.Logic
         /// </summary>
         private static readonly byte[] NeedleBo2 = { 0xFF, 0xFF, 0xFF, 0xFF };
 
+        /// <summary>
+        /// Size of the buffers used when inflating blocks
+        /// </summary>
+        private const int InflateBufferSize = 0x10000;
+
         /// <summary>
         /// Decodes Deflate byte array to Memory Stream
         /// </summary>
@@ -49,12 +93,8 @@ namespace Cerberus.Logic
         public static MemoryStream Decode(byte[] data)
         {
             MemoryStream output = new MemoryStream();
-            MemoryStream input = new MemoryStream(data);
 
-            using (DeflateStream deflateStream = new DeflateStream(input, CompressionMode.Decompress))
-            {
-                deflateStream.CopyTo(output);
-            }
+            Inflate(new MemoryStream(data), output, new byte[InflateBufferSize]);
 
             output.Flush();
             output.Position = 0;
@@ -62,12 +102,42 @@ namespace Cerberus.Logic
             return output;
         }
 
-        public static List<string> Decompress(string filePath, string outputPath)
+        /// <summary>
+        /// Inflates Deflate data from the input's current position straight into the output
+        /// </summary>
+        /// <param name="input">Input, left open, may be read past the end of the Deflate data</param>
+        /// <param name="output">Output to write to</param>
+        /// <param name="buffer">Reusable copy buffer</param>
+        private static void Inflate(Stream input, Stream output, byte[] buffer)
         {
-            Func<BinaryReader, List<string>> extractMethod = null;
+            using (PipelineTrace.Begin("FastFile", "Decode"))
+            using (DeflateStream deflateStream = new DeflateStream(input, CompressionMode.Decompress, true))
+            {
+                int bytesRead;
 
-            using (var reader = new BinaryReader(File.OpenRead(filePath)))
-            using(var writer = new BinaryWriter(File.Create(outputPath)))
+                while ((bytesRead = deflateStream.Read(buffer, 0, buffer.Length)) > 0)
+                {
+                    output.Write(buffer, 0, bytesRead);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Decompresses the Fast File and extracts the scripts in it
+        /// </summary>
+        /// <param name="filePath">Fast File path</param>
+        /// <param name="outputPath">Path to decompress to</param>
+        /// <param name="store">Optional store, if given scripts are stored by content and only new payloads are returned</param>
+        /// <returns>Paths of the extracted scripts</returns>
+        public static List<string> Decompress(string filePath, string outputPath, ScriptStore store = null)
+        {
+            Func<BinaryReader, string, ScriptStore, List<string>> extractMethod = null;
+
+            // The zone is read once front to back, blocks are inflated straight from the file
+            using (PipelineTrace.Begin("FastFile", "Decompress", filePath))
+            using (var file = new FileStream(filePath, FileMode.Open, FileAccess.Read, FileShare.Read, 4096, FileOptions.SequentialScan))
+            using (var reader = new BinaryReader(file))
+            using (var writer = new FileStream(outputPath, FileMode.Create, FileAccess.Write, FileShare.None, 0x100000))
             {
                 var magic = reader.ReadUInt64();
                 var version = reader.ReadUInt32();
@@ -80,7 +150,7 @@ namespace Cerberus.Logic
                 switch(version)
                 {
                     case 0x251:
-                        DecompressBO3(reader, writer);
+                        DecompressBO3(reader, file, writer);
                         extractMethod = ExtractScriptsBo3;
                         break;
                     case 0x93:
@@ -92,16 +162,17 @@ namespace Cerberus.Logic
                 }
             }
 
-            using(var reader = new BinaryReader(File.OpenRead(outputPath)))
+            using (PipelineTrace.Begin("FastFile", "ExtractScripts", filePath))
+            using (var reader = new BinaryReader(File.OpenRead(outputPath)))
             {
-                return extractMethod?.Invoke(reader);
+                return extractMethod?.Invoke(reader, Path.GetFileNameWithoutExtension(filePath), store);
             }
         }
 
         /// <summary>
         /// Decompresses a Black Ops III Fast File
         /// </summary>
-        private static void DecompressBO3(BinaryReader reader, BinaryWriter writer)
+        private static void DecompressBO3(BinaryReader reader, FileStream file, Stream writer)
         {
             var flags = reader.ReadBytes(4);
 
@@ -126,6 +197,9 @@ namespace Cerberus.Logic
 
             reader.BaseStream.Position = 584;
 
+            var buffer = new byte[InflateBufferSize];
+            var block = new BlockStream(file);
+
             while(consumed < size)
             {
                 // Read Block Header
@@ -147,8 +221,18 @@ namespace Cerberus.Logic
                     continue;
                 }
 
-                reader.BaseStream.Position += 2;
-                writer.Write(Decode(reader.ReadBytes(compressedSize - 2)).ToArray());
+                // Skip the zlib header and inflate through a stream bounded to this block's
+                // data, so a corrupt block can never read on into the next one
+                var dataPosition = reader.BaseStream.Position + 2;
+
+                if (compressedSize < 2 || dataPosition + compressedSize - 2 > file.Length)
+                {
+                    throw new Exception("Block Size is out of range.");
+                }
+
+                file.Position = dataPosition;
+                block.Reset(compressedSize - 2);
+                Inflate(block, writer, buffer);
 
                 consumed += decompressedSize;
 
@@ -160,7 +244,7 @@ namespace Cerberus.Logic
         /// <summary>
         /// Extracts scripts from a Black Ops III Fast File
         /// </summary>
-        private static List<string> ExtractScriptsBo3(BinaryReader reader)
+        private static List<string> ExtractScriptsBo3(BinaryReader reader, string zone, ScriptStore store)
         {
             // Need to skip the strings and assets
             // to avoid redundant checks on these by
@@ -180,7 +264,12 @@ namespace Cerberus.Logic
 
 
             var results = new List<string>();
-            var offsets = reader.FindBytes(NeedleBo3);
+            long[] offsets;
+
+            using (PipelineTrace.Begin("FastFile", "FindBytes"))
+            {
+                offsets = reader.FindBytes(NeedleBo3);
+            }
 
             foreach(var offset in offsets)
             {
@@ -205,12 +294,7 @@ namespace Cerberus.Logic
                             // Last check, extension
                             if (extension == ".gsc" || extension == ".csc")
                             {
-                                var outputPath = "ExtractedScripts\\Black Ops III\\" + name + "c";
-                                Directory.CreateDirectory(Path.GetDirectoryName(outputPath));
-
-                                File.WriteAllBytes(outputPath, reader.ReadBytes((int)size));
-
-                                results.Add(outputPath);
+                                WriteScript("ExtractedScripts\\Black Ops III\\", zone, name, reader.ReadBytes((int)size), store, results);
                             }
                         }
                     }
@@ -224,10 +308,35 @@ namespace Cerberus.Logic
             return results;
         }
 
+        /// <summary>
+        /// Writes an extracted script, to the store if we have one, otherwise to the given folder
+        /// </summary>
+        private static void WriteScript(string directory, string zone, string name, byte[] data, ScriptStore store, List<string> results)
+        {
+            using (PipelineTrace.Begin("FastFile", "WriteScript", name))
+            {
+                if (store != null)
+                {
+                    // Shared scripts are in many zones, only hand back payloads we haven't processed
+                    if (store.Add(zone, name, data, out var objectPath) && !results.Contains(objectPath))
+                    {
+                        results.Add(objectPath);
+                    }
+                }
+                else
+                {
+                    var outputPath = directory + name + "c";
+                    Directory.CreateDirectory(Path.GetDirectoryName(outputPath));
+                    File.WriteAllBytes(outputPath, data);
+                    results.Add(outputPath);
+                }
+            }
+        }
+
         /// <summary>
         /// Decompresses a Black Ops II Fast File
         /// </summary>
-        private static void DecompressBO2(BinaryReader reader, BinaryWriter writer)
+        private static void DecompressBO2(BinaryReader reader, Stream writer)
         {
             reader.BaseStream.Position += 12;
 
@@ -241,35 +350,46 @@ namespace Cerberus.Logic
 
             int sectionIndex = 0;
             var salsa = new Salsa20 { Key = FastFileKey };
+            var buffer = new byte[InflateBufferSize];
+            var data = new byte[0];
 
-            while (true)
+            using (var sha1 = SHA1.Create())
             {
-                int size = reader.ReadInt32();
+                while (true)
+                {
+                    int size = reader.ReadInt32();
 
-                if (size == 0)
-                    break;
+                    if (size == 0)
+                        break;
 
-                salsa.IV = GetIV(sectionIndex % 4, ivTable, ivCounter);
+                    // Sections are encrypted so they're decrypted in place, into the same buffer each time
+                    if (data.Length < size)
+                        data = new byte[size];
 
-                var decryptor = salsa.CreateDecryptor();
+                    if (reader.Read(data, 0, size) != size)
+                        throw new EndOfStreamException();
 
-                byte[] decryptedData = decryptor.TransformFinalBlock(reader.ReadBytes(size), 0, size);
+                    salsa.IV = GetIV(sectionIndex % 4, ivTable, ivCounter);
 
-                writer.Write(Decode(decryptedData).ToArray());
+                    using (var decryptor = salsa.CreateDecryptor())
+                    {
+                        // Salsa20 is a stream cipher, decrypt in place
+                        decryptor.TransformBlock(data, 0, size, data, 0);
+                    }
 
-                using (var sha1 = SHA1.Create())
-                {
-                    UpdateIVTable(sectionIndex % 4, sha1.ComputeHash(decryptedData), ivTable, ivCounter);
-                }
+                    Inflate(new MemoryStream(data, 0, size, false), writer, buffer);
+
+                    UpdateIVTable(sectionIndex % 4, sha1.ComputeHash(data, 0, size), ivTable, ivCounter);
 
-                sectionIndex++;
+                    sectionIndex++;
+                }
             }
         }
 
         /// <summary>
         /// Extracts scripts from a Black Ops II Fast File
         /// </summary>
-        private static List<string> ExtractScriptsBo2(BinaryReader reader)
+        private static List<string> ExtractScriptsBo2(BinaryReader reader, string zone, ScriptStore store)
         {
             // Need to skip the strings and assets
             // to avoid redundant checks on these by
@@ -290,7 +410,12 @@ namespace Cerberus.Logic
 
 
             var results = new List<string>();
-            var offsets = reader.FindBytes(NeedleBo2);
+            long[] offsets;
+
+            using (PipelineTrace.Begin("FastFile", "FindBytes"))
+            {
+                offsets = reader.FindBytes(NeedleBo2);
+            }
 
             foreach (var offset in offsets)
             {
@@ -315,12 +440,7 @@ namespace Cerberus.Logic
                             // Last check, extension
                             if (extension == ".gsc" || extension == ".csc")
                             {
-                                var outputPath = "ExtractedScripts\\BlackOps II\\" + name + "c";
-                                Directory.CreateDirectory(Path.GetDirectoryName(outputPath));
-
-                                File.WriteAllBytes(outputPath, reader.ReadBytes((int)size));
-
-                                results.Add(outputPath);
+                                WriteScript("ExtractedScripts\\BlackOps II\\", zone, name, reader.ReadBytes((int)size), store, results);
                             }
                         }
                     }
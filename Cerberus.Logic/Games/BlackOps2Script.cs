@@ -225,25 +225,25 @@ namespace Cerberus.Logic
                     }
                 case ScriptOperandType.Int8:
                     {
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadSByte()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadSByte()));
                         break;
                     }
                 case ScriptOperandType.UInt8:
                     {
                         if(operation.Metadata.OpCode == ScriptOpCode.GetNegByte)
                         {
-                            operation.Operands.Add(new ScriptOpOperand(-Reader.ReadByte()));
+                            AddOperand(operation, new ScriptOpOperand(-Reader.ReadByte()));
                         }
                         else
                         {
-                            operation.Operands.Add(new ScriptOpOperand(Reader.ReadByte()));
+                            AddOperand(operation, new ScriptOpOperand(Reader.ReadByte()));
                         }
                         break;
                     }
                 case ScriptOperandType.Int16:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 2);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadInt16()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadInt16()));
                         break;
                     }
                 case ScriptOperandType.UInt16:
@@ -251,42 +251,42 @@ namespace Cerberus.Logic
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 2);
                         if (operation.Metadata.OpCode == ScriptOpCode.GetNegUnsignedShort)
                         {
-                            operation.Operands.Add(new ScriptOpOperand(-Reader.ReadUInt16()));
+                            AddOperand(operation, new ScriptOpOperand(-Reader.ReadUInt16()));
                         }
                         else
                         {
-                            operation.Operands.Add(new ScriptOpOperand(Reader.ReadUInt16()));
+                            AddOperand(operation, new ScriptOpOperand(Reader.ReadUInt16()));
                         }
                         break;
                     }
                 case ScriptOperandType.Int32:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadInt32()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadInt32()));
                         break;
                     }
                 case ScriptOperandType.UInt32:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadUInt32()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadUInt32()));
                         break;
                     }
                 case ScriptOperandType.Hash:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(GetHashValue(Reader.ReadUInt32(), "hash_")));
+                        AddOperand(operation, CreateHashOperand(Reader.ReadUInt32(), "hash_"));
                         break;
                     }
                 case ScriptOperandType.Float:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadSingle()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadSingle()));
                         break;
                     }
                 case ScriptOperandType.Vector:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadSingle(), Reader.ReadSingle(), Reader.ReadSingle()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadSingle(), Reader.ReadSingle(), Reader.ReadSingle()));
                         break;
                     }
                 case ScriptOperandType.VectorFlags:
@@ -294,7 +294,7 @@ namespace Cerberus.Logic
                         var flags = Reader.ReadByte();
 
                         // Set each flag, it's either 1.0, -1.0, or simply 0.0
-                        operation.Operands.Add(new ScriptOpOperand(
+                        AddOperand(operation, new ScriptOpOperand(
                             (flags & 0x20) != 0 ? 1.0f : (flags & 0x10) != 0 ? -1.0f : 0.0f,
                             (flags & 0x08) != 0 ? 1.0f : (flags & 0x04) != 0 ? -1.0f : 0.0f,
                             (flags & 0x02) != 0 ? 1.0f : (flags & 0x01) != 0 ? -1.0f : 0.0f));
@@ -303,7 +303,7 @@ namespace Cerberus.Logic
                 case ScriptOperandType.VariableName:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 2);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadUInt16())));
+                        AddOperand(operation, new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadUInt16())));
                         break;
                     }
                 case ScriptOperandType.String:
@@ -314,17 +314,17 @@ namespace Cerberus.Logic
                         {
                             case ScriptOpCode.GetString:
                                 Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 2);
-                                operation.Operands.Add(new ScriptOpOperand("\"" + GetString((int)Reader.BaseStream.Position).Value + "\""));
+                                AddOperand(operation, new ScriptOpOperand(GetString((int)Reader.BaseStream.Position).Value, ScriptOpOperandFormat.Quoted));
                                 Reader.BaseStream.Position += 2;
                                 break;
                             case ScriptOpCode.GetIString:
                                 Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 2);
-                                operation.Operands.Add(new ScriptOpOperand("&\"" + GetString((int)Reader.BaseStream.Position).Value + "\""));
+                                AddOperand(operation, new ScriptOpOperand(GetString((int)Reader.BaseStream.Position).Value, ScriptOpOperandFormat.LocalizedString));
                                 Reader.BaseStream.Position += 2;
                                 break;
                             default:
                                 Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                                operation.Operands.Add(new ScriptOpOperand("%" + Reader.PeekNullTerminatedString(Reader.ReadInt32())));
+                                AddOperand(operation, new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadInt32()), ScriptOpOperandFormat.Animation));
                                 break;
                         }
                         
@@ -333,7 +333,7 @@ namespace Cerberus.Logic
                 case ScriptOperandType.FunctionPointer:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadInt32())));
+                        AddOperand(operation, new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadInt32())));
                         break;
                     }
                 case ScriptOperandType.Call:
@@ -343,7 +343,7 @@ namespace Cerberus.Logic
                         try
                         {
                             Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                            operation.Operands.Add(new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadInt32())));
+                            AddOperand(operation, new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadInt32())));
                         }
                         catch
                         {
@@ -358,7 +358,7 @@ namespace Cerberus.Logic
                         for(int i = 0; i < varCount; i++)
                         {
                             Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 2);
-                            operation.Operands.Add(new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadUInt16())));
+                            AddOperand(operation, new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadUInt16())));
                         }
 
                         break;
@@ -369,7 +369,7 @@ namespace Cerberus.Logic
 
                         foreach(var switchBlock in switches)
                         {
-                            operation.Operands.Add(new ScriptOpOperand(switchBlock));
+                            AddOperand(operation, new ScriptOpOperand(switchBlock));
                         }
                         break;
                     }
@@ -153,17 +153,20 @@ namespace Cerberus.Logic
 
                 // From kokole/Nukem's, brute force via CRC32
                 // This will only work on files dumped from a fast file
-                while (true)
+                using (PipelineTrace.Begin("Script", "ChecksumSizeSearch", export.Name))
                 {
-                    crc32.Update(Reader.ReadByte());
-
-                    // If we hit, we're done
-                    if (crc32.Value == export.Checksum)
+                    while (true)
                     {
-                        break;
-                    }
+                        crc32.Update(Reader.ReadByte());
 
-                    byteCodeSize += 1;
+                        // If we hit, we're done
+                        if (crc32.Value == export.Checksum)
+                        {
+                            break;
+                        }
+
+                        byteCodeSize += 1;
+                    }
                 }
 
                 // We can now use this - the start as our size
@@ -272,25 +275,25 @@ namespace Cerberus.Logic
                     }
                 case ScriptOperandType.Int8:
                     {
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadSByte()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadSByte()));
                         break;
                     }
                 case ScriptOperandType.UInt8:
                     {
                         if (operation.Metadata.OpCode == ScriptOpCode.GetNegByte)
                         {
-                            operation.Operands.Add(new ScriptOpOperand(Reader.ReadByte() * -1));
+                            AddOperand(operation, new ScriptOpOperand(Reader.ReadByte() * -1));
                         }
                         else
                         {
-                            operation.Operands.Add(new ScriptOpOperand(Reader.ReadByte()));
+                            AddOperand(operation, new ScriptOpOperand(Reader.ReadByte()));
                         }
                         break;
                     }
                 case ScriptOperandType.Int16:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 2);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadInt16()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadInt16()));
                         break;
                     }
                 case ScriptOperandType.UInt16:
@@ -298,42 +301,42 @@ namespace Cerberus.Logic
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 2);
                         if (operation.Metadata.OpCode == ScriptOpCode.GetNegUnsignedShort)
                         {
-                            operation.Operands.Add(new ScriptOpOperand(Reader.ReadUInt16() * -1));
+                            AddOperand(operation, new ScriptOpOperand(Reader.ReadUInt16() * -1));
                         }
                         else
                         {
-                            operation.Operands.Add(new ScriptOpOperand(Reader.ReadUInt16()));
+                            AddOperand(operation, new ScriptOpOperand(Reader.ReadUInt16()));
                         }
                         break;
                     }
                 case ScriptOperandType.Int32:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadInt32()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadInt32()));
                         break;
                     }
                 case ScriptOperandType.UInt32:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadUInt32()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadUInt32()));
                         break;
                     }
                 case ScriptOperandType.Hash:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand("\"" + GetHashValue(Reader.ReadUInt32(), "hash_") + "\""));
+                        AddOperand(operation, CreateHashOperand(Reader.ReadUInt32(), "hash_", ScriptOpOperandFormat.Quoted));
                         break;
                     }
                 case ScriptOperandType.Float:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadSingle()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadSingle()));
                         break;
                     }
                 case ScriptOperandType.Vector:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                        operation.Operands.Add(new ScriptOpOperand(Reader.ReadSingle()));
+                        AddOperand(operation, new ScriptOpOperand(Reader.ReadSingle()));
                         break;
                     }
                 case ScriptOperandType.VectorFlags:
@@ -341,11 +344,11 @@ namespace Cerberus.Logic
                         var flags = Reader.ReadByte();
 
                         // Set each flag, it's either 1.0, -1.0, or simply 0.0
-                        operation.Operands.Add(new ScriptOpOperand(
-                            string.Format("({0}, {1}, {2})",
+                        AddOperand(operation, new ScriptOpOperand(
                             (flags & 0x20) != 0 ? 1.0f : (flags & 0x10) != 0 ? -1.0f : 0.0f,
                             (flags & 0x08) != 0 ? 1.0f : (flags & 0x04) != 0 ? -1.0f : 0.0f,
-                            (flags & 0x02) != 0 ? 1.0f : (flags & 0x01) != 0 ? -1.0f : 0.0f)));
+                            (flags & 0x02) != 0 ? 1.0f : (flags & 0x01) != 0 ? -1.0f : 0.0f,
+                            ScriptOpOperandFormat.Parenthesized));
                         break;
                     }
                 case ScriptOperandType.String:
@@ -356,17 +359,17 @@ namespace Cerberus.Logic
                         {
                             case ScriptOpCode.GetString:
                                 Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                                operation.Operands.Add(new ScriptOpOperand("\"" + GetString((int)Reader.BaseStream.Position)?.Value + "\""));
+                                AddOperand(operation, new ScriptOpOperand(GetString((int)Reader.BaseStream.Position)?.Value, ScriptOpOperandFormat.Quoted));
                                 Reader.BaseStream.Position += 4;
                                 break;
                             case ScriptOpCode.GetIString:
                                 Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                                operation.Operands.Add(new ScriptOpOperand("&\"" + GetString((int)Reader.BaseStream.Position)?.Value + "\""));
+                                AddOperand(operation, new ScriptOpOperand(GetString((int)Reader.BaseStream.Position)?.Value, ScriptOpOperandFormat.LocalizedString));
                                 Reader.BaseStream.Position += 4;
                                 break;
                             case ScriptOpCode.GetAnimation:
                                 Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 8);
-                                operation.Operands.Add(new ScriptOpOperand("%" + Reader.PeekNullTerminatedString(Reader.ReadInt32())));
+                                AddOperand(operation, new ScriptOpOperand(Reader.PeekNullTerminatedString(Reader.ReadInt32()), ScriptOpOperandFormat.Animation));
                                 Reader.BaseStream.Position += 4;
                                 break;
                         }
@@ -377,14 +380,13 @@ namespace Cerberus.Logic
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
 
-                        var name = GetHashValue(Reader.ReadUInt32(), "var_");
-                        operation.Operands.Add(new ScriptOpOperand(name));
+                        AddOperand(operation, CreateHashOperand(Reader.ReadUInt32(), "var_"));
                         break;
                     }
                 case ScriptOperandType.FunctionPointer:
                     {
                         Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 8);
-                        operation.Operands.Add(new ScriptOpOperand("&" + GetHashValue(Reader.ReadUInt32(), "function_")));
+                        AddOperand(operation, CreateHashOperand(Reader.ReadUInt32(), "function_", ScriptOpOperandFormat.Reference));
                         Reader.BaseStream.Position += 4;
                         break;
                     }
@@ -394,15 +396,15 @@ namespace Cerberus.Logic
                         {
                             var paramterCount = Reader.ReadByte();
                             Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                            operation.Operands.Add(new ScriptOpOperand(GetHashValue(Reader.ReadUInt32(), "function_")));
-                            operation.Operands.Add(new ScriptOpOperand(paramterCount));
+                            AddOperand(operation, CreateHashOperand(Reader.ReadUInt32(), "function_"));
+                            AddOperand(operation, new ScriptOpOperand(paramterCount));
                         }
                         else
                         {
                             // Skip param count, it isn't stored here until in memory
                             Reader.BaseStream.Position += 1;
                             Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 8);
-                            operation.Operands.Add(new ScriptOpOperand(GetHashValue(Reader.ReadUInt32(), "function_")));
+                            AddOperand(operation, CreateHashOperand(Reader.ReadUInt32(), "function_"));
                             Reader.BaseStream.Position += 4;
                         }
                         break;
@@ -414,7 +416,7 @@ namespace Cerberus.Logic
                         for(int i = 0; i < varCount; i++)
                         {
                             Reader.BaseStream.Position += Utility.ComputePadding((int)Reader.BaseStream.Position, 4);
-                            operation.Operands.Add(new ScriptOpOperand(GetHashValue(Reader.ReadUInt32(), "var_")));
+                            AddOperand(operation, CreateHashOperand(Reader.ReadUInt32(), "var_"));
                             Reader.BaseStream.Position += 1;
                         }
 
@@ -426,7 +428,7 @@ namespace Cerberus.Logic
 
                         foreach (var switchBlock in switches)
                         {
-                            operation.Operands.Add(new ScriptOpOperand(switchBlock));
+                            AddOperand(operation, new ScriptOpOperand(switchBlock));
                         }
                         break;
                     }
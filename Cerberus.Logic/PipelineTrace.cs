@@ -0,0 +1,268 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Text;
+using System.Threading;
+
+namespace Cerberus.Logic
+{
+    /// <summary>
+    /// A class to record timed spans across the pipeline and write them in the Chrome/Perfetto trace format
+    ///
+    /// When tracing isn't started Begin returns an empty span and nothing is recorded, so spans
+    /// can be left in hot paths. Each thread records to its own buffer.
+    /// </summary>
+    public static class PipelineTrace
+    {
+        /// <summary>
+        /// A struct to hold a recorded span
+        /// </summary>
+        private struct Event
+        {
+            public string Category;
+            public string Name;
+            public string Detail;
+            public long Start;
+            public long End;
+        }
+
+        /// <summary>
+        /// A class to hold the spans recorded on a thread
+        /// </summary>
+        private class ThreadBuffer
+        {
+            public int ThreadID;
+            public string ThreadName;
+            public readonly List<Event> Events = new List<Event>();
+        }
+
+        /// <summary>
+        /// A struct to hold an open span, ends when disposed
+        /// </summary>
+        public struct Span : IDisposable
+        {
+            private readonly string Category;
+            private readonly string Name;
+            private readonly string Detail;
+            private readonly long Start;
+
+            internal Span(string category, string name, string detail, long start)
+            {
+                Category = category;
+                Name = name;
+                Detail = detail;
+                Start = start;
+            }
+
+            /// <summary>
+            /// Ends the span
+            /// </summary>
+            public void Dispose()
+            {
+                // Empty spans are returned when tracing is disabled
+                if (Name != null && Enabled)
+                {
+                    Record(Category, Name, Detail, Start, Stopwatch.GetTimestamp());
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets whether or not tracing is enabled
+        /// </summary>
+        public static bool Enabled { get; private set; }
+
+        /// <summary>
+        /// Timestamp the trace started at
+        /// </summary>
+        private static long StartTimestamp;
+
+        /// <summary>
+        /// Buffers for every thread that has recorded a span
+        /// </summary>
+        private static readonly List<ThreadBuffer> Buffers = new List<ThreadBuffer>();
+
+        /// <summary>
+        /// Buffer for the current thread
+        /// </summary>
+        [ThreadStatic]
+        private static ThreadBuffer CurrentBuffer;
+
+        /// <summary>
+        /// Starts recording spans
+        /// </summary>
+        public static void Start()
+        {
+            lock (Buffers)
+            {
+                foreach (var buffer in Buffers)
+                {
+                    lock (buffer)
+                    {
+                        buffer.Events.Clear();
+                    }
+                }
+
+                StartTimestamp = Stopwatch.GetTimestamp();
+                Enabled = true;
+            }
+        }
+
+        /// <summary>
+        /// Stops recording spans and writes them to the given file
+        /// </summary>
+        public static void Stop(string filePath)
+        {
+            Enabled = false;
+
+            using (var writer = new StreamWriter(filePath, false, new UTF8Encoding(false), 0x100000))
+            {
+                Write(writer);
+            }
+        }
+
+        /// <summary>
+        /// Begins a span, dispose it to end it
+        /// </summary>
+        /// <param name="category">Part of the pipeline, i.e. FastFile, Script, Decompiler</param>
+        /// <param name="name">Name of the operation</param>
+        /// <param name="detail">Optional script/function name</param>
+        public static Span Begin(string category, string name, string detail = null)
+        {
+            if (!Enabled)
+            {
+                return default(Span);
+            }
+
+            return new Span(category, name, detail, Stopwatch.GetTimestamp());
+        }
+
+        /// <summary>
+        /// Records a finished span on the current thread
+        /// </summary>
+        private static void Record(string category, string name, string detail, long start, long end)
+        {
+            var buffer = CurrentBuffer;
+
+            if (buffer == null)
+            {
+                var thread = Thread.CurrentThread;
+
+                buffer = new ThreadBuffer()
+                {
+                    ThreadID = thread.ManagedThreadId,
+                    ThreadName = thread.Name ?? (thread.IsThreadPoolThread ? "Worker " : "Thread ") + thread.ManagedThreadId,
+                };
+
+                lock (Buffers)
+                {
+                    Buffers.Add(buffer);
+                }
+
+                CurrentBuffer = buffer;
+            }
+
+            // Only contended while the trace is being written
+            lock (buffer)
+            {
+                buffer.Events.Add(new Event()
+                {
+                    Category = category,
+                    Name = name,
+                    Detail = detail,
+                    Start = start,
+                    End = end,
+                });
+            }
+        }
+
+        /// <summary>
+        /// Writes the recorded spans as trace event JSON
+        /// </summary>
+        private static void Write(TextWriter writer)
+        {
+            var processID = Process.GetCurrentProcess().Id;
+            var toMicroseconds = 1000000.0 / Stopwatch.Frequency;
+            var first = true;
+
+            writer.Write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+            lock (Buffers)
+            {
+                foreach (var buffer in Buffers)
+                {
+                    lock (buffer)
+                    {
+                        if (buffer.Events.Count == 0)
+                        {
+                            continue;
+                        }
+
+                        writer.Write(first ? "\n" : ",\n");
+                        writer.Write("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{0},\"tid\":{1},\"args\":{{\"name\":", processID, buffer.ThreadID);
+                        WriteString(writer, buffer.ThreadName);
+                        writer.Write("}}");
+                        first = false;
+
+                        foreach (var e in buffer.Events)
+                        {
+                            writer.Write(",\n{\"name\":");
+                            WriteString(writer, e.Name);
+                            writer.Write(",\"cat\":");
+                            WriteString(writer, e.Category);
+                            writer.Write(",\"ph\":\"X\",\"ts\":");
+                            writer.Write(((e.Start - StartTimestamp) * toMicroseconds).ToString("0.###", System.Globalization.CultureInfo.InvariantCulture));
+                            writer.Write(",\"dur\":");
+                            writer.Write(((e.End - e.Start) * toMicroseconds).ToString("0.###", System.Globalization.CultureInfo.InvariantCulture));
+                            writer.Write(",\"pid\":{0},\"tid\":{1}", processID, buffer.ThreadID);
+
+                            if (e.Detail != null)
+                            {
+                                writer.Write(",\"args\":{\"detail\":");
+                                WriteString(writer, e.Detail);
+                                writer.Write("}");
+                            }
+
+                            writer.Write("}");
+                        }
+                    }
+                }
+            }
+
+            writer.Write("\n]}\n");
+        }
+
+        /// <summary>
+        /// Writes an escaped JSON string
+        /// </summary>
+        private static void WriteString(TextWriter writer, string value)
+        {
+            writer.Write('"');
+
+            foreach (var c in value ?? "")
+            {
+                switch (c)
+                {
+                    case '"': writer.Write("\\\""); break;
+                    case '\\': writer.Write("\\\\"); break;
+                    case '\n': writer.Write("\\n"); break;
+                    case '\r': writer.Write("\\r"); break;
+                    case '\t': writer.Write("\\t"); break;
+                    default:
+                        if (c < 0x20)
+                        {
+                            writer.Write("\\u{0:X4}", (int)c);
+                        }
+                        else
+                        {
+                            writer.Write(c);
+                        }
+                        break;
+                }
+            }
+
+            writer.Write('"');
+        }
+    }
+}
@@ -1,5 +1,6 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.Globalization;
 using System.Linq;
 using System.Text;
 using System.Threading.Tasks;
@@ -77,6 +78,21 @@ namespace Cerberus.Logic
         /// </summary>
         public Dictionary<uint, string> HashReferences = new Dictionary<uint, string>();
 
+        /// <summary>
+        /// Operands of all loaded operations
+        /// </summary>
+        public ScriptOpOperandPool OperandPool = new ScriptOpOperandPool();
+
+        /// <summary>
+        /// Gets or Sets the cache of decompiled functions, null to always decompile
+        /// </summary>
+        public DecompilerCache Cache { get; set; }
+
+        /// <summary>
+        /// Op Code names as written in the disassembly, indexed by op code
+        /// </summary>
+        private static readonly string[] DisassemblyNames = Enumerable.Range(0, 256).Select(x => "OP_" + (ScriptOpCode)x).ToArray();
+
         /// <summary>
         /// Initializes an instance of the Script Class
         /// </summary>
@@ -84,12 +100,24 @@ namespace Cerberus.Logic
         {
             Reader = reader;
             HashTable = hashTable;
-            LoadHeader();
-            LoadIncludes();
-            LoadAnimTrees();
-            LoadStrings();
-            LoadImports();
-            LoadExports();
+
+            using (PipelineTrace.Begin("Script", "LoadHeader"))
+            {
+                LoadHeader();
+            }
+
+            using (PipelineTrace.Begin("Script", "LoadTables", FilePath))
+            {
+                LoadIncludes();
+                LoadAnimTrees();
+                LoadStrings();
+                LoadImports();
+            }
+
+            using (PipelineTrace.Begin("Script", "LoadExports", FilePath))
+            {
+                LoadExports();
+            }
         }
 
         /// <summary>
@@ -111,6 +139,17 @@ namespace Cerberus.Logic
         public abstract ScriptOp LoadOperation(int offset);
 
         public void LoadFunction(ScriptExport function)
+        {
+            using (PipelineTrace.Begin("Script", "LoadFunction", function.Name))
+            {
+                LoadFunctionOperations(function);
+            }
+        }
+
+        /// <summary>
+        /// Decodes the operations of the function
+        /// </summary>
+        private void LoadFunctionOperations(ScriptExport function)
         {
             var offset = function.ByteCodeOffset;
             var endOffset = function.ByteCodeOffset + function.ByteCodeSize;
@@ -134,25 +173,96 @@ namespace Cerberus.Logic
             }
         }
 
+        /// <summary>
+        /// Adds an operand to the operation, operands must be added to one operation at a time
+        /// </summary>
+        protected void AddOperand(ScriptOp operation, ScriptOpOperand operand)
+        {
+            var index = OperandPool.Add(operand);
+
+            if (operation.OperandCount == 0)
+            {
+                operation.OperandPool = OperandPool;
+                operation.OperandStart = index;
+            }
+
+            operation.OperandCount++;
+        }
+
+        /// <summary>
+        /// Creates an operand for the given hash, the name is only formatted if it's written
+        /// </summary>
+        protected ScriptOpOperand CreateHashOperand(uint value, string prefix, ScriptOpOperandFormat format = ScriptOpOperandFormat.None)
+        {
+            if (HashTable.TryGetValue(value, out var result))
+            {
+                return new ScriptOpOperand(value, result, prefix, format);
+            }
+
+            // Still track it for the hash table export
+            if (!HashReferences.ContainsKey(value))
+            {
+                HashReferences.Add(value, string.Format("{0}{1:x}", prefix, value));
+            }
+
+            return new ScriptOpOperand(value, null, prefix, format);
+        }
+
         /// <summary>
         /// Disassembles the entire script and returns a string containing the disassembly
         /// </summary>
         public string Disassemble()
+        {
+            using (var writer = new StringWriter())
+            {
+                Disassemble(writer);
+                return writer.ToString();
+            }
+        }
+
+        /// <summary>
+        /// Disassembles the entire script to the given file
+        /// </summary>
+        public void DisassembleToFile(string filePath)
+        {
+            using (var writer = new StreamWriter(filePath, false, new UTF8Encoding(false), 0x100000))
+            {
+                Disassemble(writer);
+            }
+        }
+
+        /// <summary>
+        /// Disassembles the entire script to the given writer
+        /// </summary>
+        public void Disassemble(TextWriter writer)
+        {
+            using (PipelineTrace.Begin("Script", "Disassemble", FilePath))
+            {
+                DisassembleExports(writer);
+            }
+        }
+
+        /// <summary>
+        /// Writes the disassembly of the includes and exports
+        /// </summary>
+        private void DisassembleExports(TextWriter writer)
         {
             // Keep track of the line number for UI
             var lineNumber = 0;
-            var output = new StringBuilder();
+            var hexBuffer = new char[8];
 
             foreach(var include in Includes)
             {
-                output.AppendLine(string.Format("#using {0};", include));
+                writer.Write("#using ");
+                writer.Write(include);
+                writer.WriteLine(";");
                 lineNumber++;
             }
 
             // Add a space
             if (Includes.Count > 0)
             {
-                output.AppendLine();
+                writer.WriteLine();
                 lineNumber++;
             }
 
@@ -161,15 +271,25 @@ namespace Cerberus.Logic
                 try
                 {
                     // Spit out some info
-                    output.AppendLine("/*");
-                    output.AppendLine(string.Format("\tName: {0}", function.Name));
-                    output.AppendLine(string.Format("\tNamespace: {0}", function.Namespace));
-                    output.AppendLine(string.Format("\tChecksum: 0x{0:X}", function.Checksum));
-                    output.AppendLine(string.Format("\tOffset: 0x{0:X}", function.ByteCodeOffset));
-                    output.AppendLine(string.Format("\tSize: 0x{0:X}", function.ByteCodeSize));
-                    output.AppendLine(string.Format("\tParameters: {0}", function.ParameterCount));
-                    output.AppendLine(string.Format("\tFlags: {0}", function.Flags));
-                    output.AppendLine("*/");
+                    writer.WriteLine("/*");
+                    writer.Write("\tName: ");
+                    writer.WriteLine(function.Name);
+                    writer.Write("\tNamespace: ");
+                    writer.WriteLine(function.Namespace);
+                    writer.Write("\tChecksum: 0x");
+                    Utility.WriteHex(writer, function.Checksum, 1, hexBuffer);
+                    writer.WriteLine();
+                    writer.Write("\tOffset: 0x");
+                    Utility.WriteHex(writer, (uint)function.ByteCodeOffset, 1, hexBuffer);
+                    writer.WriteLine();
+                    writer.Write("\tSize: 0x");
+                    Utility.WriteHex(writer, (uint)function.ByteCodeSize, 1, hexBuffer);
+                    writer.WriteLine();
+                    writer.Write("\tParameters: ");
+                    writer.WriteLine(function.ParameterCount);
+                    writer.Write("\tFlags: ");
+                    writer.WriteLine(function.Flags.ToString());
+                    writer.WriteLine("*/");
                     lineNumber += 9;
 
                     // Use the liner number AFTER the info above, we want to go
@@ -178,45 +298,67 @@ namespace Cerberus.Logic
 
                     // If we have a namespace we can add it, for decompiler we'll use
                     // #namespace but for disassembly we'll add it to the call
-                    output.AppendLine(string.Format("function {0}{1}(...)",
-                        string.IsNullOrWhiteSpace(function.Namespace) ? "" : function.Namespace + "::",
-                        function.Name));
-                    output.AppendLine("{");
+                    writer.Write("function ");
+                    if (!string.IsNullOrWhiteSpace(function.Namespace))
+                    {
+                        writer.Write(function.Namespace);
+                        writer.Write("::");
+                    }
+                    writer.Write(function.Name);
+                    writer.WriteLine("(...)");
+                    writer.WriteLine("{");
                     lineNumber += 2;
 
                     foreach(var operation in function.Operations)
                     {
                         // Add IP and Size Info
-                        output.AppendFormat("\t/* IP: 0x{0} - Size 0x{1} */\t\t\tOP_{2}(",
-                            operation.OpCodeOffset.ToString("X8"),
-                            operation.OpCodeSize.ToString("X8"),
-                            operation.Metadata.OpCode);
+                        writer.Write("\t/* IP: 0x");
+                        Utility.WriteHex(writer, (uint)operation.OpCodeOffset, 8, hexBuffer);
+                        writer.Write(" - Size 0x");
+                        Utility.WriteHex(writer, (uint)operation.OpCodeSize, 8, hexBuffer);
+                        writer.Write(" */\t\t\t");
+                        writer.Write(DisassemblyNames[(int)operation.Metadata.OpCode]);
+                        writer.Write("(");
+
+                        var operands = operation.Operands;
 
-                        for (int i = 0; i < operation.Operands.Count; i++)
+                        for (int i = 0; i < operands.Count; i++)
                         {
-                            output.AppendFormat("{0}{1}", operation.Operands[i].Value, i == operation.Operands.Count - 1 ? "" : ", ");
+                            operands[i].Write(writer);
+
+                            if (i != operands.Count - 1)
+                                writer.Write(", ");
                         }
 
-                        output.AppendLine(");");
+                        writer.WriteLine(");");
 
                         lineNumber++;
                     }
 
-                    output.AppendLine("}");
+                    writer.WriteLine("}");
                     lineNumber++;
                 }
                 catch(Exception e)
                 {
-                    output.AppendLine("/* " + e.ToString() + " */");
+                    writer.WriteLine("/* " + e.ToString() + " */");
                     lineNumber += e.ToString().Split('\n').Length;
-                    output.AppendLine("}");
+                    writer.WriteLine("}");
                 }
             }
-
-            return output.ToString();
         }
 
         public string Decompile()
+        {
+            using (PipelineTrace.Begin("Script", "Decompile", FilePath))
+            {
+                return DecompileExports();
+            }
+        }
+
+        /// <summary>
+        /// Builds the decompiled output of the includes and exports
+        /// </summary>
+        private string DecompileExports()
         {
             // Keep track of the line number for UI
             var output = new StringBuilder();
@@ -273,19 +415,45 @@ namespace Cerberus.Logic
                 output.AppendLine("*/");
                 lineNumber += 9;
 
-                using (var decompiler = new Decompiler(function, this))
+                function.DecompilerLine = lineNumber;
+
+                string result;
+                int lineCount;
+
+                // Check the cache first, the same functions are shared across many scripts
+                var cacheEntry = Cache?.GetEntryPath(this, function);
+
+                if (cacheEntry == null || !Cache.TryLoad(cacheEntry, out result, out lineCount))
                 {
-                    function.DecompilerLine = lineNumber;
-                    var result = decompiler.GetWriterOutput();
-                    output.Append(result);
-                    output.AppendLine();
-                    lineNumber += Utility.GetLineCount(result);
+                    result = DecompileFunction(function);
+                    lineCount = Utility.GetLineCount(result);
+
+                    if (cacheEntry != null)
+                    {
+                        Cache.Store(cacheEntry, result, lineCount);
+                    }
                 }
+
+                output.Append(result);
+                output.AppendLine();
+                lineNumber += lineCount;
             }
 
             return output.ToString();
         }
 
+        /// <summary>
+        /// Decompiles a single function, bypassing the cache
+        /// </summary>
+        public string DecompileFunction(ScriptExport function)
+        {
+            using (PipelineTrace.Begin("Decompiler", "DecompileFunction", function.Name))
+            using (var decompiler = new Decompiler(function, this))
+            {
+                return decompiler.GetWriterOutput();
+            }
+        }
+
         /// <summary>
         /// Exports Hash Table (unnamed variables, etc.)
         /// </summary>
@@ -304,6 +472,41 @@ namespace Cerberus.Logic
             return output.ToString();
         }
 
+        /// <summary>
+        /// Loads a hash table (hash,name per line) into the given dictionary
+        /// </summary>
+        /// <param name="filePath">Path of the hash table</param>
+        /// <param name="hashTable">Dictionary to add the hashes to</param>
+        /// <returns>True if the file was loaded, false if it doesn't exist</returns>
+        public static bool LoadHashTable(string filePath, Dictionary<uint, string> hashTable)
+        {
+            if (!File.Exists(filePath))
+            {
+                return false;
+            }
+
+            foreach (var line in File.ReadLines(filePath))
+            {
+                var lineTrim = line.Trim();
+
+                // Ignore comment lines
+                if (lineTrim.StartsWith("#"))
+                {
+                    continue;
+                }
+
+                var lineSplit = lineTrim.Split(',');
+
+                // Parse as hex, without 0x
+                if (lineSplit.Length > 1 && uint.TryParse(lineSplit[0].TrimStart('0', 'x'), NumberStyles.HexNumber, CultureInfo.CurrentCulture, out var hash))
+                {
+                    hashTable[hash] = lineSplit[1];
+                }
+            }
+
+            return true;
+        }
+
         /// <summary>
         /// Gets the string for the given hash, otherwise returns the default value or a formatted hex value
         /// </summary>
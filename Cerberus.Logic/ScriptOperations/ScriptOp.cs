@@ -29,8 +29,23 @@ namespace Cerberus.Logic
         public bool Visited = false;
 
         /// <summary>
-        /// List of Operation Operands
+        /// Pool this operation's operands are stored in
         /// </summary>
-        public List<ScriptOpOperand> Operands = new List<ScriptOpOperand>();
+        public ScriptOpOperandPool OperandPool { get; set; }
+
+        /// <summary>
+        /// Gets or Sets the index of the first operand in the pool
+        /// </summary>
+        public int OperandStart { get; set; }
+
+        /// <summary>
+        /// Gets or Sets the number of operands
+        /// </summary>
+        public int OperandCount { get; set; }
+
+        /// <summary>
+        /// Gets the Operation Operands
+        /// </summary>
+        public ScriptOpOperandList Operands => new ScriptOpOperandList(OperandPool, OperandStart, OperandCount);
     }
 }
@@ -1,74 +1,252 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.IO;
 using System.Linq;
 using System.Text;
 using System.Threading.Tasks;
-using PhilLibX.Mathematics;
 
 namespace Cerberus.Logic
 {
-    public class ScriptOpOperand
+    /// <summary>
+    /// A struct to hold an operand as a tagged value, stored inline in the script's operand pool
+    ///
+    /// Nothing is boxed or formatted when it's loaded, hashes keep their raw value and the name
+    /// they resolved to, strings keep a reference to the string in the script, the decoration
+    /// (quotes, &amp;, %, etc.) is only added when the operand is written
+    /// </summary>
+    public struct ScriptOpOperand
     {
         /// <summary>
-        /// Gets or Sets the Value of this operand
+        /// Gets the kind of value this operand holds
         /// </summary>
-        public object Value { get; set; }
+        public ScriptOpOperandKind Kind { get; }
+
+        /// <summary>
+        /// Gets how the value is decorated when written
+        /// </summary>
+        public ScriptOpOperandFormat Format { get; }
+
+        /// <summary>
+        /// Integer, unsigned integer, or hash value
+        /// </summary>
+        private readonly int Bits;
+
+        /// <summary>
+        /// Float or vector values
+        /// </summary>
+        private readonly float X, Y, Z;
+
+        /// <summary>
+        /// String, resolved hash name, or switch case
+        /// </summary>
+        private readonly object Reference;
+
+        /// <summary>
+        /// Prefix used for hashes that weren't found in the hash table
+        /// </summary>
+        private readonly string Prefix;
+
+        /// <summary>
+        /// Gets the value as an integer
+        /// </summary>
+        public int IntValue => Bits;
+
+        /// <summary>
+        /// Gets the value as an unsigned integer
+        /// </summary>
+        public uint UIntValue => (uint)Bits;
+
+        /// <summary>
+        /// Gets the value as a float
+        /// </summary>
+        public float FloatValue => X;
+
+        /// <summary>
+        /// Gets the raw hash value
+        /// </summary>
+        public uint Hash => (uint)Bits;
+
+        /// <summary>
+        /// Gets whether or not this is a hash that was found in the hash table
+        /// </summary>
+        public bool IsResolved => Kind != ScriptOpOperandKind.Hash || Reference != null;
+
+        /// <summary>
+        /// Gets the string or hash name without decoration
+        /// </summary>
+        public string Text
+        {
+            get
+            {
+                if (Kind == ScriptOpOperandKind.Hash && Reference == null)
+                {
+                    return string.Format("{0}{1:x}", Prefix, Hash);
+                }
+
+                return Reference as string ?? "";
+            }
+        }
+
+        /// <summary>
+        /// Gets the switch case
+        /// </summary>
+        public ScriptOpSwitch SwitchCase => Reference as ScriptOpSwitch;
 
         /// <summary>
         /// Creates a Script Operand with the given value
         /// </summary>
-        public ScriptOpOperand(string val)
+        public ScriptOpOperand(int val) : this(ScriptOpOperandKind.Int32, ScriptOpOperandFormat.None)
         {
-            Value = val;
+            Bits = val;
         }
 
         /// <summary>
         /// Creates a Script Operand with the given value
         /// </summary>
-        public ScriptOpOperand(uint val)
+        public ScriptOpOperand(uint val) : this(ScriptOpOperandKind.UInt32, ScriptOpOperandFormat.None)
         {
-            Value = val;
+            Bits = (int)val;
         }
 
         /// <summary>
         /// Creates a Script Operand with the given value
         /// </summary>
-        public ScriptOpOperand(int val)
+        public ScriptOpOperand(float val) : this(ScriptOpOperandKind.Float, ScriptOpOperandFormat.None)
         {
-            Value = val;
+            X = val;
         }
 
         /// <summary>
         /// Creates a Script Operand with the given value
         /// </summary>
-        public ScriptOpOperand(float val)
+        public ScriptOpOperand(float x, float y, float z, ScriptOpOperandFormat format = ScriptOpOperandFormat.None) : this(ScriptOpOperandKind.Vector, format)
         {
-            Value = val;
+            X = x;
+            Y = y;
+            Z = z;
         }
 
         /// <summary>
         /// Creates a Script Operand with the given value
         /// </summary>
-        public ScriptOpOperand(float x, float y, float z)
+        public ScriptOpOperand(string val, ScriptOpOperandFormat format = ScriptOpOperandFormat.None) : this(ScriptOpOperandKind.String, format)
         {
-            Value = new Vector3(x, y, z);
+            Reference = val;
+        }
+
+        /// <summary>
+        /// Creates a Script Operand with the given hash and the name it resolved to, null if it wasn't found
+        /// </summary>
+        public ScriptOpOperand(uint hash, string name, string prefix, ScriptOpOperandFormat format = ScriptOpOperandFormat.None) : this(ScriptOpOperandKind.Hash, format)
+        {
+            Bits = (int)hash;
+            Reference = name;
+            Prefix = prefix;
         }
 
         /// <summary>
         /// Creates a Script Operand with the given value
         /// </summary>
-        public ScriptOpOperand(string caseValue, int byteCodeOffset)
+        public ScriptOpOperand(ScriptOpSwitch switchCase) : this(ScriptOpOperandKind.Switch, ScriptOpOperandFormat.None)
+        {
+            Reference = switchCase;
+        }
+
+        /// <summary>
+        /// Creates an empty Script Operand of the given kind
+        /// </summary>
+        private ScriptOpOperand(ScriptOpOperandKind kind, ScriptOpOperandFormat format)
         {
-            Value = new ScriptOpSwitch()
+            Kind = kind;
+            Format = format;
+            Bits = 0;
+            X = 0;
+            Y = 0;
+            Z = 0;
+            Reference = null;
+            Prefix = null;
+        }
+
+        /// <summary>
+        /// Writes the formatted operand to the writer
+        /// </summary>
+        public void Write(TextWriter writer)
+        {
+            switch (Kind)
             {
-                CaseValue = caseValue,
-                ByteCodeOffset = byteCodeOffset
-            };
+                case ScriptOpOperandKind.Int32:
+                    writer.Write(Bits);
+                    break;
+                case ScriptOpOperandKind.UInt32:
+                    writer.Write((uint)Bits);
+                    break;
+                case ScriptOpOperandKind.Float:
+                    writer.Write(X);
+                    break;
+                case ScriptOpOperandKind.Vector:
+                    writer.Write(Format == ScriptOpOperandFormat.Parenthesized ? "(" : " ");
+                    writer.Write(X);
+                    writer.Write(", ");
+                    writer.Write(Y);
+                    writer.Write(", ");
+                    writer.Write(Z);
+                    if (Format == ScriptOpOperandFormat.Parenthesized)
+                        writer.Write(")");
+                    break;
+                case ScriptOpOperandKind.Switch:
+                    writer.Write(Reference);
+                    break;
+                default:
+                    switch (Format)
+                    {
+                        case ScriptOpOperandFormat.Quoted: writer.Write("\""); break;
+                        case ScriptOpOperandFormat.LocalizedString: writer.Write("&\""); break;
+                        case ScriptOpOperandFormat.Animation: writer.Write("%"); break;
+                        case ScriptOpOperandFormat.Reference: writer.Write("&"); break;
+                    }
+
+                    if (Kind == ScriptOpOperandKind.Hash && Reference == null)
+                    {
+                        writer.Write(Prefix);
+                        writer.Write(Hash.ToString("x"));
+                    }
+                    else
+                    {
+                        writer.Write((string)Reference);
+                    }
+
+                    if (Format == ScriptOpOperandFormat.Quoted || Format == ScriptOpOperandFormat.LocalizedString)
+                        writer.Write("\"");
+                    break;
+            }
         }
 
-        public ScriptOpOperand(object value)
+        /// <summary>
+        /// Gets the formatted operand
+        /// </summary>
+        public override string ToString()
         {
-            Value = value;
+            switch (Kind)
+            {
+                case ScriptOpOperandKind.Int32:
+                    return Bits.ToString();
+                case ScriptOpOperandKind.UInt32:
+                    return ((uint)Bits).ToString();
+                case ScriptOpOperandKind.Float:
+                    return X.ToString();
+                case ScriptOpOperandKind.Switch:
+                    return Reference?.ToString() ?? "";
+                case ScriptOpOperandKind.Hash:
+                case ScriptOpOperandKind.String:
+                    // Undecorated names are the common case, no need to copy them
+                    if (Format == ScriptOpOperandFormat.None)
+                        return Text;
+                    break;
+            }
+
+            var writer = new StringWriter();
+            Write(writer);
+            return writer.ToString();
         }
     }
 }
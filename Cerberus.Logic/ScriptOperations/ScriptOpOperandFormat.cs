@@ -0,0 +1,44 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Cerberus.Logic
+{
+    /// <summary>
+    /// Script Operand Formats, how the value is decorated when it's written
+    /// </summary>
+    public enum ScriptOpOperandFormat : byte
+    {
+        /// <summary>
+        /// Written as is
+        /// </summary>
+        None,
+
+        /// <summary>
+        /// Written as "value"
+        /// </summary>
+        Quoted,
+
+        /// <summary>
+        /// Written as &amp;"value"
+        /// </summary>
+        LocalizedString,
+
+        /// <summary>
+        /// Written as %value
+        /// </summary>
+        Animation,
+
+        /// <summary>
+        /// Written as &amp;value
+        /// </summary>
+        Reference,
+
+        /// <summary>
+        /// Vectors written as (x, y, z)
+        /// </summary>
+        Parenthesized,
+    }
+}
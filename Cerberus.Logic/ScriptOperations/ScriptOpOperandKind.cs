@@ -0,0 +1,22 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Cerberus.Logic
+{
+    /// <summary>
+    /// Script Operand Value Kinds
+    /// </summary>
+    public enum ScriptOpOperandKind : byte
+    {
+        Int32,
+        UInt32,
+        Float,
+        Vector,
+        Hash,
+        String,
+        Switch,
+    }
+}
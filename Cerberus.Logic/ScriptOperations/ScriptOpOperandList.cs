@@ -0,0 +1,79 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Cerberus.Logic
+{
+    /// <summary>
+    /// A struct to view an operation's run of operands in the pool
+    /// </summary>
+    public struct ScriptOpOperandList
+    {
+        /// <summary>
+        /// Pool the operands are stored in
+        /// </summary>
+        private readonly ScriptOpOperandPool Pool;
+
+        /// <summary>
+        /// Index of the first operand in the pool
+        /// </summary>
+        private readonly int Start;
+
+        /// <summary>
+        /// Gets the number of operands
+        /// </summary>
+        public int Count { get; }
+
+        /// <summary>
+        /// Initializes a view of the given run of operands
+        /// </summary>
+        public ScriptOpOperandList(ScriptOpOperandPool pool, int start, int count)
+        {
+            Pool = pool;
+            Start = start;
+            Count = count;
+        }
+
+        /// <summary>
+        /// Gets the operand at the given index
+        /// </summary>
+        public ScriptOpOperand this[int index]
+        {
+            get
+            {
+                if ((uint)index >= (uint)Count)
+                {
+                    throw new ArgumentOutOfRangeException(nameof(index));
+                }
+
+                return Pool[Start + index];
+            }
+        }
+
+        /// <summary>
+        /// Gets an enumerator over the operands, a struct so foreach doesn't allocate
+        /// </summary>
+        public Enumerator GetEnumerator() => new Enumerator(this);
+
+        /// <summary>
+        /// Operand Enumerator
+        /// </summary>
+        public struct Enumerator
+        {
+            private readonly ScriptOpOperandList List;
+            private int Index;
+
+            public Enumerator(ScriptOpOperandList list)
+            {
+                List = list;
+                Index = -1;
+            }
+
+            public ScriptOpOperand Current => List[Index];
+
+            public bool MoveNext() => ++Index < List.Count;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Cerberus.Logic
+{
+    /// <summary>
+    /// A class to hold the operands of every operation in a script in one flat array,
+    /// operations refer to a run of it by start and count
+    /// </summary>
+    public class ScriptOpOperandPool
+    {
+        /// <summary>
+        /// Operands
+        /// </summary>
+        private ScriptOpOperand[] Items;
+
+        /// <summary>
+        /// Gets the number of operands in the pool
+        /// </summary>
+        public int Count { get; private set; }
+
+        /// <summary>
+        /// Initializes an instance of the Script Operand Pool with the given capacity
+        /// </summary>
+        public ScriptOpOperandPool(int capacity = 1024)
+        {
+            Items = new ScriptOpOperand[Math.Max(capacity, 16)];
+        }
+
+        /// <summary>
+        /// Gets the operand at the given index
+        /// </summary>
+        public ScriptOpOperand this[int index] => Items[index];
+
+        /// <summary>
+        /// Adds an operand to the pool
+        /// </summary>
+        /// <returns>Index of the operand</returns>
+        public int Add(ScriptOpOperand operand)
+        {
+            if (Count == Items.Length)
+            {
+                Array.Resize(ref Items, Items.Length * 2);
+            }
+
+            Items[Count] = operand;
+            return Count++;
+        }
+    }
+}
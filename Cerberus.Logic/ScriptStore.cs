@@ -0,0 +1,327 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+using System.Text;
+
+namespace Cerberus.Logic
+{
+    /// <summary>
+    /// A class to store extracted scripts by content
+    ///
+    /// Many zones embed the same shared scripts, each unique payload is stored once under its
+    /// hash and a manifest records which zone had which script name with which hash. Hashes that
+    /// have been decompiled are also recorded so later runs can skip them, keyed on the content
+    /// and the configuration it was decompiled with so new hash tables, options or a new build
+    /// of the decompiler process it again
+    /// </summary>
+    public class ScriptStore
+    {
+        /// <summary>
+        /// Gets the root directory of the store
+        /// </summary>
+        public string Directory { get; private set; }
+
+        /// <summary>
+        /// Gets the path of the manifest, each record is zone,name,hash, fields with commas,
+        /// quotes or line breaks are quoted with quotes doubled as in RFC 4180
+        /// </summary>
+        public string ManifestPath => Path.Combine(Directory, "manifest.csv");
+
+        /// <summary>
+        /// Gets the digest of the configuration scripts are processed with
+        /// </summary>
+        public string Configuration { get; private set; }
+
+        /// <summary>
+        /// Gets the path of the list of processed hashes, each line is hash:configuration
+        /// </summary>
+        public string ProcessedPath => Path.Combine(Directory, "processed.txt");
+
+        /// <summary>
+        /// Zone and script name to content hash
+        /// </summary>
+        private readonly Dictionary<string, string> Manifest = new Dictionary<string, string>(StringComparer.OrdinalIgnoreCase);
+
+        /// <summary>
+        /// Content hashes and configurations that have been processed
+        /// </summary>
+        private readonly HashSet<string> Processed = new HashSet<string>();
+
+        /// <summary>
+        /// Initializes an instance of the Script Store at the given directory, loading any existing manifest
+        /// </summary>
+        /// <param name="directory">Root directory of the store</param>
+        /// <param name="configuration">Digest of the configuration scripts are processed with, see <see cref="ComputeConfiguration"/></param>
+        public ScriptStore(string directory, string configuration)
+        {
+            Directory = directory;
+            Configuration = configuration;
+            System.IO.Directory.CreateDirectory(Path.Combine(Directory, "Objects"));
+
+            if (File.Exists(ManifestPath))
+            {
+                foreach (var record in ReadRecords(File.ReadAllText(ManifestPath)))
+                {
+                    if (record.Count == 3)
+                    {
+                        Manifest[GetKey(record[0], record[1])] = record[2];
+                    }
+                }
+            }
+
+            if (File.Exists(ProcessedPath))
+            {
+                foreach (var line in File.ReadLines(ProcessedPath))
+                {
+                    if (!string.IsNullOrWhiteSpace(line))
+                    {
+                        Processed.Add(line.Trim());
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// Computes the content hash of the given data
+        /// </summary>
+        public static string ComputeHash(byte[] data)
+        {
+            using (var sha1 = SHA1.Create())
+            {
+                var hash = sha1.ComputeHash(data);
+                var result = new StringBuilder(hash.Length * 2);
+
+                foreach (var b in hash)
+                {
+                    result.Append(b.ToString("x2"));
+                }
+
+                return result.ToString();
+            }
+        }
+
+        /// <summary>
+        /// Computes the digest of the configuration scripts are processed with, from the build of the
+        /// decompiler, the hash tables and any options that change the output
+        /// </summary>
+        public static string ComputeConfiguration(Dictionary<string, Dictionary<uint, string>> hashTables, params string[] options)
+        {
+            var result = new StringBuilder();
+
+            result.Append(typeof(ScriptStore).Assembly.ManifestModule.ModuleVersionId.ToString("N")).Append('\n');
+
+            foreach (var option in options)
+            {
+                result.Append(option).Append('\n');
+            }
+
+            foreach (var hashTable in hashTables.OrderBy(x => x.Key, StringComparer.Ordinal))
+            {
+                result.Append(hashTable.Key).Append('\n');
+
+                foreach (var entry in hashTable.Value.OrderBy(x => x.Key))
+                {
+                    result.Append(entry.Key.ToString("x")).Append(',').Append(entry.Value).Append('\n');
+                }
+            }
+
+            return ComputeHash(Encoding.UTF8.GetBytes(result.ToString()));
+        }
+
+        /// <summary>
+        /// Gets the path the given content is stored at
+        /// </summary>
+        public string GetObjectPath(string hash, string extension)
+        {
+            return Path.Combine(Directory, "Objects", hash.Substring(0, 2), hash + extension);
+        }
+
+        /// <summary>
+        /// Gets the hash of the script that was extracted from the zone, null if it hasn't been
+        /// </summary>
+        public string GetHash(string zone, string name)
+        {
+            lock (Manifest)
+            {
+                return Manifest.TryGetValue(GetKey(zone, name), out var hash) ? hash : null;
+            }
+        }
+
+        /// <summary>
+        /// Adds the script to the store and records it in the manifest
+        /// </summary>
+        /// <param name="zone">Zone/Fast File the script was extracted from</param>
+        /// <param name="name">Name of the script</param>
+        /// <param name="data">Script data</param>
+        /// <param name="objectPath">Path the content is stored at</param>
+        /// <returns>True if this content still needs processing, false if it was already processed</returns>
+        public bool Add(string zone, string name, byte[] data, out string objectPath)
+        {
+            var hash = ComputeHash(data);
+
+            // Names are the source names, the data is compiled
+            objectPath = GetObjectPath(hash, Path.GetExtension(name) + "c");
+
+            if (!File.Exists(objectPath))
+            {
+                WriteObject(objectPath, data);
+            }
+
+            lock (Manifest)
+            {
+                var key = GetKey(zone, name);
+
+                if (!Manifest.TryGetValue(key, out var existing) || existing != hash)
+                {
+                    Manifest[key] = hash;
+                    File.AppendAllText(ManifestPath, Escape(zone) + "," + Escape(name) + "," + hash + "\n");
+                }
+            }
+
+            return !IsProcessed(hash);
+        }
+
+        /// <summary>
+        /// Writes the content to the object path
+        /// </summary>
+        private static void WriteObject(string objectPath, byte[] data)
+        {
+            // Write to a unique temporary file first so an interrupted run never leaves a partial
+            // object and other writers, in this process or another, never share our temporary file
+            var tempPath = objectPath + "." + Guid.NewGuid().ToString("N") + ".tmp";
+
+            try
+            {
+                System.IO.Directory.CreateDirectory(Path.GetDirectoryName(objectPath));
+                File.WriteAllBytes(tempPath, data);
+
+                try
+                {
+                    File.Move(tempPath, objectPath);
+                }
+                catch (IOException) when (File.Exists(objectPath))
+                {
+                    // Another writer beat us to it, objects are named by content so it's the same data
+                }
+            }
+            finally
+            {
+                if (File.Exists(tempPath))
+                {
+                    File.Delete(tempPath);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the manifest key of the script
+        /// </summary>
+        private static string GetKey(string zone, string name) => zone + "\0" + name;
+
+        /// <summary>
+        /// Quotes the field if it contains a comma, quote or line break
+        /// </summary>
+        private static string Escape(string field)
+        {
+            if (field.IndexOfAny(SpecialCharacters) < 0)
+            {
+                return field;
+            }
+
+            return "\"" + field.Replace("\"", "\"\"") + "\"";
+        }
+
+        /// <summary>
+        /// Characters that require a field to be quoted
+        /// </summary>
+        private static readonly char[] SpecialCharacters = { ',', '"', '\r', '\n' };
+
+        /// <summary>
+        /// Reads the records of the CSV text, handling quoted fields
+        /// </summary>
+        private static IEnumerable<List<string>> ReadRecords(string text)
+        {
+            var record = new List<string>();
+            var field = new StringBuilder();
+            var quoted = false;
+
+            for (int i = 0; i < text.Length; i++)
+            {
+                var c = text[i];
+
+                if (quoted)
+                {
+                    if (c != '"')
+                    {
+                        field.Append(c);
+                    }
+                    else if (i + 1 < text.Length && text[i + 1] == '"')
+                    {
+                        field.Append('"');
+                        i++;
+                    }
+                    else
+                    {
+                        quoted = false;
+                    }
+                }
+                else if (c == '"')
+                {
+                    quoted = true;
+                }
+                else if (c == ',')
+                {
+                    record.Add(field.ToString());
+                    field.Clear();
+                }
+                else if (c == '\n')
+                {
+                    record.Add(field.ToString());
+                    field.Clear();
+                    yield return record;
+                    record = new List<string>();
+                }
+                else if (c != '\r')
+                {
+                    field.Append(c);
+                }
+            }
+
+            // Last record may be missing its line break
+            if (field.Length > 0 || record.Count > 0)
+            {
+                record.Add(field.ToString());
+                yield return record;
+            }
+        }
+
+        /// <summary>
+        /// Checks if the content has been processed with the current configuration
+        /// </summary>
+        public bool IsProcessed(string hash)
+        {
+            lock (Processed)
+            {
+                return Processed.Contains(hash + ":" + Configuration);
+            }
+        }
+
+        /// <summary>
+        /// Marks the content as processed with the current configuration
+        /// </summary>
+        public void MarkProcessed(string hash)
+        {
+            var key = hash + ":" + Configuration;
+
+            lock (Processed)
+            {
+                if (Processed.Add(key))
+                {
+                    File.AppendAllText(ProcessedPath, key + "\n");
+                }
+            }
+        }
+    }
+}
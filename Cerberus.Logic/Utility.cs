@@ -55,6 +55,28 @@ namespace Cerberus.Logic
             return count + 1;
         }
 
+        /// <summary>
+        /// Hex digits for formatting
+        /// </summary>
+        private const string HexDigits = "0123456789ABCDEF";
+
+        /// <summary>
+        /// Writes the value as upper case hex with at least the given number of digits without allocating
+        /// </summary>
+        public static void WriteHex(TextWriter writer, uint value, int minDigits, char[] buffer)
+        {
+            int index = buffer.Length;
+
+            do
+            {
+                buffer[--index] = HexDigits[(int)(value & 0xF)];
+                value >>= 4;
+            }
+            while (value != 0 || buffer.Length - index < minDigits);
+
+            writer.Write(buffer, index, buffer.Length - index);
+        }
+
         public static string SanitiseString(string value) => value.Replace("/", "\\").Replace("\b", "\\b");
     }
 }
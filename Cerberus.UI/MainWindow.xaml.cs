@@ -198,7 +198,7 @@ namespace Cerberus.UI
 
                     // Dump it
                     LogIt("Disassembling script..");
-                    File.WriteAllText(outputPath + ".script_asm" + System.IO.Path.GetExtension(outputPath), script.Disassemble());
+                    script.DisassembleToFile(outputPath + ".script_asm" + System.IO.Path.GetExtension(outputPath));
                     LogIt("Decompiling script..");
                     File.WriteAllText(outputPath + ".decompiled" + System.IO.Path.GetExtension(outputPath), script.Decompile());
                     LogIt("Dumping Hash Table..");
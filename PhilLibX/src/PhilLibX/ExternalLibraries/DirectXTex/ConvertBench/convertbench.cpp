@@ -0,0 +1,260 @@
+//--------------------------------------------------------------------------------------
+// File: ConvertBench.cpp
+//
+// Checks each direct conversion kernel against the generic load/convert/store path
+// and times both
+//
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//--------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+
+#include "DirectXTexP.h"
+
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+namespace
+{
+    // Odd so the scalar tails of the SIMD loops are covered
+    const size_t c_Width = 4093;
+    const size_t c_Height = 64;
+    const size_t c_Iterations = 20;
+
+    struct SValue
+    {
+        LPCWSTR pName;
+        DWORD dwValue;
+    };
+
+#define DEFFMT(fmt) { L#fmt, DXGI_FORMAT_ ## fmt }
+
+    const SValue g_pFormats[] =
+    {
+        DEFFMT(R32G32B32A32_FLOAT),
+        DEFFMT(R16G16B16A16_FLOAT),
+        DEFFMT(R8G8B8A8_UNORM),
+        DEFFMT(R8G8B8A8_UNORM_SRGB),
+        DEFFMT(B8G8R8A8_UNORM),
+        DEFFMT(B8G8R8A8_UNORM_SRGB),
+        DEFFMT(R32_FLOAT),
+        DEFFMT(R16_FLOAT),
+        { nullptr, 0 }
+    };
+
+#undef DEFFMT
+
+    void PrintFormat(DXGI_FORMAT format)
+    {
+        for (const SValue *pFormat = g_pFormats; pFormat->pName; pFormat++)
+        {
+            if (static_cast<DXGI_FORMAT>(pFormat->dwValue) == format)
+            {
+                wprintf(L"%-22ls", pFormat->pName);
+                return;
+            }
+        }
+
+        wprintf(L"%-22u", static_cast<unsigned>(format));
+    }
+
+    //----------------------------------------------------------------------------------
+    // Fills the image with random data, float formats get finite values either side
+    // of the half range so the clamps are covered, NaNs are left out as the paths
+    // are free to order their min/max differently
+    //----------------------------------------------------------------------------------
+    void FillImage(const Image& image, std::mt19937& rng)
+    {
+        std::uniform_int_distribution<unsigned> bytes(0, 0xFFFF);
+        std::uniform_real_distribution<float> small(-1.5f, 1.5f);
+        std::uniform_real_distribution<float> large(-70000.f, 70000.f);
+
+        size_t bpp = BitsPerPixel(image.format);
+        bool isFloat = (_GetConvertFlags(image.format) & CONVF_FLOAT) != 0;
+
+        for (size_t y = 0; y < image.height; ++y)
+        {
+            uint8_t* pRow = image.pixels + y * image.rowPitch;
+
+            if (isFloat && (bpp % 32) == 0)
+            {
+                auto pValues = reinterpret_cast<float*>(pRow);
+                for (size_t i = 0; i < image.width * bpp / 32; ++i)
+                    pValues[i] = (i & 1) ? large(rng) : small(rng);
+            }
+            else if (isFloat && (bpp % 16) == 0)
+            {
+                auto pValues = reinterpret_cast<HALF*>(pRow);
+                for (size_t i = 0; i < image.width * bpp / 16; ++i)
+                {
+                    auto value = static_cast<HALF>(bytes(rng));
+                    // All ones exponent is Inf/NaN
+                    if ((value & 0x7C00) == 0x7C00)
+                        value &= 0xBFFF;
+                    pValues[i] = value;
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < image.rowPitch; ++i)
+                    pRow[i] = static_cast<uint8_t>(bytes(rng));
+            }
+        }
+    }
+
+    //----------------------------------------------------------------------------------
+    // Converts the image the way ConvertCustom does without dithering
+    //----------------------------------------------------------------------------------
+    bool ConvertGeneric(const Image& srcImage, const Image& destImage, XMVECTOR* scanline)
+    {
+        for (size_t y = 0; y < srcImage.height; ++y)
+        {
+            const uint8_t* pSrc = srcImage.pixels + y * srcImage.rowPitch;
+            uint8_t* pDest = destImage.pixels + y * destImage.rowPitch;
+
+            if (!_LoadScanline(scanline, srcImage.width, pSrc, srcImage.rowPitch, srcImage.format))
+                return false;
+
+            _ConvertScanline(scanline, srcImage.width, destImage.format, srcImage.format, TEX_FILTER_DEFAULT);
+
+            if (!_StoreScanline(pDest, destImage.rowPitch, destImage.format, scanline, srcImage.width, 0.f))
+                return false;
+        }
+
+        return true;
+    }
+
+    void ConvertDirect(const Image& srcImage, const Image& destImage, FastConvertFunc func)
+    {
+        for (size_t y = 0; y < srcImage.height; ++y)
+        {
+            func(destImage.pixels + y * destImage.rowPitch, srcImage.pixels + y * srcImage.rowPitch, srcImage.width);
+        }
+    }
+
+    //----------------------------------------------------------------------------------
+    // Returns the index of the first pixel that differs, or SIZE_MAX if they match
+    //----------------------------------------------------------------------------------
+    size_t Compare(const Image& a, const Image& b)
+    {
+        size_t pixelSize = BitsPerPixel(a.format) / 8;
+
+        for (size_t y = 0; y < a.height; ++y)
+        {
+            const uint8_t* pA = a.pixels + y * a.rowPitch;
+            const uint8_t* pB = b.pixels + y * b.rowPitch;
+
+            for (size_t x = 0; x < a.width; ++x)
+            {
+                if (memcmp(pA + x * pixelSize, pB + x * pixelSize, pixelSize) != 0)
+                    return y * a.width + x;
+            }
+        }
+
+        return SIZE_MAX;
+    }
+
+    template<typename TFunc>
+    double MeasurePixelsPerSecond(size_t pixels, TFunc func)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (size_t i = 0; i < c_Iterations; ++i)
+            func();
+
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        return static_cast<double>(pixels * c_Iterations) / elapsed.count();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry-point
+//--------------------------------------------------------------------------------------
+int __cdecl main()
+{
+    std::mt19937 rng(0x5EED);
+
+    ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(sizeof(XMVECTOR) * c_Width, 16)));
+    if (!scanline)
+    {
+        wprintf(L"ERROR: Out of memory\n");
+        return 1;
+    }
+
+    wprintf(L"%-22ls %-22ls %10ls %10ls %8ls  %ls\n", L"Source", L"Target", L"Direct", L"Generic", L"Speedup", L"Result");
+    wprintf(L"%-22ls %-22ls %10ls %10ls\n", L"", L"", L"(MP/s)", L"(MP/s)");
+
+    int pairs = 0;
+    int failures = 0;
+
+    // Walk every pair so any kernel added to the table is checked without touching this tool
+    for (UINT s = 1; s <= DXGI_FORMAT_B4G4R4A4_UNORM; ++s)
+    {
+        for (UINT t = 1; t <= DXGI_FORMAT_B4G4R4A4_UNORM; ++t)
+        {
+            auto sformat = static_cast<DXGI_FORMAT>(s);
+            auto tformat = static_cast<DXGI_FORMAT>(t);
+
+            FastConvertFunc func = _GetFastConversion(TEX_FILTER_DEFAULT, sformat, tformat);
+            if (!func)
+                continue;
+
+            ++pairs;
+
+            ScratchImage source, direct, generic;
+            if (FAILED(source.Initialize2D(sformat, c_Width, c_Height, 1, 1))
+                || FAILED(direct.Initialize2D(tformat, c_Width, c_Height, 1, 1))
+                || FAILED(generic.Initialize2D(tformat, c_Width, c_Height, 1, 1)))
+            {
+                wprintf(L"ERROR: Out of memory\n");
+                return 1;
+            }
+
+            const Image& srcImage = *source.GetImage(0, 0, 0);
+            const Image& directImage = *direct.GetImage(0, 0, 0);
+            const Image& genericImage = *generic.GetImage(0, 0, 0);
+
+            FillImage(srcImage, rng);
+
+            PrintFormat(sformat);
+            wprintf(L" ");
+            PrintFormat(tformat);
+
+            ConvertDirect(srcImage, directImage, func);
+            if (!ConvertGeneric(srcImage, genericImage, scanline.get()))
+            {
+                wprintf(L" generic path failed\n");
+                ++failures;
+                continue;
+            }
+
+            size_t mismatch = Compare(directImage, genericImage);
+
+            double directRate = MeasurePixelsPerSecond(c_Width * c_Height, [&]() { ConvertDirect(srcImage, directImage, func); });
+            double genericRate = MeasurePixelsPerSecond(c_Width * c_Height, [&]() { ConvertGeneric(srcImage, genericImage, scanline.get()); });
+
+            wprintf(L" %10.1f %10.1f %7.2fx  ", directRate / 1000000.0, genericRate / 1000000.0, directRate / genericRate);
+
+            if (mismatch == SIZE_MAX)
+            {
+                wprintf(L"OK\n");
+            }
+            else
+            {
+                wprintf(L"MISMATCH at pixel %zu\n", mismatch);
+                ++failures;
+            }
+        }
+    }
+
+    wprintf(L"\n%d pairs, %d failed\n", pairs, failures);
+
+    return failures;
+}
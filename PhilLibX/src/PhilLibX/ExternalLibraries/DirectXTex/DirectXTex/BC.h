@@ -36,6 +36,7 @@ enum BC_FLAGS
     BC_FLAGS_UNIFORM            = 0x40000,  // By default, uses perceptual weighting for BC1-3; this flag makes it a uniform weighting
     BC_FLAGS_USE_3SUBSETS       = 0x80000,  // By default, BC7 skips mode 0 & 2; this flag adds those modes back
     BC_FLAGS_FORCE_BC7_MODE6    = 0x100000, // BC7 should only use mode 6; skip other modes
+    BC_FLAGS_FAST               = 0x200000, // BC6H/BC7 refine only the best partition; BC7 uses modes 1, 4, 6 & 7 and stops at a small error
 };
 
 //-------------------------------------------------------------------------------------
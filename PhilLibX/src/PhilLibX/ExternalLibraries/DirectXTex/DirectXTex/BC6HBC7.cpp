@@ -660,7 +660,7 @@ namespace
     {
     public:
         void Decode(_In_ bool bSigned, _Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const;
-        void Encode(_In_ bool bSigned, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn);
+        void Encode(_In_ DWORD flags, _In_ bool bSigned, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn);
 
     private:
 #pragma warning(push)
@@ -1808,7 +1808,7 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const
 
 
 _Use_decl_annotations_
-void D3DX_BC6H::Encode(bool bSigned, const HDRColorA* const pIn)
+void D3DX_BC6H::Encode(DWORD flags, bool bSigned, const HDRColorA* const pIn)
 {
     assert(pIn);
 
@@ -1819,7 +1819,7 @@ void D3DX_BC6H::Encode(bool bSigned, const HDRColorA* const pIn)
         const uint8_t uShapes = ms_aInfo[EP.uMode].uPartitions ? 32 : 1;
         // Number of rough cases to look at. reasonable values of this are 1, uShapes/4, and uShapes
         // uShapes/4 gets nearly all the cases; you can increase that a bit (say by 3 or 4) if you really want to squeeze the last bit out
-        const size_t uItems = std::max<size_t>(1, uShapes >> 2);
+        const size_t uItems = (flags & BC_FLAGS_FAST) ? 1 : std::max<size_t>(1, uShapes >> 2);
         float afRoughMSE[BC6H_MAX_SHAPES];
         uint8_t auShape[BC6H_MAX_SHAPES];
 
@@ -2748,9 +2748,18 @@ void D3DX_BC7::Encode(DWORD flags, const HDRColorA* const pIn)
     }
 
     const bool bHasAlpha = (alphaMask != 0xFF);
+    const bool bFast = (flags & BC_FLAGS_FAST) != 0;
+    // Fast mode stops once the block averages under 1 squared unit of error per channel
+    const float fMSEThreshold = bFast ? float(NUM_PIXELS_PER_BLOCK * 4) : 0.0f;
 
-    for (EP.uMode = 0; EP.uMode < 8 && fMSEBest > 0; ++EP.uMode)
+    for (EP.uMode = 0; EP.uMode < 8 && fMSEBest > fMSEThreshold; ++EP.uMode)
     {
+        if (bFast && (EP.uMode == 0 || EP.uMode == 2 || EP.uMode == 3 || EP.uMode == 5))
+        {
+            // Modes 1, 4, 6 & 7 cover the common cases, the rest mostly trade time for small gains
+            continue;
+        }
+
         if (!(flags & BC_FLAGS_USE_3SUBSETS) && (EP.uMode == 0 || EP.uMode == 2))
         {
             // 3 subset modes tend to be used rarely and add significant compression time
@@ -2773,15 +2782,15 @@ void D3DX_BC7::Encode(DWORD flags, const HDRColorA* const pIn)
         assert(uShapes <= BC7_MAX_SHAPES);
         _Analysis_assume_(uShapes <= BC7_MAX_SHAPES);
 
-        const size_t uNumRots = size_t(1) << ms_aInfo[EP.uMode].uRotationBits;
-        const size_t uNumIdxMode = size_t(1) << ms_aInfo[EP.uMode].uIndexModeBits;
+        const size_t uNumRots = bFast ? 1 : size_t(1) << ms_aInfo[EP.uMode].uRotationBits;
+        const size_t uNumIdxMode = bFast ? 1 : size_t(1) << ms_aInfo[EP.uMode].uIndexModeBits;
         // Number of rough cases to look at. reasonable values of this are 1, uShapes/4, and uShapes
         // uShapes/4 gets nearly all the cases; you can increase that a bit (say by 3 or 4) if you really want to squeeze the last bit out
-        const size_t uItems = std::max<size_t>(1, uShapes >> 2);
+        const size_t uItems = bFast ? 1 : std::max<size_t>(1, uShapes >> 2);
         float afRoughMSE[BC7_MAX_SHAPES];
         size_t auShape[BC7_MAX_SHAPES];
 
-        for (size_t r = 0; r < uNumRots && fMSEBest > 0; ++r)
+        for (size_t r = 0; r < uNumRots && fMSEBest > fMSEThreshold; ++r)
         {
             switch (r)
             {
@@ -2790,7 +2799,7 @@ void D3DX_BC7::Encode(DWORD flags, const HDRColorA* const pIn)
             case 3: for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; i++) std::swap(EP.aLDRPixels[i].b, EP.aLDRPixels[i].a); break;
             }
 
-            for (size_t im = 0; im < uNumIdxMode && fMSEBest > 0; ++im)
+            for (size_t im = 0; im < uNumIdxMode && fMSEBest > fMSEThreshold; ++im)
             {
                 // pick the best uItems shapes and refine these.
                 for (size_t s = 0; s < uShapes; s++)
@@ -2812,7 +2821,7 @@ void D3DX_BC7::Encode(DWORD flags, const HDRColorA* const pIn)
                     }
                 }
 
-                for (size_t i = 0; i < uItems && fMSEBest > 0; i++)
+                for (size_t i = 0; i < uItems && fMSEBest > fMSEThreshold; i++)
                 {
                     float fMSE = Refine(&EP, auShape[i], r, im);
                     if (fMSE < fMSEBest)
@@ -3530,19 +3539,17 @@ void DirectX::D3DXDecodeBC6HS(XMVECTOR *pColor, const uint8_t *pBC)
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HU(uint8_t *pBC, const XMVECTOR *pColor, DWORD flags)
 {
-    UNREFERENCED_PARAMETER(flags);
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(flags, false, reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HS(uint8_t *pBC, const XMVECTOR *pColor, DWORD flags)
 {
-    UNREFERENCED_PARAMETER(flags);
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(flags, true, reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 
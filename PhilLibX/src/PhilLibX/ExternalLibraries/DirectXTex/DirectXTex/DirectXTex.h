@@ -248,6 +248,15 @@ namespace DirectX
         _Out_ TexMetadata& metadata,
         _In_opt_ std::function<void __cdecl(IWICMetadataQueryReader*)> getMQR = nullptr);
 
+    //---------------------------------------------------------------------------------
+    // Pixel memory allocator used by ScratchImage, memory must be 16-byte aligned
+    // The default is _aligned_malloc/_aligned_free, each ScratchImage frees its memory with the
+    // deallocator that was set when it allocated, so changing it never mixes the two up
+    typedef void* (__cdecl *PixelAllocator)(_In_ size_t size);
+    typedef void (__cdecl *PixelDeallocator)(_In_ void* memory, _In_ size_t size);
+
+    void __cdecl SetPixelAllocator(_In_opt_ PixelAllocator allocator, _In_opt_ PixelDeallocator deallocator) noexcept;
+
     //---------------------------------------------------------------------------------
     // Bitmap image container
     struct Image
@@ -264,9 +273,9 @@ namespace DirectX
     {
     public:
         ScratchImage() noexcept
-            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr) {}
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr), m_free(nullptr) {}
         ScratchImage(ScratchImage&& moveFrom) noexcept
-            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr) { *this = std::move(moveFrom); }
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr), m_free(nullptr) { *this = std::move(moveFrom); }
         ~ScratchImage() { Release(); }
 
         ScratchImage& __cdecl operator= (ScratchImage&& moveFrom) noexcept;
@@ -307,6 +316,7 @@ namespace DirectX
         TexMetadata m_metadata;
         Image*      m_image;
         uint8_t*    m_memory;
+        PixelDeallocator m_free;
     };
 
     //---------------------------------------------------------------------------------
@@ -350,6 +360,15 @@ namespace DirectX
         _In_ DWORD flags,
         _Out_opt_ TexMetadata* metadata, _Out_ ScratchImage& image);
 
+    HRESULT __cdecl GetDDSImageLayout(
+        _In_reads_bytes_(headerSize) const void* pHeader, _In_ size_t headerSize, _In_ uint64_t fileSize,
+        _In_ DWORD flags,
+        _Out_ TexMetadata& metadata, _Out_writes_opt_(nimages) Image* images, _Out_writes_opt_(nimages) uint64_t* offsets, _Inout_ size_t& nimages);
+        // Gets the size and file offset of each image from just the start of a DDS file, so they can be read or mapped one at a time
+        // The images' pixels are left null, pass nullptr for images and offsets to get the image count
+        // Legacy formats that need converting return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED)
+        // Images that would end past fileSize return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF)
+
     HRESULT __cdecl SaveToDDSMemory(
         _In_ const Image& image,
         _In_ DWORD flags,
@@ -584,6 +603,10 @@ namespace DirectX
         TEX_COMPRESS_BC7_QUICK          = 0x100000,
             // Minimal modes (usually mode 6) for BC7 compression
 
+        TEX_COMPRESS_BC_FAST            = 0x200000,
+            // Reduced search for BC6H/BC7 compression: refines only the best partition, uses a restricted BC7 mode set
+            // without rotations/index modes, and stops searching a BC7 block once its error is below a small threshold
+
         TEX_COMPRESS_SRGB_IN            = 0x1000000,
         TEX_COMPRESS_SRGB_OUT           = 0x2000000,
         TEX_COMPRESS_SRGB               = (TEX_COMPRESS_SRGB_IN | TEX_COMPRESS_SRGB_OUT),
@@ -4559,6 +4559,228 @@ namespace
     }
 
 
+    //-------------------------------------------------------------------------------------
+    // Direct scanline kernels for common conversion pairs
+    //
+    // Each kernel produces the same output as _LoadScanline, _ConvertScanline and
+    // _StoreScanline for its pair, without the round trip through an XMVECTOR scanline
+    //-------------------------------------------------------------------------------------
+    const XMVECTORU32 g_MaskRB8 = { { { 0x00FF00FF, 0x00FF00FF, 0x00FF00FF, 0x00FF00FF } } };
+    const XMVECTORU32 g_MaskGA8 = { { { 0xFF00FF00, 0xFF00FF00, 0xFF00FF00, 0xFF00FF00 } } };
+    const XMVECTORF32 g_UNorm8Scale = { { { 1.f / 255.f, 1.f / 255.f, 1.f / 255.f, 1.f / 255.f } } };
+
+    inline uint32_t SwapRB(uint32_t t)
+    {
+        return (t & 0xFF00FF00) | ((t >> 16) & 0xFF) | ((t & 0xFF) << 16);
+    }
+
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+    inline __m128i XM_CALLCONV SwapRB(__m128i v)
+    {
+        __m128i rb = _mm_and_si128(v, g_MaskRB8);
+        __m128i ga = _mm_and_si128(v, g_MaskGA8);
+        return _mm_or_si128(ga, _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16)));
+    }
+
+    // Expands 4 UNORM8 pixels to 16 floats
+    inline void XM_CALLCONV StoreUNorm8AsFloat(float* pDestination, __m128i v)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+        _mm_storeu_ps(pDestination, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), g_UNorm8Scale));
+        _mm_storeu_ps(pDestination + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), g_UNorm8Scale));
+        _mm_storeu_ps(pDestination + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), g_UNorm8Scale));
+        _mm_storeu_ps(pDestination + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), g_UNorm8Scale));
+    }
+#endif
+
+    // R8G8B8A8 <-> B8G8R8A8
+    void ConvertSwapRB32(void* pDestination, const void* pSource, size_t count)
+    {
+        auto dPtr = static_cast<uint32_t*>(pDestination);
+        auto sPtr = static_cast<const uint32_t*>(pSource);
+        size_t i = 0;
+
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sPtr + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dPtr + i), SwapRB(v));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            dPtr[i] = SwapRB(sPtr[i]);
+        }
+    }
+
+    // R8G8B8A8_UNORM -> R32G32B32A32_FLOAT
+    void ConvertRGBA8ToFloat4(void* pDestination, const void* pSource, size_t count)
+    {
+        auto dPtr = static_cast<float*>(pDestination);
+        auto sPtr = static_cast<const uint8_t*>(pSource);
+        size_t i = 0;
+
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+        for (; i + 4 <= count; i += 4)
+        {
+            StoreUNorm8AsFloat(dPtr + i * 4, _mm_loadu_si128(reinterpret_cast<const __m128i*>(sPtr + i * 4)));
+        }
+#endif
+
+        for (i *= 4; i < count * 4; ++i)
+        {
+            dPtr[i] = static_cast<float>(sPtr[i]) * (1.f / 255.f);
+        }
+    }
+
+    // B8G8R8A8_UNORM -> R32G32B32A32_FLOAT
+    void ConvertBGRA8ToFloat4(void* pDestination, const void* pSource, size_t count)
+    {
+        auto dPtr = static_cast<float*>(pDestination);
+        auto sPtr = static_cast<const uint32_t*>(pSource);
+        size_t i = 0;
+
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+        for (; i + 4 <= count; i += 4)
+        {
+            StoreUNorm8AsFloat(dPtr + i * 4, SwapRB(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sPtr + i))));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            uint32_t t = sPtr[i];
+            dPtr[i * 4] = static_cast<float>((t >> 16) & 0xFF) * (1.f / 255.f);
+            dPtr[i * 4 + 1] = static_cast<float>((t >> 8) & 0xFF) * (1.f / 255.f);
+            dPtr[i * 4 + 2] = static_cast<float>(t & 0xFF) * (1.f / 255.f);
+            dPtr[i * 4 + 3] = static_cast<float>(t >> 24) * (1.f / 255.f);
+        }
+    }
+
+    // R16_FLOAT -> R32_FLOAT
+    void ConvertHalfToFloat(void* pDestination, const void* pSource, size_t count)
+    {
+        XMConvertHalfToFloatStream(
+            static_cast<float*>(pDestination), sizeof(float),
+            static_cast<const HALF*>(pSource), sizeof(HALF),
+            count);
+    }
+
+    // R16G16B16A16_FLOAT -> R32G32B32A32_FLOAT
+    void ConvertHalf4ToFloat4(void* pDestination, const void* pSource, size_t count)
+    {
+        ConvertHalfToFloat(pDestination, pSource, count * 4);
+    }
+
+    // R32_FLOAT -> R16_FLOAT
+    void ConvertFloatToHalf(void* pDestination, const void* pSource, size_t count)
+    {
+        auto dPtr = static_cast<HALF*>(pDestination);
+        auto sPtr = static_cast<const float*>(pSource);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float v = std::max<float>(std::min<float>(sPtr[i], 65504.f), -65504.f);
+            dPtr[i] = XMConvertFloatToHalf(v);
+        }
+    }
+
+    // R32G32B32A32_FLOAT -> R16G16B16A16_FLOAT
+    void ConvertFloat4ToHalf4(void* pDestination, const void* pSource, size_t count)
+    {
+        auto dPtr = static_cast<XMHALF4*>(pDestination);
+        auto sPtr = static_cast<const XMFLOAT4*>(pSource);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            XMVECTOR v = XMVectorClamp(XMLoadFloat4(sPtr + i), g_HalfMin, g_HalfMax);
+            XMStoreHalf4(dPtr + i, v);
+        }
+    }
+
+    struct FastConversion
+    {
+        DXGI_FORMAT     srcFormat;
+        DXGI_FORMAT     destFormat;
+        FastConvertFunc func;
+    };
+
+    const FastConversion g_FastConversions[] =
+    {
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_B8G8R8A8_UNORM,         ConvertSwapRB32 },
+        { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R8G8B8A8_UNORM,         ConvertSwapRB32 },
+        { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,  DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,    ConvertSwapRB32 },
+        { DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,  DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,    ConvertSwapRB32 },
+        { DXGI_FORMAT_R8G8B8A8_UNORM,       DXGI_FORMAT_R32G32B32A32_FLOAT,     ConvertRGBA8ToFloat4 },
+        { DXGI_FORMAT_B8G8R8A8_UNORM,       DXGI_FORMAT_R32G32B32A32_FLOAT,     ConvertBGRA8ToFloat4 },
+        { DXGI_FORMAT_R16_FLOAT,            DXGI_FORMAT_R32_FLOAT,              ConvertHalfToFloat },
+        { DXGI_FORMAT_R16G16B16A16_FLOAT,   DXGI_FORMAT_R32G32B32A32_FLOAT,     ConvertHalf4ToFloat4 },
+        { DXGI_FORMAT_R32_FLOAT,            DXGI_FORMAT_R16_FLOAT,              ConvertFloatToHalf },
+        { DXGI_FORMAT_R32G32B32A32_FLOAT,   DXGI_FORMAT_R16G16B16A16_FLOAT,     ConvertFloat4ToHalf4 },
+    };
+}
+
+
+//-------------------------------------------------------------------------------------
+// Selection logic for the direct kernels, any filter flag that changes the result
+// falls back to the generic path
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+FastConvertFunc DirectX::_GetFastConversion(
+    DWORD filter,
+    DXGI_FORMAT sformat,
+    DXGI_FORMAT tformat)
+{
+    if (filter & (TEX_FILTER_FLOAT_X2BIAS
+        | TEX_FILTER_RGB_COPY_RED | TEX_FILTER_RGB_COPY_GREEN | TEX_FILTER_RGB_COPY_BLUE
+        | TEX_FILTER_DITHER | TEX_FILTER_DITHER_DIFFUSION
+        | TEX_FILTER_SRGB | TEX_FILTER_FORCE_WIC))
+        return nullptr;
+
+    for (size_t index = 0; index < _countof(g_FastConversions); ++index)
+    {
+        if (g_FastConversions[index].srcFormat == sformat && g_FastConversions[index].destFormat == tformat)
+            return g_FastConversions[index].func;
+    }
+
+    return nullptr;
+}
+
+
+namespace
+{
+
+    //-------------------------------------------------------------------------------------
+    // Convert the source image using a direct kernel
+    //-------------------------------------------------------------------------------------
+    HRESULT ConvertFast(
+        _In_ const Image& srcImage,
+        _In_ FastConvertFunc func,
+        _In_ const Image& destImage)
+    {
+        assert(srcImage.width == destImage.width);
+        assert(srcImage.height == destImage.height);
+
+        const uint8_t *pSrc = srcImage.pixels;
+        uint8_t *pDest = destImage.pixels;
+        if (!pSrc || !pDest)
+            return E_POINTER;
+
+        for (size_t h = 0; h < srcImage.height; ++h)
+        {
+            func(pDest, pSrc, srcImage.width);
+            pSrc += srcImage.rowPitch;
+            pDest += destImage.rowPitch;
+        }
+
+        return S_OK;
+    }
+
+
     //-------------------------------------------------------------------------------------
     // Convert the source image (not using WIC)
     //-------------------------------------------------------------------------------------
@@ -4841,8 +5063,14 @@ HRESULT DirectX::Convert(
         return E_POINTER;
     }
 
+    FastConvertFunc fastConvert = _GetFastConversion(filter, srcImage.format, format);
+
     WICPixelFormatGUID pfGUID, targetGUID;
-    if (UseWICConversion(filter, srcImage.format, format, pfGUID, targetGUID))
+    if (fastConvert)
+    {
+        hr = ConvertFast(srcImage, fastConvert, *rimage);
+    }
+    else if (UseWICConversion(filter, srcImage.format, format, pfGUID, targetGUID))
     {
         hr = ConvertUsingWIC(srcImage, pfGUID, targetGUID, filter, threshold, *rimage);
     }
@@ -4905,8 +5133,10 @@ HRESULT DirectX::Convert(
         return E_POINTER;
     }
 
+    FastConvertFunc fastConvert = _GetFastConversion(filter, metadata.format, format);
+
     WICPixelFormatGUID pfGUID, targetGUID;
-    bool usewic = !metadata.IsPMAlpha() && UseWICConversion(filter, metadata.format, format, pfGUID, targetGUID);
+    bool usewic = !fastConvert && !metadata.IsPMAlpha() && UseWICConversion(filter, metadata.format, format, pfGUID, targetGUID);
 
     switch (metadata.dimension)
     {
@@ -4936,7 +5166,11 @@ HRESULT DirectX::Convert(
                 return E_FAIL;
             }
 
-            if (usewic)
+            if (fastConvert)
+            {
+                hr = ConvertFast(src, fastConvert, dst);
+            }
+            else if (usewic)
             {
                 hr = ConvertUsingWIC(src, pfGUID, targetGUID, filter, threshold, dst);
             }
@@ -4989,7 +5223,11 @@ HRESULT DirectX::Convert(
                     return E_FAIL;
                 }
 
-                if (usewic)
+                if (fastConvert)
+                {
+                    hr = ConvertFast(src, fastConvert, dst);
+                }
+                else if (usewic)
                 {
                     hr = ConvertUsingWIC(src, pfGUID, targetGUID, filter, threshold, dst);
                 }
@@ -1436,6 +1436,50 @@ namespace
 
         return S_OK;
     }
+
+    //-------------------------------------------------------------------------------------
+    // Sets the size and file offset of the next image and moves past it, only counts if
+    // no images are given, fails as soon as an image would end past the end of the file
+    //-------------------------------------------------------------------------------------
+    HRESULT AddImageLayout(
+        DXGI_FORMAT format,
+        size_t width,
+        size_t height,
+        DWORD cpFlags,
+        uint64_t fileSize,
+        uint64_t& offset,
+        _Out_writes_opt_(nimages) Image* images,
+        _Out_writes_opt_(nimages) uint64_t* offsets,
+        size_t nimages,
+        size_t& index)
+    {
+        size_t rowPitch, slicePitch;
+        HRESULT hr = ComputePitch(format, width, height, rowPitch, slicePitch, cpFlags);
+        if (FAILED(hr))
+            return hr;
+
+        // Offset never passes fileSize, so this can't overflow
+        if (uint64_t(slicePitch) > fileSize - offset)
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+
+        if (images)
+        {
+            if (index >= nimages)
+                return E_INVALIDARG;
+
+            images[index].width = width;
+            images[index].height = height;
+            images[index].format = format;
+            images[index].rowPitch = rowPitch;
+            images[index].slicePitch = slicePitch;
+            images[index].pixels = nullptr;
+            offsets[index] = offset;
+        }
+
+        offset += uint64_t(slicePitch);
+        ++index;
+        return S_OK;
+    }
 }
 
 
@@ -1588,6 +1632,115 @@ HRESULT DirectX::LoadFromDDSMemory(
 }
 
 
+//-------------------------------------------------------------------------------------
+// Get the size and file offset of each image in a DDS file from its header
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::GetDDSImageLayout(
+    const void* pHeader,
+    size_t headerSize,
+    uint64_t fileSize,
+    DWORD flags,
+    TexMetadata& metadata,
+    Image* images,
+    uint64_t* offsets,
+    size_t& nimages)
+{
+    if (!pHeader || headerSize == 0 || headerSize > fileSize)
+        return E_INVALIDARG;
+
+    if (images && !offsets)
+        return E_INVALIDARG;
+
+    DWORD convFlags = 0;
+    HRESULT hr = DecodeDDSHeader(pHeader, headerSize, flags, metadata, convFlags);
+    if (FAILED(hr))
+        return hr;
+
+    // Anything other than the header flags means the pixels have to be rewritten on load
+    if (convFlags & ~(CONV_FLAGS_DX10 | CONV_FLAGS_PMALPHA))
+        return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+    uint64_t offset = sizeof(uint32_t) + sizeof(DDS_HEADER);
+    if (convFlags & CONV_FLAGS_DX10)
+        offset += sizeof(DDS_HEADER_DXT10);
+
+    if (offset > fileSize)
+        return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+
+    DWORD cflags = CP_FLAGS_NONE;
+    if (flags & DDS_FLAGS_LEGACY_DWORD)
+    {
+        cflags |= CP_FLAGS_LEGACY_DWORD;
+    }
+    if (flags & DDS_FLAGS_BAD_DXTN_TAILS)
+    {
+        cflags |= CP_FLAGS_BAD_DXTN_TAILS;
+    }
+
+    size_t count = 0;
+
+    switch (metadata.dimension)
+    {
+    case TEX_DIMENSION_TEXTURE1D:
+    case TEX_DIMENSION_TEXTURE2D:
+        for (size_t item = 0; item < metadata.arraySize; ++item)
+        {
+            size_t w = metadata.width;
+            size_t h = metadata.height;
+
+            for (size_t level = 0; level < metadata.mipLevels; ++level)
+            {
+                hr = AddImageLayout(metadata.format, w, h, cflags, fileSize, offset, images, offsets, nimages, count);
+                if (FAILED(hr))
+                    return hr;
+
+                if (h > 1)
+                    h >>= 1;
+
+                if (w > 1)
+                    w >>= 1;
+            }
+        }
+        break;
+
+    case TEX_DIMENSION_TEXTURE3D:
+    {
+        size_t w = metadata.width;
+        size_t h = metadata.height;
+        size_t d = metadata.depth;
+
+        for (size_t level = 0; level < metadata.mipLevels; ++level)
+        {
+            // All slices of a given miplevel are continuous, same as ScratchImage
+            for (size_t slice = 0; slice < d; ++slice)
+            {
+                hr = AddImageLayout(metadata.format, w, h, cflags, fileSize, offset, images, offsets, nimages, count);
+                if (FAILED(hr))
+                    return hr;
+            }
+
+            if (h > 1)
+                h >>= 1;
+
+            if (w > 1)
+                w >>= 1;
+
+            if (d > 1)
+                d >>= 1;
+        }
+    }
+    break;
+
+    default:
+        return E_FAIL;
+    }
+
+    nimages = count;
+    return S_OK;
+}
+
+
 //-------------------------------------------------------------------------------------
 // Load a DDS file from disk
 //-------------------------------------------------------------------------------------
@@ -20,6 +20,40 @@ namespace DirectX
 
 using namespace DirectX;
 
+namespace
+{
+    void* __cdecl DefaultAllocatePixels(size_t size)
+    {
+        return _aligned_malloc(size, 16);
+    }
+
+    void __cdecl DefaultFreePixels(void* memory, size_t)
+    {
+        _aligned_free(memory);
+    }
+
+    PixelAllocator s_allocatePixels = DefaultAllocatePixels;
+    PixelDeallocator s_freePixels = DefaultFreePixels;
+}
+
+//-------------------------------------------------------------------------------------
+// Sets the allocator used for ScratchImage pixel memory, null restores the default
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+void DirectX::SetPixelAllocator(PixelAllocator allocator, PixelDeallocator deallocator) noexcept
+{
+    if (allocator && deallocator)
+    {
+        s_allocatePixels = allocator;
+        s_freePixels = deallocator;
+    }
+    else
+    {
+        s_allocatePixels = DefaultAllocatePixels;
+        s_freePixels = DefaultFreePixels;
+    }
+}
+
 //-------------------------------------------------------------------------------------
 // Determines number of image array entries and pixel size
 //-------------------------------------------------------------------------------------
@@ -268,11 +302,13 @@ ScratchImage& ScratchImage::operator= (ScratchImage&& moveFrom) noexcept
         m_metadata = moveFrom.m_metadata;
         m_image = moveFrom.m_image;
         m_memory = moveFrom.m_memory;
+        m_free = moveFrom.m_free;
 
         moveFrom.m_nimages = 0;
         moveFrom.m_size = 0;
         moveFrom.m_image = nullptr;
         moveFrom.m_memory = nullptr;
+        moveFrom.m_free = nullptr;
     }
     return *this;
 }
@@ -351,7 +387,8 @@ HRESULT ScratchImage::Initialize(const TexMetadata& mdata, DWORD flags)
     m_nimages = nimages;
     memset(m_image, 0, sizeof(Image) * nimages);
 
-    m_memory = static_cast<uint8_t*>(_aligned_malloc(pixelSize, 16));
+    m_free = s_freePixels;
+    m_memory = static_cast<uint8_t*>(s_allocatePixels(pixelSize));
     if (!m_memory)
     {
         Release();
@@ -418,7 +455,8 @@ HRESULT ScratchImage::Initialize2D(DXGI_FORMAT fmt, size_t width, size_t height,
     m_nimages = nimages;
     memset(m_image, 0, sizeof(Image) * nimages);
 
-    m_memory = static_cast<uint8_t*>(_aligned_malloc(pixelSize, 16));
+    m_free = s_freePixels;
+    m_memory = static_cast<uint8_t*>(s_allocatePixels(pixelSize));
     if (!m_memory)
     {
         Release();
@@ -471,7 +509,8 @@ HRESULT ScratchImage::Initialize3D(DXGI_FORMAT fmt, size_t width, size_t height,
     m_nimages = nimages;
     memset(m_image, 0, sizeof(Image) * nimages);
 
-    m_memory = static_cast<uint8_t*>(_aligned_malloc(pixelSize, 16));
+    m_free = s_freePixels;
+    m_memory = static_cast<uint8_t*>(s_allocatePixels(pixelSize));
     if (!m_memory)
     {
         Release();
@@ -680,7 +719,6 @@ HRESULT ScratchImage::Initialize3DFromImages(const Image* images, size_t depth,
 void ScratchImage::Release()
 {
     m_nimages = 0;
-    m_size = 0;
 
     if (m_image)
     {
@@ -690,10 +728,12 @@ void ScratchImage::Release()
 
     if (m_memory)
     {
-        _aligned_free(m_memory);
+        m_free(m_memory, m_size);
         m_memory = nullptr;
     }
 
+    m_size = 0;
+
     memset(&m_metadata, 0, sizeof(m_metadata));
 }
 
@@ -876,6 +876,49 @@ namespace
         return S_OK;
     }
 
+    //--- 2D Fast Separable Filter ---
+    HRESULT Generate2DMipsFast(size_t levels, DWORD filter, const ScratchImage& mipChain)
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        size_t items = mipChain.GetMetadata().arraySize;
+
+        std::unique_ptr<Image[]> images(new (std::nothrow) Image[items * 2]);
+        if (!images)
+            return E_OUTOFMEMORY;
+
+        Image* srcImages = images.get();
+        Image* destImages = images.get() + items;
+
+        // Each level is filtered from the one above it while it's still warm, every item at once
+        for (size_t level = 1; level < levels; ++level)
+        {
+            for (size_t item = 0; item < items; ++item)
+            {
+                const Image* src = mipChain.GetImage(level - 1, item, 0);
+                const Image* dest = mipChain.GetImage(level, item, 0);
+
+                if (!src || !dest)
+                    return E_POINTER;
+
+                srcImages[item] = *src;
+                destImages[item] = *dest;
+            }
+
+            HRESULT hr = _ResizeFast(srcImages, destImages, items, filter);
+            if (FAILED(hr))
+                return hr;
+        }
+
+        return S_OK;
+    }
+
+
     //--- 2D Point Filter ---
     HRESULT Generate2DMipsPointFilter(size_t levels, const ScratchImage& mipChain, size_t item)
     {
@@ -2791,7 +2834,8 @@ HRESULT DirectX::GenerateMipMaps(
 
     static_assert(TEX_FILTER_POINT == 0x100000, "TEX_FILTER_ flag values don't match TEX_FILTER_MASK");
 
-    bool usewic = UseWICFiltering(baseImage.format, filter);
+    bool usefast = _IsFastResizeSupported(baseImage.format, filter);
+    bool usewic = !usefast && UseWICFiltering(baseImage.format, filter);
 
     WICPixelFormatGUID pfGUID = {};
     bool wicpf = (usewic) ? _DXGIToWIC(baseImage.format, pfGUID, true) : false;
@@ -2887,6 +2931,18 @@ HRESULT DirectX::GenerateMipMaps(
         mdata.mipLevels = levels;
         mdata.format = baseImage.format;
 
+        if (usefast)
+        {
+            hr = Setup2DMips(&baseImage, 1, mdata, mipChain);
+            if (FAILED(hr))
+                return hr;
+
+            hr = Generate2DMipsFast(levels, filter, mipChain);
+            if (FAILED(hr))
+                mipChain.Release();
+            return hr;
+        }
+
         DWORD filter_select = (filter & TEX_FILTER_MASK);
         if (!filter_select)
         {
@@ -3004,7 +3060,8 @@ HRESULT DirectX::GenerateMipMaps(
 
     static_assert(TEX_FILTER_POINT == 0x100000, "TEX_FILTER_ flag values don't match TEX_FILTER_MASK");
 
-    bool usewic = !metadata.IsPMAlpha() && UseWICFiltering(metadata.format, filter);
+    bool usefast = _IsFastResizeSupported(metadata.format, filter);
+    bool usewic = !usefast && !metadata.IsPMAlpha() && UseWICFiltering(metadata.format, filter);
 
     WICPixelFormatGUID pfGUID = {};
     bool wicpf = (usewic) ? _DXGIToWIC(metadata.format, pfGUID, true) : false;
@@ -3100,6 +3157,18 @@ HRESULT DirectX::GenerateMipMaps(
         TexMetadata mdata2 = metadata;
         mdata2.mipLevels = levels;
 
+        if (usefast)
+        {
+            hr = Setup2DMips(&baseImages[0], metadata.arraySize, mdata2, mipChain);
+            if (FAILED(hr))
+                return hr;
+
+            hr = Generate2DMipsFast(levels, filter, mipChain);
+            if (FAILED(hr))
+                mipChain.Release();
+            return hr;
+        }
+
         DWORD filter_select = (filter & TEX_FILTER_MASK);
         if (!filter_select)
         {
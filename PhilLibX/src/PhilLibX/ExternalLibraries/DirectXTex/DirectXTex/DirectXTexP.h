@@ -280,6 +280,19 @@ namespace DirectX
         _Inout_updates_all_(count) XMVECTOR* pBuffer, _In_ size_t count,
         _In_ DXGI_FORMAT outFormat, _In_ DXGI_FORMAT inFormat, _In_ DWORD flags);
 
+    // Direct scanline kernel, same output as _LoadScanline, _ConvertScanline and _StoreScanline
+    typedef void(*FastConvertFunc)(void* pDestination, const void* pSource, size_t count);
+
+    FastConvertFunc __cdecl _GetFastConversion(_In_ DWORD filter, _In_ DXGI_FORMAT sformat, _In_ DXGI_FORMAT tformat);
+
+    //---------------------------------------------------------------------------------
+    // Fast separable resize functions
+    bool __cdecl _IsFastResizeSupported(_In_ DXGI_FORMAT format, _In_ DWORD filter);
+
+    HRESULT __cdecl _ResizeFast(
+        _In_reads_(nimages) const Image* srcImages, _In_reads_(nimages) const Image* destImages, _In_ size_t nimages,
+        _In_ DWORD filter);
+
     //---------------------------------------------------------------------------------
     // DDS helper functions
     HRESULT __cdecl _EncodeDDSHeader(
@@ -14,6 +14,7 @@
 #include "filters.h"
 
 using namespace DirectX;
+using namespace DirectX::PackedVector;
 using Microsoft::WRL::ComPtr;
 
 namespace DirectX
@@ -829,6 +830,504 @@ namespace
 }
 
 
+namespace
+{
+    //-------------------------------------------------------------------------------------
+    // Fast separable resize helpers
+    //
+    // Each axis is filtered separately with precomputed taps, rows are converted to float
+    // once per band and work is split across bands of rows and across images
+    //-------------------------------------------------------------------------------------
+    const size_t FAST_RESIZE_BAND = 16;
+
+    // Filtered rows a band keeps at once (in XMVECTORs), heavy minification streams past it
+    const size_t FAST_RESIZE_SCRATCH = 0x40000;
+
+    // Source plus destination pixels below which a resize isn't worth splitting across threads
+    const size_t FAST_RESIZE_PARALLEL = 0x40000;
+
+    XMGLOBALCONST XMVECTORF32 g_Fast8BitBias = { { { 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f } } };
+    XMGLOBALCONST XMVECTORF32 g_FastHalfMin = { { { -65504.f, -65504.f, -65504.f, -65504.f } } };
+    XMGLOBALCONST XMVECTORF32 g_FastHalfMax = { { { 65504.f, 65504.f, 65504.f, 65504.f } } };
+
+    struct FastFilter
+    {
+        size_t                      taps;   // Taps per destination pixel
+        std::unique_ptr<uint32_t[]> index;  // Source index of each tap, clamped to the edge
+        std::unique_ptr<float[]>    weight; // Normalized weight of each tap
+    };
+
+    inline float FastFilterSupport(DWORD filter)
+    {
+        return (filter == TEX_FILTER_CUBIC) ? 2.f : 1.f;
+    }
+
+    inline float FastFilterWeight(DWORD filter, float x)
+    {
+        x = fabsf(x);
+
+        if (filter == TEX_FILTER_CUBIC)
+        {
+            // Catmull-Rom
+            if (x < 1.f)
+                return (1.5f * x - 2.5f) * x * x + 1.f;
+            if (x < 2.f)
+                return ((-0.5f * x + 2.5f) * x - 4.f) * x + 2.f;
+            return 0.f;
+        }
+
+        return (x < 1.f) ? 1.f - x : 0.f;
+    }
+
+    // Length of source pixel i, [i - 0.5, i + 0.5], covered by [center - radius, center + radius]
+    inline float FastBoxCoverage(float i, float center, float radius)
+    {
+        float a = std::max<float>(i - 0.5f, center - radius);
+        float b = std::min<float>(i + 0.5f, center + radius);
+        return std::max<float>(b - a, 0.f);
+    }
+
+    bool CreateFastFilter(_In_ size_t source, _In_ size_t dest, _In_ DWORD filter, _Out_ FastFilter& ff)
+    {
+        assert(source > 0);
+        assert(dest > 0);
+
+        float scale = float(source) / float(dest);
+
+        // Box weights are the area of each source pixel the destination pixel covers, other
+        // kernels are widened when minifying so every source pixel contributes
+        bool box = (filter == TEX_FILTER_BOX);
+        float fscale = std::max<float>(scale, 1.f);
+        float support = box ? 0.5f * scale : FastFilterSupport(filter) * fscale;
+
+        size_t maxTaps = size_t(ceilf(support * 2.f)) + 1;
+
+        std::unique_ptr<ptrdiff_t[]> first(new (std::nothrow) ptrdiff_t[dest]);
+        std::unique_ptr<float[]> weights(new (std::nothrow) float[dest * maxTaps]);
+        if (!first || !weights)
+            return false;
+
+        // Evaluate the kernel, then trim taps that are zero for every pixel
+        size_t lead = maxTaps;
+        size_t used = 0;
+
+        for (size_t u = 0; u < dest; ++u)
+        {
+            float center = (float(u) + 0.5f) * scale - 0.5f;
+            first[u] = box ? ptrdiff_t(floorf(center - support + 0.5f)) : ptrdiff_t(ceilf(center - support));
+
+            float* w = weights.get() + u * maxTaps;
+            float total = 0.f;
+            for (size_t t = 0; t < maxTaps; ++t)
+            {
+                float i = float(first[u] + ptrdiff_t(t));
+                w[t] = box ? FastBoxCoverage(i, center, support) : FastFilterWeight(filter, (i - center) / fscale);
+                total += w[t];
+            }
+
+            if (total == 0.f)
+            {
+                w[0] = total = 1.f;
+            }
+
+            size_t t0 = 0;
+            while (w[t0] == 0.f)
+                ++t0;
+
+            size_t t1 = maxTaps;
+            while (w[t1 - 1] == 0.f)
+                --t1;
+
+            lead = std::min<size_t>(lead, t0);
+            used = std::max<size_t>(used, t1);
+
+            for (size_t t = 0; t < maxTaps; ++t)
+            {
+                w[t] /= total;
+            }
+        }
+
+        ff.taps = used - lead;
+        ff.index.reset(new (std::nothrow) uint32_t[dest * ff.taps]);
+        ff.weight.reset(new (std::nothrow) float[dest * ff.taps]);
+        if (!ff.index || !ff.weight)
+            return false;
+
+        for (size_t u = 0; u < dest; ++u)
+        {
+            for (size_t t = 0; t < ff.taps; ++t)
+            {
+                ptrdiff_t i = first[u] + ptrdiff_t(lead + t);
+                i = std::max<ptrdiff_t>(0, std::min<ptrdiff_t>(i, ptrdiff_t(source) - 1));
+
+                ff.index[u * ff.taps + t] = uint32_t(i);
+                ff.weight[u * ff.taps + t] = weights[u * maxTaps + lead + t];
+            }
+        }
+
+        return true;
+    }
+
+    // Halved, or already at 1 and kept there as at the tail of a mip chain
+    inline bool IsBoxDimension(size_t source, size_t dest)
+    {
+        return ((dest << 1) == source) || (source == 1 && dest == 1);
+    }
+
+    DWORD SelectFastFilter(_In_ const Image& srcImage, _In_ DWORD filter, _In_ const Image& destImage)
+    {
+        DWORD filter_select = (filter & TEX_FILTER_MASK);
+        if (!filter_select)
+        {
+            // Default filter choice, as the custom filter path but 4x1 to 2x1 is still a box
+            filter_select = (IsBoxDimension(srcImage.width, destImage.width) && IsBoxDimension(srcImage.height, destImage.height))
+                ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+        }
+
+        return filter_select;
+    }
+
+    void LoadFastRow(_Out_writes_(count) XMVECTOR* pDestination, _In_ const void* pSource, _In_ size_t count, _In_ DXGI_FORMAT format)
+    {
+        if (format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+        {
+            XMConvertHalfToFloatStream(
+                reinterpret_cast<float*>(pDestination), sizeof(float),
+                static_cast<const HALF*>(pSource), sizeof(HALF),
+                count * 4);
+            return;
+        }
+
+        // 8-bit formats are filtered in their stored channel order
+        auto sPtr = static_cast<const XMUBYTEN4*>(pSource);
+        for (size_t i = 0; i < count; ++i)
+        {
+            pDestination[i] = XMLoadUByteN4(sPtr + i);
+        }
+    }
+
+    void StoreFastRow(_Out_ void* pDestination, _In_ DXGI_FORMAT format, _In_reads_(count) const XMVECTOR* pSource, _In_ size_t count)
+    {
+        if (format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+        {
+            auto dPtr = static_cast<XMHALF4*>(pDestination);
+            for (size_t i = 0; i < count; ++i)
+            {
+                XMStoreHalf4(dPtr + i, XMVectorClamp(pSource[i], g_FastHalfMin, g_FastHalfMax));
+            }
+            return;
+        }
+
+        auto dPtr = static_cast<XMUBYTEN4*>(pDestination);
+        for (size_t i = 0; i < count; ++i)
+        {
+            XMStoreUByteN4(dPtr + i, XMVectorAdd(pSource[i], g_Fast8BitBias));
+        }
+    }
+
+    void FilterFastRow(_Out_writes_(count) XMVECTOR* pDestination, _In_ const XMVECTOR* pSource, _In_ const FastFilter& ff, _In_ size_t count)
+    {
+        const uint32_t* index = ff.index.get();
+        const float* weight = ff.weight.get();
+
+        for (size_t x = 0; x < count; ++x)
+        {
+            XMVECTOR v = XMVectorZero();
+            for (size_t t = 0; t < ff.taps; ++t)
+            {
+                v = XMVectorMultiplyAdd(pSource[*index++], XMVectorReplicate(*weight++), v);
+            }
+
+            pDestination[x] = v;
+        }
+    }
+
+    //--- 2:1 box filter on 8-bit RGBA, averages each 2x2 block with rounding ---
+    void BoxFastRow8(_Out_writes_(count * 4) uint8_t* pDestination, _In_ const uint8_t* pRow0, _In_ const uint8_t* pRow1, _In_ size_t count)
+    {
+        size_t x = 0;
+
+#if defined(_XM_SSE_INTRINSICS_) && !defined(_XM_NO_INTRINSICS_)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(2);
+
+        for (; x + 2 <= count; x += 2)
+        {
+            __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow0 + x * 8));
+            __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow1 + x * 8));
+
+            // Sum vertically in 16-bit, then add each pixel pair
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+            __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), bias), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(pDestination + x * 4), _mm_packus_epi16(sum, sum));
+        }
+#endif
+
+        for (; x < count; ++x)
+        {
+            for (size_t c = 0; c < 4; ++c)
+            {
+                pDestination[x * 4 + c] = uint8_t((pRow0[x * 8 + c] + pRow0[x * 8 + 4 + c] + pRow1[x * 8 + c] + pRow1[x * 8 + 4 + c] + 2) >> 2);
+            }
+        }
+    }
+
+    //--- Source rows the destination row reads ---
+    void GetFastRowRange(_In_ const FastFilter& yf, _In_ size_t y, _Inout_ size_t& lo, _Inout_ size_t& hi)
+    {
+        for (size_t t = 0; t < yf.taps; ++t)
+        {
+            lo = std::min<size_t>(lo, yf.index[y * yf.taps + t]);
+            hi = std::max<size_t>(hi, yf.index[y * yf.taps + t]);
+        }
+    }
+
+    //--- Accumulate the weighted source rows of destination row y into target ---
+    void FilterFastColumn(
+        _Inout_updates_all_(dwidth) XMVECTOR* target,
+        _In_ const XMVECTOR* rows,
+        _In_ size_t lo,
+        _In_ size_t dwidth,
+        _In_ const FastFilter& yf,
+        _In_ size_t y)
+    {
+        const uint32_t* index = yf.index.get() + y * yf.taps;
+        const float* weight = yf.weight.get() + y * yf.taps;
+
+        memset(target, 0, sizeof(XMVECTOR) * dwidth);
+
+        for (size_t t = 0; t < yf.taps; ++t)
+        {
+            if (weight[t] == 0.f)
+                continue;
+
+            const XMVECTOR* src = rows + (index[t] - lo) * dwidth;
+            XMVECTOR w = XMVectorReplicate(weight[t]);
+            for (size_t x = 0; x < dwidth; ++x)
+            {
+                target[x] = XMVectorMultiplyAdd(src[x], w, target[x]);
+            }
+        }
+    }
+
+    //--- Resize a band of destination rows ---
+    bool ResizeFastBand(
+        _In_ const Image& srcImage,
+        _In_ const Image& destImage,
+        _In_ DWORD filter,
+        _In_ const FastFilter& xf,
+        _In_ const FastFilter& yf,
+        _In_ size_t y0,
+        _In_ size_t y1)
+    {
+        if (filter == TEX_FILTER_BOX && destImage.format != DXGI_FORMAT_R16G16B16A16_FLOAT
+            && (destImage.width << 1) == srcImage.width && (destImage.height << 1) == srcImage.height)
+        {
+            for (size_t y = y0; y < y1; ++y)
+            {
+                const uint8_t* pRow0 = srcImage.pixels + srcImage.rowPitch * (y << 1);
+                BoxFastRow8(destImage.pixels + destImage.rowPitch * y, pRow0, pRow0 + srcImage.rowPitch, destImage.width);
+            }
+
+            return true;
+        }
+
+        size_t swidth = srcImage.width;
+        size_t dwidth = destImage.width;
+
+        // Source rows touched by this band, capped so heavy minification can't grow the scratch
+        size_t lo = srcImage.height;
+        size_t hi = 0;
+        for (size_t y = y0; y < y1; ++y)
+        {
+            GetFastRowRange(yf, y, lo, hi);
+        }
+
+        size_t nrows = std::min<size_t>(hi - lo + 1, std::max<size_t>(FAST_RESIZE_SCRATCH / dwidth, 1));
+
+        ScopedAlignedArrayXMVECTOR scanline(static_cast<XMVECTOR*>(_aligned_malloc(sizeof(XMVECTOR) * (swidth + dwidth * (nrows + 1)), 16)));
+        if (!scanline)
+            return false;
+
+        XMVECTOR* row = scanline.get();
+        XMVECTOR* target = row + swidth;
+        XMVECTOR* rows = target + dwidth;
+
+        for (size_t y = y0; y < y1;)
+        {
+            lo = srcImage.height;
+            hi = 0;
+            GetFastRowRange(yf, y, lo, hi);
+
+            if (hi - lo + 1 > nrows)
+            {
+                // A single row reads more than fits, filter and accumulate one source row at a time
+                const uint32_t* index = yf.index.get() + y * yf.taps;
+                const float* weight = yf.weight.get() + y * yf.taps;
+
+                memset(target, 0, sizeof(XMVECTOR) * dwidth);
+
+                for (size_t t = 0; t < yf.taps; ++t)
+                {
+                    if (weight[t] == 0.f)
+                        continue;
+
+                    LoadFastRow(row, srcImage.pixels + srcImage.rowPitch * index[t], swidth, srcImage.format);
+                    FilterFastRow(rows, row, xf, dwidth);
+
+                    XMVECTOR w = XMVectorReplicate(weight[t]);
+                    for (size_t x = 0; x < dwidth; ++x)
+                    {
+                        target[x] = XMVectorMultiplyAdd(rows[x], w, target[x]);
+                    }
+                }
+
+                StoreFastRow(destImage.pixels + destImage.rowPitch * y, destImage.format, target, dwidth);
+                ++y;
+                continue;
+            }
+
+            // Take as many destination rows as the scratch rows can serve
+            size_t ye = y + 1;
+            while (ye < y1)
+            {
+                size_t nlo = lo;
+                size_t nhi = hi;
+                GetFastRowRange(yf, ye, nlo, nhi);
+                if (nhi - nlo + 1 > nrows)
+                    break;
+
+                lo = nlo;
+                hi = nhi;
+                ++ye;
+            }
+
+            // Horizontal pass
+            for (size_t sy = lo; sy <= hi; ++sy)
+            {
+                LoadFastRow(row, srcImage.pixels + srcImage.rowPitch * sy, swidth, srcImage.format);
+                FilterFastRow(rows + (sy - lo) * dwidth, row, xf, dwidth);
+            }
+
+            // Vertical pass
+            for (; y < ye; ++y)
+            {
+                FilterFastColumn(target, rows, lo, dwidth, yf, y);
+                StoreFastRow(destImage.pixels + destImage.rowPitch * y, destImage.format, target, dwidth);
+            }
+        }
+
+        return true;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// Determine if the fast separable filters support the format and filter
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+bool DirectX::_IsFastResizeSupported(DXGI_FORMAT format, DWORD filter)
+{
+    if (filter & (TEX_FILTER_WRAP | TEX_FILTER_MIRROR | TEX_FILTER_SRGB | TEX_FILTER_FORCE_WIC))
+        return false;
+
+    switch (filter & TEX_FILTER_MASK)
+    {
+    case 0:
+    case TEX_FILTER_BOX:
+    case TEX_FILTER_LINEAR:
+    case TEX_FILTER_CUBIC:
+        break;
+
+    default:
+        return false;
+    }
+
+    switch (format)
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// Resize images using the fast separable filters, split across images and bands of rows
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::_ResizeFast(const Image* srcImages, const Image* destImages, size_t nimages, DWORD filter)
+{
+    if (!srcImages || !destImages || !nimages)
+        return E_INVALIDARG;
+
+    std::unique_ptr<FastFilter[]> filters(new (std::nothrow) FastFilter[nimages * 2]);
+    std::unique_ptr<DWORD[]> selects(new (std::nothrow) DWORD[nimages]);
+    std::unique_ptr<size_t[]> bands(new (std::nothrow) size_t[nimages + 1]);
+    if (!filters || !selects || !bands)
+        return E_OUTOFMEMORY;
+
+    size_t pixels = 0;
+
+    bands[0] = 0;
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        const Image& src = srcImages[index];
+        const Image& dest = destImages[index];
+
+        if (!src.pixels || !dest.pixels)
+            return E_POINTER;
+
+        if (src.format != dest.format || !_IsFastResizeSupported(src.format, filter))
+            return E_FAIL;
+
+        selects[index] = SelectFastFilter(src, filter, dest);
+
+        if (!CreateFastFilter(src.width, dest.width, selects[index], filters[index * 2])
+            || !CreateFastFilter(src.height, dest.height, selects[index], filters[index * 2 + 1]))
+            return E_OUTOFMEMORY;
+
+        bands[index + 1] = bands[index] + (dest.height + FAST_RESIZE_BAND - 1) / FAST_RESIZE_BAND;
+        pixels += src.width * src.height + dest.width * dest.height;
+    }
+
+    const size_t nbands = bands[nimages];
+
+    bool fail = false;
+
+#ifdef _OPENMP
+    // Small resizes finish before the threads would start
+    const bool parallel = (nbands > 1) && (pixels >= FAST_RESIZE_PARALLEL);
+
+#pragma omp parallel for schedule(dynamic) if (parallel)
+#endif
+    for (int nb = 0; nb < static_cast<int>(nbands); ++nb)
+    {
+        size_t index = 0;
+        while (bands[index + 1] <= size_t(nb))
+            ++index;
+
+        const Image& dest = destImages[index];
+
+        size_t y0 = (size_t(nb) - bands[index]) * FAST_RESIZE_BAND;
+        size_t y1 = std::min<size_t>(y0 + FAST_RESIZE_BAND, dest.height);
+
+        if (!ResizeFastBand(srcImages[index], dest, selects[index], filters[index * 2], filters[index * 2 + 1], y0, y1))
+            fail = true;
+    }
+
+    return (fail) ? E_OUTOFMEMORY : S_OK;
+}
+
+
 //=====================================================================================
 // Entry-points
 //=====================================================================================
@@ -862,7 +1361,8 @@ HRESULT DirectX::Resize(
         return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
     }
 
-    bool usewic = UseWICFiltering(srcImage.format, filter);
+    bool usefast = _IsFastResizeSupported(srcImage.format, filter);
+    bool usewic = !usefast && UseWICFiltering(srcImage.format, filter);
 
     WICPixelFormatGUID pfGUID = {};
     bool wicpf = (usewic) ? _DXGIToWIC(srcImage.format, pfGUID, true) : false;
@@ -889,7 +1389,12 @@ HRESULT DirectX::Resize(
     if (!rimage)
         return E_POINTER;
 
-    if (usewic)
+    if (usefast)
+    {
+        // Case 0: fast separable filters
+        hr = _ResizeFast(&srcImage, rimage, 1, filter);
+    }
+    else if (usewic)
     {
         if (wicpf)
         {
@@ -945,7 +1450,8 @@ HRESULT DirectX::Resize(
     if (FAILED(hr))
         return hr;
 
-    bool usewic = !metadata.IsPMAlpha() && UseWICFiltering(metadata.format, filter);
+    bool usefast = _IsFastResizeSupported(metadata.format, filter);
+    bool usewic = !usefast && !metadata.IsPMAlpha() && UseWICFiltering(metadata.format, filter);
 
     WICPixelFormatGUID pfGUID = {};
     bool wicpf = (usewic) ? _DXGIToWIC(metadata.format, pfGUID, true) : false;
@@ -964,6 +1470,14 @@ HRESULT DirectX::Resize(
         }
     }
 
+    std::vector<Image> fastSrc;
+    std::vector<Image> fastDest;
+    if (usefast)
+    {
+        fastSrc.reserve(nimages);
+        fastDest.reserve(nimages);
+    }
+
     switch (metadata.dimension)
     {
     case TEX_DIMENSION_TEXTURE1D:
@@ -999,6 +1513,14 @@ HRESULT DirectX::Resize(
                 return E_FAIL;
             }
 
+            if (usefast)
+            {
+                // Case 0: fast separable filters, run once every image is gathered
+                fastSrc.push_back(*srcimg);
+                fastDest.push_back(*destimg);
+                continue;
+            }
+
             if (usewic)
             {
                 if (wicpf)
@@ -1058,6 +1580,14 @@ HRESULT DirectX::Resize(
                 return E_FAIL;
             }
 
+            if (usefast)
+            {
+                // Case 0: fast separable filters, run once every image is gathered
+                fastSrc.push_back(*srcimg);
+                fastDest.push_back(*destimg);
+                continue;
+            }
+
             if (usewic)
             {
                 if (wicpf)
@@ -1090,5 +1620,15 @@ HRESULT DirectX::Resize(
         return E_FAIL;
     }
 
+    if (usefast)
+    {
+        hr = _ResizeFast(fastSrc.data(), fastDest.data(), fastSrc.size(), filter);
+        if (FAILED(hr))
+        {
+            result.Release();
+            return hr;
+        }
+    }
+
     return S_OK;
 }
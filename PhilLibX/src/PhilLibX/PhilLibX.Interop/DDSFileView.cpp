@@ -0,0 +1,334 @@
+#include "stdafx.h"
+#pragma warning(disable : 4561) // __fastcall' incompatible with the '/clr' option: converting to '__stdcall
+#include <algorithm>
+#include "DirectXTex.h"
+#include "InteropUtility.h"
+#include "ScratchImagePool.h"
+#include "ScratchImage.h"
+#include "DirectXException.h"
+#include "DDSFileView.h"
+
+// Magic, DDS_HEADER and DDS_HEADER_DXT10, the most we need to map to read the header
+static const size_t MaxDDSHeaderSize = 148;
+
+PhilLibX::Imaging::DDSFileView::DDSFileView(String^ filePath)
+{
+	// Results
+	HRESULT result;
+	// Input Path
+	std::wstring filePathStd;
+	// Convert String
+	InteropUtility::ToStdWString(filePath, filePathStd);
+
+	try
+	{
+		// Open and create the mapping, views are only mapped for the header and each image as it's used
+		FileHandle = CreateFileW(filePathStd.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (FileHandle == INVALID_HANDLE_VALUE)
+		{
+			FileHandle = nullptr;
+			throw gcnew DirectXException(String::Format("Failed to open DDS file, return code: 0x{0:X}", HRESULT_FROM_WIN32(GetLastError())));
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(FileHandle, &fileSize))
+			throw gcnew DirectXException(String::Format("Failed to get DDS file size, return code: 0x{0:X}", HRESULT_FROM_WIN32(GetLastError())));
+		if (fileSize.QuadPart == 0)
+			throw gcnew DirectXException(String::Format("DDS file is empty"));
+
+		MappingHandle = CreateFileMappingW(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!MappingHandle)
+			throw gcnew DirectXException(String::Format("Failed to map DDS file, return code: 0x{0:X}", HRESULT_FROM_WIN32(GetLastError())));
+
+		size_t headerSize = (size_t)(std::min)((uint64_t)fileSize.QuadPart, (uint64_t)MaxDDSHeaderSize);
+
+		View = MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, headerSize);
+		if (!View)
+			throw gcnew DirectXException(String::Format("Failed to map DDS file, return code: 0x{0:X}", HRESULT_FROM_WIN32(GetLastError())));
+
+		NativeMetadata = new (std::nothrow) DirectX::TexMetadata();
+		// Validate it
+		if (!NativeMetadata)
+			throw gcnew Exception("Failed to create metadata");
+
+		// Parse the header and count the images
+		size_t imageCount = 0;
+		result = DirectX::GetDDSImageLayout(View, headerSize, (uint64_t)fileSize.QuadPart, DirectX::DDS_FLAGS_NONE, *NativeMetadata, nullptr, nullptr, imageCount);
+
+		if (SUCCEEDED(result))
+		{
+			Images = new (std::nothrow) DirectX::Image[imageCount];
+			Offsets = new (std::nothrow) uint64_t[imageCount];
+			// Validate it
+			if (!Images || !Offsets)
+				throw gcnew Exception("Failed to create image views");
+
+			result = DirectX::GetDDSImageLayout(View, headerSize, (uint64_t)fileSize.QuadPart, DirectX::DDS_FLAGS_NONE, *NativeMetadata, Images, Offsets, imageCount);
+			ImageCount = imageCount;
+			ReleaseView();
+		}
+		else if (result == HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED))
+		{
+			// Legacy formats are converted on load, so load them in full and drop the mapping
+			Unmap();
+
+			Fallback = new (std::nothrow) DirectX::ScratchImage();
+			// Validate it
+			if (!Fallback)
+				throw gcnew Exception("Failed to create scratch image");
+
+			result = DirectX::LoadFromDDSFile(filePathStd.data(), DirectX::DDS_FLAGS_NONE, NativeMetadata, *Fallback);
+
+			if (SUCCEEDED(result))
+			{
+				Images = new (std::nothrow) DirectX::Image[Fallback->GetImageCount()];
+				// Validate it
+				if (!Images)
+					throw gcnew Exception("Failed to create image views");
+
+				ImageCount = Fallback->GetImageCount();
+				memcpy(Images, Fallback->GetImages(), sizeof(DirectX::Image) * ImageCount);
+			}
+		}
+
+		// Check result
+		if (FAILED(result))
+			throw gcnew DirectXException(String::Format("Failed to read DDS file, return code: 0x{0:X}", result));
+	}
+	catch (...)
+	{
+		this->!DDSFileView();
+		throw;
+	}
+}
+
+PhilLibX::Imaging::DDSFileView::~DDSFileView()
+{
+	this->!DDSFileView();
+}
+
+PhilLibX::Imaging::DDSFileView::!DDSFileView()
+{
+	Unmap();
+
+	delete[] Images;
+	delete[] Offsets;
+	delete NativeMetadata;
+	delete Fallback;
+
+	Images = nullptr;
+	Offsets = nullptr;
+	NativeMetadata = nullptr;
+	Fallback = nullptr;
+	ImageCount = 0;
+}
+
+void PhilLibX::Imaging::DDSFileView::ReleaseView()
+{
+	if (View)
+	{
+		UnmapViewOfFile(View);
+		View = nullptr;
+	}
+}
+
+void PhilLibX::Imaging::DDSFileView::Unmap()
+{
+	ReleaseView();
+
+	if (MappingHandle)
+	{
+		CloseHandle(MappingHandle);
+		MappingHandle = nullptr;
+	}
+	if (FileHandle)
+	{
+		CloseHandle(FileHandle);
+		FileHandle = nullptr;
+	}
+}
+
+const DirectX::Image* PhilLibX::Imaging::DDSFileView::GetNativeImage(int mip, int item, int slice)
+{
+	// Validate it
+	if (!Images || !NativeMetadata)
+		throw gcnew ObjectDisposedException("DDSFileView");
+	if (mip < 0 || item < 0 || slice < 0 || (size_t)mip >= NativeMetadata->mipLevels)
+		throw gcnew ArgumentOutOfRangeException("mip");
+
+	// Same layout as DirectX::ScratchImage::GetImage, items then mips, or mips then slices for volumes
+	size_t index = 0;
+
+	if (NativeMetadata->dimension == DirectX::TEX_DIMENSION_TEXTURE3D)
+	{
+		if (item > 0)
+			throw gcnew ArgumentOutOfRangeException("item");
+
+		size_t depth = NativeMetadata->depth;
+
+		for (size_t level = 0; level < (size_t)mip; level++)
+		{
+			index += depth;
+			if (depth > 1)
+				depth >>= 1;
+		}
+
+		if ((size_t)slice >= depth)
+			throw gcnew ArgumentOutOfRangeException("slice");
+
+		index += slice;
+	}
+	else
+	{
+		if (slice > 0)
+			throw gcnew ArgumentOutOfRangeException("slice");
+		if ((size_t)item >= NativeMetadata->arraySize)
+			throw gcnew ArgumentOutOfRangeException("item");
+
+		index = item * NativeMetadata->mipLevels + mip;
+	}
+
+	if (index >= ImageCount)
+		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::Image, index out of range"));
+
+	return &Images[index];
+}
+
+void* PhilLibX::Imaging::DDSFileView::MapImage(const DirectX::Image* img, DirectX::Image& mapped)
+{
+	mapped = *img;
+
+	// Already loaded
+	if (Fallback)
+		return nullptr;
+
+	if (!MappingHandle)
+		throw gcnew ObjectDisposedException("DDSFileView");
+
+	// Views have to start on the allocation granularity, so map from the boundary before the image
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+
+	uint64_t offset = Offsets[img - Images];
+	size_t delta = (size_t)(offset % systemInfo.dwAllocationGranularity);
+	uint64_t viewOffset = offset - delta;
+
+	auto view = (uint8_t*)MapViewOfFile(MappingHandle, FILE_MAP_READ, (DWORD)(viewOffset >> 32), (DWORD)viewOffset, delta + img->slicePitch);
+	if (!view)
+		throw gcnew DirectXException(String::Format("Failed to map DDS image, return code: 0x{0:X}", HRESULT_FROM_WIN32(GetLastError())));
+
+	mapped.pixels = view + delta;
+
+	return view;
+}
+
+PhilLibX::Imaging::ScratchImage::Metadata^ PhilLibX::Imaging::DDSFileView::GetMetadata()
+{
+	// Validate it
+	if (!NativeMetadata)
+		throw gcnew ObjectDisposedException("DDSFileView");
+
+	auto metaData = gcnew ScratchImage::Metadata();
+
+	metaData->Width      = (UInt64)NativeMetadata->width;
+	metaData->Height     = (UInt64)NativeMetadata->height;
+	metaData->Depth      = (UInt64)NativeMetadata->depth;
+	metaData->ArraySize  = (UInt64)NativeMetadata->arraySize;
+	metaData->MipLevels  = (UInt64)NativeMetadata->mipLevels;
+	metaData->MiscFlags  = (ScratchImage::TexMiscFlags)NativeMetadata->miscFlags;
+	metaData->MiscFlags2 = (ScratchImage::TexMiscFlags2)NativeMetadata->miscFlags2;
+	metaData->Format     = (ScratchImage::DXGIFormat)NativeMetadata->format;
+	metaData->Dimension  = (ScratchImage::TexDimension)NativeMetadata->dimension;
+
+	return metaData;
+}
+
+PhilLibX::Imaging::ScratchImage::ImageSpan PhilLibX::Imaging::DDSFileView::GetImageSpan(int mip, int item, int slice)
+{
+	const DirectX::Image* native = GetNativeImage(mip, item, slice);
+
+	// The previous span's view is replaced by this one
+	ReleaseView();
+
+	DirectX::Image mapped;
+	View = MapImage(native, mapped);
+
+	const DirectX::Image* img = &mapped;
+
+	ScratchImage::ImageSpan span;
+
+	span.Pixels     = IntPtr(img->pixels);
+	span.Width      = (Int64)img->width;
+	span.Height     = (Int64)img->height;
+	span.RowPitch   = (Int64)img->rowPitch;
+	span.SlicePitch = (Int64)img->slicePitch;
+	span.Format     = (ScratchImage::DXGIFormat)img->format;
+
+	return span;
+}
+
+int PhilLibX::Imaging::DDSFileView::FindMipLevel(int maxSize)
+{
+	// Validate it
+	if (!NativeMetadata)
+		throw gcnew ObjectDisposedException("DDSFileView");
+
+	size_t width = NativeMetadata->width;
+	size_t height = NativeMetadata->height;
+	size_t mip = 0;
+
+	while (mip + 1 < NativeMetadata->mipLevels && (width > (size_t)maxSize || height > (size_t)maxSize))
+	{
+		width = width > 1 ? width >> 1 : 1;
+		height = height > 1 ? height >> 1 : 1;
+		mip++;
+	}
+
+	return (int)mip;
+}
+
+PhilLibX::Imaging::ScratchImage^ PhilLibX::Imaging::DDSFileView::ToScratchImage(int mip, int item, int slice)
+{
+	const DirectX::Image* img = GetNativeImage(mip, item, slice);
+
+	// Create Scratch Image
+	std::unique_ptr<DirectX::ScratchImage> scratchImage(new (std::nothrow) DirectX::ScratchImage);
+	// Validate it
+	if (!scratchImage)
+		throw gcnew Exception("Failed to create scratch image");
+
+	// Only this image's pages are mapped and read from the file
+	DirectX::Image mapped;
+	void* view = MapImage(img, mapped);
+	HRESULT result;
+
+	try
+	{
+		result = scratchImage->InitializeFromImage(mapped);
+	}
+	finally
+	{
+		if (view)
+			UnmapViewOfFile(view);
+	}
+
+	// Check result
+	if (FAILED(result))
+		throw gcnew DirectXException(String::Format("Failed to copy image, return code: 0x{0:X}", result));
+
+	return gcnew ScratchImage(scratchImage.release());
+}
+
+Bitmap^ PhilLibX::Imaging::DDSFileView::ToBitmap(int mip, int item, int slice)
+{
+	auto image = ToScratchImage(mip, item, slice);
+
+	try
+	{
+		return image->ToBitmap();
+	}
+	finally
+	{
+		delete image;
+	}
+}
@@ -0,0 +1,153 @@
+// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: DDSFileView.h
+// Author: Philip/Scobalula
+// Description: A read-only memory-mapped view of a DDS file
+#pragma once
+
+using namespace System;
+using namespace System::Drawing;
+
+namespace PhilLibX
+{
+	namespace Imaging
+	{
+		/// <summary>
+		/// A read-only memory-mapped view of a DDS file
+		///
+		/// Only the header is mapped up front, each mip/slice is mapped on its own when it's used so
+		/// only its pages are read and large files don't need their whole size in address space, which
+		/// matters for 32-bit processes. Legacy formats that need converting on load are loaded in full instead.
+		/// </summary>
+		public ref class DDSFileView
+		{
+		private:
+			/// <summary>
+			/// File and mapping handles
+			/// </summary>
+			HANDLE FileHandle;
+			HANDLE MappingHandle;
+
+			/// <summary>
+			/// Start of the current view, the header while loading, then the last image span
+			/// </summary>
+			void* View;
+
+			/// <summary>
+			/// Native metadata
+			/// </summary>
+			DirectX::TexMetadata* NativeMetadata;
+
+			/// <summary>
+			/// Image sizes with null pixels and their offsets in the file, or images pointing into the fallback image
+			/// </summary>
+			DirectX::Image* Images;
+			uint64_t* Offsets;
+			size_t ImageCount;
+
+			/// <summary>
+			/// Fully loaded image for legacy formats
+			/// </summary>
+			DirectX::ScratchImage* Fallback;
+
+			/// <summary>
+			/// Gets the native image for the given mip/slice
+			/// </summary>
+			const DirectX::Image* GetNativeImage(int mip, int item, int slice);
+
+			/// <summary>
+			/// Maps just the given image's pages, returns the view to unmap, or nullptr if the image is already loaded
+			/// </summary>
+			/// <param name="img">Image from <see cref="GetNativeImage"/></param>
+			/// <param name="mapped">Image to point at the mapped pixels</param>
+			void* MapImage(const DirectX::Image* img, DirectX::Image& mapped);
+
+			/// <summary>
+			/// Unmaps the current view
+			/// </summary>
+			void ReleaseView();
+
+			/// <summary>
+			/// Unmaps the file and closes its handles
+			/// </summary>
+			void Unmap();
+
+		public:
+			/// <summary>
+			/// Initializes an instance of the <see cref="DDSFileView"/> class and maps the given file
+			/// </summary>
+			/// <param name="filePath">DDS file path</param>
+			DDSFileView(String^ filePath);
+
+			/// <summary>
+			/// Gets whether or not the images are mapped from the file rather than a loaded copy
+			/// </summary>
+			property bool IsMapped { bool get() { return Fallback == nullptr; } }
+
+			/// <summary>
+			/// Gets the metadata parsed from the header
+			/// </summary>
+			ScratchImage::Metadata^ GetMetadata();
+
+			/// <summary>
+			/// Gets a read-only view of the given mip/slice's pixels in the mapped file, valid until the next call or until the view is disposed
+			/// </summary>
+			/// <param name="mip">Mip Map to get</param>
+			/// <param name="item">Item to get</param>
+			/// <param name="slice">Slice to get</param>
+			ScratchImage::ImageSpan GetImageSpan(int mip, int item, int slice);
+
+			/// <summary>
+			/// Gets the first mip that fits within the given size, or the smallest mip if none do, i.e. for thumbnails
+			/// </summary>
+			/// <param name="maxSize">Maximum width and height</param>
+			int FindMipLevel(int maxSize);
+
+			/// <summary>
+			/// Copies the given mip/slice to a new <see cref="ScratchImage"/>, decode or convert that instead of the whole file
+			/// </summary>
+			/// <param name="mip">Mip Map to copy</param>
+			/// <param name="item">Item to copy</param>
+			/// <param name="slice">Slice to copy</param>
+			ScratchImage^ ToScratchImage(int mip, int item, int slice);
+
+			/// <summary>
+			/// Decodes the given mip/slice to a .NET <see cref="Bitmap"/>
+			/// </summary>
+			/// <param name="mip">Mip Map to convert</param>
+			/// <param name="item">Item to convert</param>
+			/// <param name="slice">Slice to convert</param>
+			Bitmap^ ToBitmap(int mip, int item, int slice);
+
+			/// <summary>
+			/// Destructs the DDSFileView and unmaps the file
+			/// </summary>
+			~DDSFileView();
+
+			/// <summary>
+			/// Unmaps the file if the DDSFileView wasn't disposed
+			/// </summary>
+			!DDSFileView();
+		};
+	}
+}
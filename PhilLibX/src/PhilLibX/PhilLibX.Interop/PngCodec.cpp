@@ -0,0 +1,805 @@
+#include "stdafx.h"
+#pragma warning(disable : 4561) // __fastcall' incompatible with the '/clr' option: converting to '__stdcall
+#include <algorithm>
+#include <vector>
+#include <emmintrin.h>
+#include "DirectXTex.h"
+#include "miniz.h"
+#include "PngCodec.h"
+
+#pragma managed(push, off)
+
+namespace
+{
+	// Filtered bytes per deflate strip, smaller strips scale better but compress worse
+	const size_t StripSize = 0x100000;
+	// Zero padding before and after each row so filters can read the left pixel and run past the end
+	const size_t RowPadding = 16;
+
+	const uint8_t Signature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+
+	enum FilterType : uint8_t
+	{
+		FilterNone,
+		FilterSub,
+		FilterUp,
+		FilterAverage,
+		FilterPaeth,
+		FilterCount,
+	};
+
+	/// <summary>
+	/// A strip of rows deflated by one worker
+	/// </summary>
+	struct EncodeStrip
+	{
+		size_t FirstRow;
+		size_t RowCount;
+		uint32_t Adler;
+		bool Failed;
+		std::vector<uint8_t> Output;
+	};
+
+	/// <summary>
+	/// Settings and strips shared by the encode workers
+	/// </summary>
+	struct EncodeJob
+	{
+		const DirectX::Image* Image;
+		bool SwapRB;
+		bool Swap16;
+		size_t PixelSize;
+		size_t RowSize;
+		int DeflateFlags;
+		std::vector<EncodeStrip> Strips;
+		volatile LONG NextStrip;
+	};
+
+	inline void WriteUInt32BE(uint8_t* buffer, uint32_t value)
+	{
+		buffer[0] = (uint8_t)(value >> 24);
+		buffer[1] = (uint8_t)(value >> 16);
+		buffer[2] = (uint8_t)(value >> 8);
+		buffer[3] = (uint8_t)value;
+	}
+
+	inline uint32_t ReadUInt32BE(const uint8_t* buffer)
+	{
+		return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) | ((uint32_t)buffer[2] << 8) | buffer[3];
+	}
+
+	inline uint16_t ReadUInt16BE(const uint8_t* buffer)
+	{
+		return (uint16_t)((buffer[0] << 8) | buffer[1]);
+	}
+
+	/// <summary>
+	/// Gets the Adler-32 of two joined buffers from their own checksums
+	/// </summary>
+	uint32_t Adler32Combine(uint32_t adler1, uint32_t adler2, size_t length2)
+	{
+		const uint32_t Base = 65521;
+
+		uint32_t rem = (uint32_t)(length2 % Base);
+		uint32_t sum1 = adler1 & 0xFFFF;
+		uint32_t sum2 = (rem * sum1) % Base;
+		sum1 += (adler2 & 0xFFFF) + Base - 1;
+		sum2 += ((adler1 >> 16) & 0xFFFF) + ((adler2 >> 16) & 0xFFFF) + Base - rem;
+
+		if (sum1 >= Base) sum1 -= Base;
+		if (sum1 >= Base) sum1 -= Base;
+		if (sum2 >= (Base << 1)) sum2 -= (Base << 1);
+		if (sum2 >= Base) sum2 -= Base;
+
+		return sum1 | (sum2 << 16);
+	}
+
+	/// <summary>
+	/// Copies a row of the source image, swapping BGRA to RGBA or 16-bit samples to big endian if needed
+	/// </summary>
+	void PrepareRow(uint8_t* row, const uint8_t* source, size_t rowSize, bool swapRB, bool swap16)
+	{
+		if (swap16)
+		{
+			for (size_t i = 0; i < rowSize; i += 2)
+			{
+				row[i + 0] = source[i + 1];
+				row[i + 1] = source[i + 0];
+			}
+			return;
+		}
+
+		if (!swapRB)
+		{
+			memcpy(row, source, rowSize);
+			return;
+		}
+
+		for (size_t i = 0; i < rowSize; i += 4)
+		{
+			row[i + 0] = source[i + 2];
+			row[i + 1] = source[i + 1];
+			row[i + 2] = source[i + 0];
+			row[i + 3] = source[i + 3];
+		}
+	}
+
+	/// <summary>
+	/// Sums the absolute values of the filtered bytes as signed, lower compresses better
+	/// </summary>
+	size_t ScoreRow(const uint8_t* row, size_t length)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i sum = zero;
+		size_t i = 0;
+
+		for (; i + 16 <= length; i += 16)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)(row + i));
+			__m128i abs = _mm_min_epu8(v, _mm_sub_epi8(zero, v));
+			sum = _mm_add_epi64(sum, _mm_sad_epu8(abs, zero));
+		}
+
+		size_t result = (size_t)_mm_cvtsi128_si32(sum) + (size_t)_mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+
+		for (; i < length; i++)
+		{
+			uint8_t v = row[i];
+			result += v < 128 ? v : 256 - v;
+		}
+
+		return result;
+	}
+
+	/// <summary>
+	/// Applies every filter to the row, the rows have zeroed padding either side
+	/// </summary>
+	void FilterRow(uint8_t* outputs[FilterCount], const uint8_t* row, const uint8_t* prior, size_t length, size_t pixelSize)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi8(1);
+
+		// Runs to the next 16 bytes, the padding absorbs the overrun
+		for (size_t i = 0; i < length; i += 16)
+		{
+			__m128i x = _mm_loadu_si128((const __m128i*)(row + i));
+			__m128i a = _mm_loadu_si128((const __m128i*)(row + i - pixelSize));
+			__m128i b = _mm_loadu_si128((const __m128i*)(prior + i));
+			__m128i c = _mm_loadu_si128((const __m128i*)(prior + i - pixelSize));
+
+			_mm_storeu_si128((__m128i*)(outputs[FilterSub] + i), _mm_sub_epi8(x, a));
+			_mm_storeu_si128((__m128i*)(outputs[FilterUp] + i), _mm_sub_epi8(x, b));
+
+			// avg_epu8 rounds up, PNG rounds down
+			__m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+			_mm_storeu_si128((__m128i*)(outputs[FilterAverage] + i), _mm_sub_epi8(x, average));
+
+			// Paeth in 16-bit lanes
+			__m128i predictor[2];
+			for (int half = 0; half < 2; half++)
+			{
+				__m128i a16 = half ? _mm_unpackhi_epi8(a, zero) : _mm_unpacklo_epi8(a, zero);
+				__m128i b16 = half ? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+				__m128i c16 = half ? _mm_unpackhi_epi8(c, zero) : _mm_unpacklo_epi8(c, zero);
+
+				__m128i pa = _mm_sub_epi16(b16, c16);
+				__m128i pb = _mm_sub_epi16(a16, c16);
+				__m128i pc = _mm_add_epi16(pa, pb);
+				pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+				pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+				pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+
+				__m128i useA = _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc)), _mm_set1_epi16(-1));
+				__m128i useB = _mm_andnot_si128(useA, _mm_andnot_si128(_mm_cmpgt_epi16(pb, pc), _mm_set1_epi16(-1)));
+				__m128i useC = _mm_andnot_si128(_mm_or_si128(useA, useB), _mm_set1_epi16(-1));
+
+				predictor[half] = _mm_or_si128(_mm_or_si128(_mm_and_si128(useA, a16), _mm_and_si128(useB, b16)), _mm_and_si128(useC, c16));
+			}
+
+			_mm_storeu_si128((__m128i*)(outputs[FilterPaeth] + i), _mm_sub_epi8(x, _mm_packus_epi16(predictor[0], predictor[1])));
+		}
+	}
+
+	/// <summary>
+	/// Receives deflated output from MiniZ
+	/// </summary>
+	mz_bool PutBuffer(const void* buffer, int length, void* user)
+	{
+		try
+		{
+			auto output = (std::vector<uint8_t>*)user;
+			output->insert(output->end(), (const uint8_t*)buffer, (const uint8_t*)buffer + length);
+			return MZ_TRUE;
+		}
+		catch (...)
+		{
+			return MZ_FALSE;
+		}
+	}
+
+	/// <summary>
+	/// Filters and deflates a strip of rows
+	/// </summary>
+	bool EncodeStripRows(const EncodeJob& job, EncodeStrip& strip, bool last)
+	{
+		const size_t rowSize = job.RowSize;
+		const size_t paddedSize = rowSize + RowPadding * 2;
+
+		std::vector<uint8_t> filtered(strip.RowCount * (rowSize + 1));
+		std::vector<uint8_t> rows(paddedSize * 2);
+		std::vector<uint8_t> candidates(paddedSize * (FilterCount - 1));
+
+		uint8_t* row = rows.data() + RowPadding;
+		uint8_t* prior = rows.data() + paddedSize + RowPadding;
+
+		uint8_t* outputs[FilterCount] = { row };
+		for (int filter = FilterSub; filter < FilterCount; filter++)
+			outputs[filter] = candidates.data() + paddedSize * (filter - 1);
+
+		if (strip.FirstRow > 0)
+			PrepareRow(prior, job.Image->pixels + job.Image->rowPitch * (strip.FirstRow - 1), rowSize, job.SwapRB, job.Swap16);
+
+		uint8_t* dest = filtered.data();
+
+		for (size_t y = strip.FirstRow; y < strip.FirstRow + strip.RowCount; y++)
+		{
+			PrepareRow(row, job.Image->pixels + job.Image->rowPitch * y, rowSize, job.SwapRB, job.Swap16);
+			FilterRow(outputs, row, prior, rowSize, job.PixelSize);
+
+			// Pick the filter that leaves the smallest values
+			int bestFilter = FilterNone;
+			size_t bestScore = ScoreRow(row, rowSize);
+
+			for (int filter = FilterSub; filter < FilterCount; filter++)
+			{
+				size_t score = ScoreRow(outputs[filter], rowSize);
+
+				if (score < bestScore)
+				{
+					bestFilter = filter;
+					bestScore = score;
+				}
+			}
+
+			*dest++ = (uint8_t)bestFilter;
+			memcpy(dest, outputs[bestFilter], rowSize);
+			dest += rowSize;
+
+			std::swap(row, prior);
+			outputs[FilterNone] = row;
+		}
+
+		strip.Adler = (uint32_t)mz_adler32(MZ_ADLER32_INIT, filtered.data(), filtered.size());
+
+		tdefl_compressor* compressor = tdefl_compressor_alloc();
+		if (!compressor)
+			return false;
+
+		tdefl_status status = tdefl_init(compressor, PutBuffer, &strip.Output, job.DeflateFlags);
+
+		if (status == TDEFL_STATUS_OKAY)
+			status = tdefl_compress_buffer(compressor, filtered.data(), filtered.size(), last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH);
+
+		tdefl_compressor_free(compressor);
+
+		return status == TDEFL_STATUS_OKAY || status == TDEFL_STATUS_DONE;
+	}
+
+	/// <summary>
+	/// Thread pool worker, takes strips until there are none left
+	/// </summary>
+	VOID CALLBACK EncodeWorker(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work)
+	{
+		auto job = (EncodeJob*)context;
+		LONG count = (LONG)job->Strips.size();
+
+		for (LONG index = InterlockedIncrement(&job->NextStrip) - 1; index < count; index = InterlockedIncrement(&job->NextStrip) - 1)
+		{
+			auto& strip = job->Strips[index];
+
+			try
+			{
+				strip.Failed = !EncodeStripRows(*job, strip, index == count - 1);
+			}
+			catch (...)
+			{
+				strip.Failed = true;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Reverses the row's filter in place, the prior row has zeroed padding before it
+	/// </summary>
+	bool UnfilterRow(uint8_t filter, uint8_t* row, const uint8_t* prior, size_t length, size_t pixelSize)
+	{
+		switch (filter)
+		{
+		case FilterNone:
+			return true;
+		case FilterSub:
+			for (size_t i = pixelSize; i < length; i++)
+				row[i] += row[i - pixelSize];
+			return true;
+		case FilterUp:
+		{
+			size_t i = 0;
+			for (; i + 16 <= length; i += 16)
+			{
+				__m128i x = _mm_loadu_si128((const __m128i*)(row + i));
+				__m128i b = _mm_loadu_si128((const __m128i*)(prior + i));
+				_mm_storeu_si128((__m128i*)(row + i), _mm_add_epi8(x, b));
+			}
+			for (; i < length; i++)
+				row[i] += prior[i];
+			return true;
+		}
+		case FilterAverage:
+			for (size_t i = 0; i < length; i++)
+			{
+				int a = i >= pixelSize ? row[i - pixelSize] : 0;
+				row[i] += (uint8_t)((a + prior[i]) >> 1);
+			}
+			return true;
+		case FilterPaeth:
+			for (size_t i = 0; i < length; i++)
+			{
+				int a = i >= pixelSize ? row[i - pixelSize] : 0;
+				int b = prior[i];
+				int c = i >= pixelSize ? prior[i - pixelSize] : 0;
+				int pa = abs(b - c);
+				int pb = abs(a - c);
+				int pc = abs(a + b - 2 * c);
+				row[i] += (uint8_t)((pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c);
+			}
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	/// <summary>
+	/// Expands an unfiltered row to the output format, gray and RGB samples matching the tRNS key, if given, are transparent
+	/// and gray is then expanded to RGBA
+	/// </summary>
+	void ExpandRow(uint8_t* dest, const uint8_t* row, size_t width, int colorType, int bitDepth, const uint8_t* palette, const uint16_t* key)
+	{
+		if (bitDepth == 16)
+		{
+			auto dest16 = (uint16_t*)dest;
+
+			for (size_t x = 0; x < width; x++)
+			{
+				switch (colorType)
+				{
+				case 0:
+				{
+					auto gray = ReadUInt16BE(row + x * 2);
+					if (!key)
+					{
+						dest16[x] = gray;
+						break;
+					}
+					dest16[x * 4 + 0] = gray;
+					dest16[x * 4 + 1] = gray;
+					dest16[x * 4 + 2] = gray;
+					dest16[x * 4 + 3] = gray == key[0] ? 0 : 0xFFFF;
+					break;
+				}
+				case 2:
+				{
+					bool transparent = key != nullptr;
+					for (size_t c = 0; c < 3; c++)
+					{
+						dest16[x * 4 + c] = ReadUInt16BE(row + x * 6 + c * 2);
+						transparent = transparent && dest16[x * 4 + c] == key[c];
+					}
+					dest16[x * 4 + 3] = transparent ? 0 : 0xFFFF;
+					break;
+				}
+				case 4:
+				{
+					auto gray = (uint16_t)((row[x * 4] << 8) | row[x * 4 + 1]);
+					dest16[x * 4 + 0] = gray;
+					dest16[x * 4 + 1] = gray;
+					dest16[x * 4 + 2] = gray;
+					dest16[x * 4 + 3] = (uint16_t)((row[x * 4 + 2] << 8) | row[x * 4 + 3]);
+					break;
+				}
+				case 6:
+					for (size_t c = 0; c < 4; c++)
+						dest16[x * 4 + c] = (uint16_t)((row[x * 8 + c * 2] << 8) | row[x * 8 + c * 2 + 1]);
+					break;
+				}
+			}
+
+			return;
+		}
+
+		switch (colorType)
+		{
+		case 0:
+		{
+			if (bitDepth == 8 && !key)
+			{
+				memcpy(dest, row, width);
+				break;
+			}
+
+			// Scale 1, 2 and 4 bit gray to the full range
+			int mask = (1 << bitDepth) - 1;
+			int scale = 255 / mask;
+			for (size_t x = 0; x < width; x++)
+			{
+				size_t bit = x * bitDepth;
+				int sample = (row[bit >> 3] >> (8 - bitDepth - (bit & 7))) & mask;
+				auto gray = (uint8_t)(sample * scale);
+
+				if (!key)
+				{
+					dest[x] = gray;
+					continue;
+				}
+
+				dest[x * 4 + 0] = gray;
+				dest[x * 4 + 1] = gray;
+				dest[x * 4 + 2] = gray;
+				dest[x * 4 + 3] = sample == key[0] ? 0 : 0xFF;
+			}
+			break;
+		}
+		case 2:
+			for (size_t x = 0; x < width; x++)
+			{
+				dest[x * 4 + 0] = row[x * 3 + 0];
+				dest[x * 4 + 1] = row[x * 3 + 1];
+				dest[x * 4 + 2] = row[x * 3 + 2];
+				dest[x * 4 + 3] = key && row[x * 3 + 0] == key[0] && row[x * 3 + 1] == key[1] && row[x * 3 + 2] == key[2] ? 0 : 0xFF;
+			}
+			break;
+		case 3:
+		{
+			int mask = (1 << bitDepth) - 1;
+			for (size_t x = 0; x < width; x++)
+			{
+				size_t bit = x * bitDepth;
+				int index = (row[bit >> 3] >> (8 - bitDepth - (bit & 7))) & mask;
+				memcpy(dest + x * 4, palette + index * 4, 4);
+			}
+			break;
+		}
+		case 4:
+			for (size_t x = 0; x < width; x++)
+			{
+				dest[x * 4 + 0] = row[x * 2];
+				dest[x * 4 + 1] = row[x * 2];
+				dest[x * 4 + 2] = row[x * 2];
+				dest[x * 4 + 3] = row[x * 2 + 1];
+			}
+			break;
+		case 6:
+			memcpy(dest, row, width * 4);
+			break;
+		}
+	}
+}
+
+HRESULT PhilLibX::Imaging::PngCodec::Encode(const DirectX::Image& image, int level, DirectX::Blob& blob)
+{
+	// Validate it
+	if (!image.pixels)
+		return E_POINTER;
+	if (image.width == 0 || image.height == 0 || image.width > INT32_MAX || image.height > INT32_MAX)
+		return E_INVALIDARG;
+
+	EncodeJob job = {};
+	job.Image = &image;
+	uint8_t colorType;
+	uint8_t bitDepth = 8;
+
+	switch (image.format)
+	{
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+	case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		colorType = 6;
+		job.PixelSize = 4;
+		break;
+	case DXGI_FORMAT_B8G8R8A8_UNORM:
+	case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+		colorType = 6;
+		job.PixelSize = 4;
+		job.SwapRB = true;
+		break;
+	case DXGI_FORMAT_R16G16B16A16_UNORM:
+		colorType = 6;
+		bitDepth = 16;
+		job.PixelSize = 8;
+		job.Swap16 = true;
+		break;
+	case DXGI_FORMAT_R8_UNORM:
+		colorType = 0;
+		job.PixelSize = 1;
+		break;
+	case DXGI_FORMAT_R16_UNORM:
+		colorType = 0;
+		bitDepth = 16;
+		job.PixelSize = 2;
+		job.Swap16 = true;
+		break;
+	default:
+		return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+	}
+
+	level = (std::max)(1, (std::min)(level, 9));
+	job.RowSize = image.width * job.PixelSize;
+	job.DeflateFlags = (int)tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+
+	try
+	{
+		// Split the rows into strips
+		size_t rowsPerStrip = (std::max<size_t>)(1, StripSize / (job.RowSize + 1));
+
+		for (size_t y = 0; y < image.height; y += rowsPerStrip)
+		{
+			EncodeStrip strip = {};
+			strip.FirstRow = y;
+			strip.RowCount = (std::min)(rowsPerStrip, image.height - y);
+			job.Strips.push_back(std::move(strip));
+		}
+
+		// Deflate them on the thread pool, or here if there's only one
+		PTP_WORK work = job.Strips.size() > 1 ? CreateThreadpoolWork(EncodeWorker, &job, nullptr) : nullptr;
+
+		if (work)
+		{
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+
+			size_t workers = (std::min<size_t>)(job.Strips.size(), info.dwNumberOfProcessors);
+
+			for (size_t i = 0; i < workers; i++)
+				SubmitThreadpoolWork(work);
+
+			WaitForThreadpoolWorkCallbacks(work, FALSE);
+			CloseThreadpoolWork(work);
+		}
+		else
+		{
+			EncodeWorker(nullptr, &job, nullptr);
+		}
+
+		size_t fileSize = sizeof(Signature) + 25 + 12;
+		uint32_t adler = MZ_ADLER32_INIT;
+
+		for (auto& strip : job.Strips)
+		{
+			if (strip.Failed)
+				return E_FAIL;
+
+			adler = Adler32Combine(adler, strip.Adler, strip.RowCount * (job.RowSize + 1));
+			fileSize += strip.Output.size() + 12;
+		}
+
+		// zlib header and Adler-32
+		fileSize += 6;
+
+		HRESULT result = blob.Initialize(fileSize);
+		if (FAILED(result))
+			return result;
+
+		auto output = (uint8_t*)blob.GetBufferPointer();
+
+		memcpy(output, Signature, sizeof(Signature));
+		output += sizeof(Signature);
+
+		// IHDR
+		WriteUInt32BE(output, 13);
+		memcpy(output + 4, "IHDR", 4);
+		WriteUInt32BE(output + 8, (uint32_t)image.width);
+		WriteUInt32BE(output + 12, (uint32_t)image.height);
+		output[16] = bitDepth;
+		output[17] = colorType;
+		output[18] = 0;
+		output[19] = 0;
+		output[20] = 0;
+		WriteUInt32BE(output + 21, (uint32_t)mz_crc32(MZ_CRC32_INIT, output + 4, 17));
+		output += 25;
+
+		// IDAT per strip, the first carries the zlib header and the last the Adler-32
+		for (size_t i = 0; i < job.Strips.size(); i++)
+		{
+			auto& strip = job.Strips[i];
+			uint8_t* chunk = output;
+			uint8_t* data = output + 8;
+
+			if (i == 0)
+			{
+				*data++ = 0x78;
+				*data++ = level == 1 ? 0x01 : level < 6 ? 0x5E : level == 6 ? 0x9C : 0xDA;
+			}
+
+			memcpy(data, strip.Output.data(), strip.Output.size());
+			data += strip.Output.size();
+
+			if (i == job.Strips.size() - 1)
+			{
+				WriteUInt32BE(data, adler);
+				data += 4;
+			}
+
+			WriteUInt32BE(chunk, (uint32_t)(data - chunk - 8));
+			memcpy(chunk + 4, "IDAT", 4);
+			WriteUInt32BE(data, (uint32_t)mz_crc32(MZ_CRC32_INIT, chunk + 4, data - chunk - 4));
+			output = data + 4;
+		}
+
+		// IEND
+		WriteUInt32BE(output, 0);
+		memcpy(output + 4, "IEND", 4);
+		WriteUInt32BE(output + 8, (uint32_t)mz_crc32(MZ_CRC32_INIT, output + 4, 4));
+
+		return S_OK;
+	}
+	catch (...)
+	{
+		blob.Release();
+		return E_OUTOFMEMORY;
+	}
+}
+
+HRESULT PhilLibX::Imaging::PngCodec::Decode(const uint8_t* buffer, size_t length, DirectX::ScratchImage& image)
+{
+	// Validate it
+	if (!buffer)
+		return E_POINTER;
+	if (length < sizeof(Signature) + 25 || memcmp(buffer, Signature, sizeof(Signature)) != 0)
+		return E_FAIL;
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	int bitDepth = 0;
+	int colorType = -1;
+	uint8_t palette[256 * 4];
+	memset(palette, 0xFF, sizeof(palette));
+	// Gray or RGB sample that is transparent, from tRNS
+	uint16_t key[3] = {};
+	bool hasKey = false;
+
+	try
+	{
+		std::vector<uint8_t> compressed;
+
+		// Read the chunks we need
+		for (size_t offset = sizeof(Signature); offset + 12 <= length;)
+		{
+			size_t chunkSize = ReadUInt32BE(buffer + offset);
+			const uint8_t* type = buffer + offset + 4;
+			const uint8_t* data = buffer + offset + 8;
+
+			if (chunkSize > length - offset - 12)
+				return E_FAIL;
+
+			if (memcmp(type, "IHDR", 4) == 0)
+			{
+				if (chunkSize < 13)
+					return E_FAIL;
+
+				width = ReadUInt32BE(data);
+				height = ReadUInt32BE(data + 4);
+				bitDepth = data[8];
+				colorType = data[9];
+
+				// Compression and filter method must be 0, Adam7 isn't handled
+				if (data[10] != 0 || data[11] != 0 || data[12] != 0)
+					return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+			}
+			else if (memcmp(type, "PLTE", 4) == 0)
+			{
+				for (size_t i = 0; i < chunkSize / 3 && i < 256; i++)
+					memcpy(palette + i * 4, data + i * 3, 3);
+			}
+			else if (memcmp(type, "tRNS", 4) == 0)
+			{
+				// Palettes get an alpha per entry, gray and RGB a single transparent sample
+				if (colorType == 3)
+				{
+					for (size_t i = 0; i < chunkSize && i < 256; i++)
+						palette[i * 4 + 3] = data[i];
+				}
+				else if (colorType == 0 && chunkSize >= 2)
+				{
+					key[0] = ReadUInt16BE(data);
+					hasKey = true;
+				}
+				else if (colorType == 2 && chunkSize >= 6)
+				{
+					for (size_t c = 0; c < 3; c++)
+						key[c] = ReadUInt16BE(data + c * 2);
+					hasKey = true;
+				}
+			}
+			else if (memcmp(type, "IDAT", 4) == 0)
+			{
+				compressed.insert(compressed.end(), data, data + chunkSize);
+			}
+			else if (memcmp(type, "IEND", 4) == 0)
+			{
+				break;
+			}
+
+			offset += chunkSize + 12;
+		}
+
+		if (width == 0 || height == 0 || compressed.empty())
+			return E_FAIL;
+
+		size_t channels;
+		switch (colorType)
+		{
+		case 0: channels = 1; break;
+		case 2: channels = 3; break;
+		case 3: channels = 1; break;
+		case 4: channels = 2; break;
+		case 6: channels = 4; break;
+		default: return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+		}
+
+		bool validDepth =
+			bitDepth == 8 ||
+			(bitDepth == 16 && colorType != 3) ||
+			((bitDepth == 1 || bitDepth == 2 || bitDepth == 4) && (colorType == 0 || colorType == 3));
+		if (!validDepth)
+			return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+		// Gray with a transparent sample needs an alpha channel, so goes to RGBA
+		DXGI_FORMAT format;
+		if (colorType == 0 && !hasKey)
+			format = bitDepth == 16 ? DXGI_FORMAT_R16_UNORM : DXGI_FORMAT_R8_UNORM;
+		else
+			format = bitDepth == 16 ? DXGI_FORMAT_R16G16B16A16_UNORM : DXGI_FORMAT_R8G8B8A8_UNORM;
+
+		size_t bitsPerPixel = channels * bitDepth;
+		size_t pixelSize = (std::max<size_t>)(1, bitsPerPixel / 8);
+		size_t rowSize = ((size_t)width * bitsPerPixel + 7) / 8;
+
+		// Inflate every row and its filter byte at once
+		std::vector<uint8_t> filtered(((size_t)rowSize + 1) * height);
+		size_t inflated = tinfl_decompress_mem_to_mem(filtered.data(), filtered.size(), compressed.data(), compressed.size(), TINFL_FLAG_PARSE_ZLIB_HEADER);
+		if (inflated != filtered.size())
+			return E_FAIL;
+
+		compressed.clear();
+		compressed.shrink_to_fit();
+
+		HRESULT result = image.Initialize2D(format, width, height, 1, 1);
+		if (FAILED(result))
+			return result;
+
+		const DirectX::Image* dest = image.GetImage(0, 0, 0);
+		std::vector<uint8_t> zeroRow(rowSize);
+		const uint8_t* prior = zeroRow.data();
+
+		for (uint32_t y = 0; y < height; y++)
+		{
+			uint8_t* row = filtered.data() + y * (rowSize + 1);
+
+			if (!UnfilterRow(row[0], row + 1, prior, rowSize, pixelSize))
+			{
+				image.Release();
+				return E_FAIL;
+			}
+
+			ExpandRow(dest->pixels + dest->rowPitch * y, row + 1, width, colorType, bitDepth, palette, hasKey ? key : nullptr);
+			prior = row + 1;
+		}
+
+		return S_OK;
+	}
+	catch (...)
+	{
+		image.Release();
+		return E_OUTOFMEMORY;
+	}
+}
+
+#pragma managed(pop)
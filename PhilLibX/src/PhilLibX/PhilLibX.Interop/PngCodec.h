@@ -0,0 +1,59 @@
+// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: PngCodec.h
+// Author: Philip/Scobalula
+// Description: A PNG encoder/decoder built on MiniZ that doesn't use WIC
+#pragma once
+
+namespace PhilLibX
+{
+	namespace Imaging
+	{
+		/// <summary>
+		/// A PNG encoder/decoder built on MiniZ that doesn't use WIC
+		///
+		/// Each row is filtered with every PNG filter and the one with the smallest sum of absolute
+		/// values is kept. The image is deflated in strips on the thread pool, each strip ends on a
+		/// sync flush so they join into one zlib stream.
+		/// </summary>
+		class PngCodec
+		{
+		public:
+			/// <summary>
+			/// Encodes an R8G8B8A8, B8G8R8A8, R16G16B16A16, R8 or R16 image to a PNG file in memory
+			/// </summary>
+			/// <param name="image">Image to encode</param>
+			/// <param name="level">Deflate level, 1 is the fastest, 9 is the smallest</param>
+			/// <param name="blob">Blob to store the file in</param>
+			static HRESULT Encode(const DirectX::Image& image, int level, DirectX::Blob& blob);
+
+			/// <summary>
+			/// Decodes a PNG file in memory, interlaced files return ERROR_NOT_SUPPORTED
+			/// </summary>
+			/// <param name="buffer">PNG file buffer</param>
+			/// <param name="length">Length of the buffer in bytes</param>
+			/// <param name="image">Image to decode to, R8G8B8A8, R16G16B16A16, R8 or R16, gray with a tRNS key decodes to RGBA</param>
+			static HRESULT Decode(const uint8_t* buffer, size_t length, DirectX::ScratchImage& image);
+		};
+	}
+}
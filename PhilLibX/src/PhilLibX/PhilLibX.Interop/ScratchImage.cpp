@@ -4,9 +4,158 @@
 #pragma warning(disable : 4561) // __fastcall' incompatible with the '/clr' option: converting to '__stdcall
 #include "DirectXTex.h"
 #include "InteropUtility.h"
+#include "ScratchImagePool.h"
+#include "PngCodec.h"
 #include "ScratchImage.h"
 #include "DirectXException.h"
 
+#pragma managed(push, off)
+/// <summary>
+/// Copies 32bpp rows, optionally swapping the red and blue channels
+/// </summary>
+static void CopyRows32(const uint8_t* source, size_t sourcePitch, uint8_t* dest, size_t destPitch, size_t width, size_t height, bool swapRedBlue)
+{
+	for (size_t y = 0; y < height; y++)
+	{
+		auto sourceRow = (const uint32_t*)(source + y * sourcePitch);
+		auto destRow = (uint32_t*)(dest + y * destPitch);
+
+		if (!swapRedBlue)
+		{
+			memcpy(destRow, sourceRow, width * 4);
+			continue;
+		}
+
+		// Simple enough for the compiler to vectorize
+		for (size_t x = 0; x < width; x++)
+		{
+			uint32_t pixel = sourceRow[x];
+			destRow[x] = (pixel & 0xFF00FF00) | ((pixel >> 16) & 0xFF) | ((pixel & 0xFF) << 16);
+		}
+	}
+}
+
+/// <summary>
+/// Gets the format a PNG can store the given format in, single channel formats go to gray and
+/// anything over 8 bits per channel goes to 16-bit so neither loses channels or precision
+/// </summary>
+static DXGI_FORMAT GetPNGFormat(DXGI_FORMAT format)
+{
+	bool wide = DirectX::BitsPerColor(format) > 8;
+
+	switch (format)
+	{
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+	case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+	case DXGI_FORMAT_B8G8R8A8_UNORM:
+	case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+	case DXGI_FORMAT_R16G16B16A16_UNORM:
+	case DXGI_FORMAT_R8_UNORM:
+	case DXGI_FORMAT_R16_UNORM:
+		return format;
+	case DXGI_FORMAT_R32_FLOAT:
+	case DXGI_FORMAT_R32_UINT:
+	case DXGI_FORMAT_R32_SINT:
+	case DXGI_FORMAT_D32_FLOAT:
+	case DXGI_FORMAT_R16_FLOAT:
+	case DXGI_FORMAT_R16_UINT:
+	case DXGI_FORMAT_R16_SNORM:
+	case DXGI_FORMAT_R16_SINT:
+	case DXGI_FORMAT_D16_UNORM:
+	case DXGI_FORMAT_R8_UINT:
+	case DXGI_FORMAT_R8_SNORM:
+	case DXGI_FORMAT_R8_SINT:
+	case DXGI_FORMAT_BC4_UNORM:
+	case DXGI_FORMAT_BC4_SNORM:
+		return wide ? DXGI_FORMAT_R16_UNORM : DXGI_FORMAT_R8_UNORM;
+	default:
+		if (wide)
+			return DXGI_FORMAT_R16G16B16A16_UNORM;
+		return DirectX::IsSRGB(format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+	}
+}
+
+/// <summary>
+/// Saves the image to a PNG file with MiniZ, 8 and 16-bit gray and RGBA are encoded directly, everything else is
+/// converted to the nearest of those first
+/// </summary>
+static HRESULT SaveToPNGFile(const DirectX::Image& image, int level, const wchar_t* filePath)
+{
+	HRESULT result;
+	DirectX::ScratchImage converted;
+	const DirectX::Image* source = &image;
+	DXGI_FORMAT format = GetPNGFormat(image.format);
+
+	if (format != image.format)
+	{
+		if (DirectX::IsCompressed(image.format))
+			result = DirectX::Decompress(image, format, converted);
+		else
+			result = DirectX::Convert(image, format, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+		if (FAILED(result))
+			return result;
+		source = converted.GetImage(0, 0, 0);
+	}
+
+	DirectX::Blob blob;
+	result = PhilLibX::Imaging::PngCodec::Encode(*source, level, blob);
+	if (FAILED(result))
+		return result;
+
+	HANDLE file = CreateFileW(filePath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return HRESULT_FROM_WIN32(GetLastError());
+
+	DWORD written = 0;
+	BOOL success = WriteFile(file, blob.GetBufferPointer(), (DWORD)blob.GetBufferSize(), &written, nullptr);
+	result = !success ? HRESULT_FROM_WIN32(GetLastError()) : written != blob.GetBufferSize() ? E_FAIL : S_OK;
+	CloseHandle(file);
+
+	if (FAILED(result))
+		DeleteFileW(filePath);
+
+	return result;
+}
+#pragma managed(pop)
+
+/// <summary>
+/// Writes the image as 32bpp B8G8R8A8 rows, 8-bit RGBA/BGRA is copied directly, everything else is converted first,
+/// SRGB sources are converted to SRGB so the stored values come through without a gamma shift
+/// </summary>
+static void WriteImageBGRA(const DirectX::Image& img, uint8_t* dest, size_t destPitch)
+{
+	switch (img.format)
+	{
+	case DXGI_FORMAT_B8G8R8A8_UNORM:
+	case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+		CopyRows32(img.pixels, img.rowPitch, dest, destPitch, img.width, img.height, false);
+		return;
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+	case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		CopyRows32(img.pixels, img.rowPitch, dest, destPitch, img.width, img.height, true);
+		return;
+	}
+
+	// Results
+	HRESULT result;
+	// Converted Image
+	DirectX::ScratchImage converted;
+	// Keep the source's color space, the bitmap just takes the bytes as they are
+	DXGI_FORMAT format = DirectX::IsSRGB(img.format) ? DXGI_FORMAT_B8G8R8A8_UNORM_SRGB : DXGI_FORMAT_B8G8R8A8_UNORM;
+
+	if (DirectX::IsCompressed(img.format))
+		result = DirectX::Decompress(img, format, converted);
+	else
+		result = DirectX::Convert(img, format, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+
+	// Check result
+	if (FAILED(result))
+		throw gcnew DirectXException(String::Format("Failed to convert the image to B8G8R8A8, return code: 0x{0:X}", result));
+
+	auto convertedImage = converted.GetImage(0, 0, 0);
+	CopyRows32(convertedImage->pixels, convertedImage->rowPitch, dest, destPitch, convertedImage->width, convertedImage->height, false);
+}
+
 PhilLibX::Imaging::ScratchImage::ScratchImage(Metadata^ metaData)
 {
 	InitializeImage(metaData);
@@ -32,10 +181,27 @@ PhilLibX::Imaging::ScratchImage::ScratchImage(String^ filePath, ImageFormat form
 	Load(filePath, format);
 }
 
+PhilLibX::Imaging::ScratchImage::ScratchImage(DirectX::ScratchImage* image)
+{
+	SetImage(image);
+}
+
 
 PhilLibX::Imaging::ScratchImage::~ScratchImage()
 {
+	this->!ScratchImage();
+}
+
+PhilLibX::Imaging::ScratchImage::!ScratchImage()
+{
+	ClearLoadedImage();
+}
+
+void PhilLibX::Imaging::ScratchImage::SetImage(DirectX::ScratchImage* image)
+{
+	// Delete the current one, its pixels go back to the pool
 	ClearLoadedImage();
+	ScratchImagePointer = image;
 }
 
 void PhilLibX::Imaging::ScratchImage::InitializeImage(Metadata^ metaData)
@@ -72,11 +238,26 @@ void PhilLibX::Imaging::ScratchImage::InitializeImage(Metadata^ metaData)
 		throw gcnew DirectXException(String::Format("Failed to initialize DirectX::ScratchImage with the metadata, return code: 0x{0:X}", result));
 
 	// Set it
-	ScratchImagePointer = scratchImage.release();
+	SetImage(scratchImage.release());
 }
 
 void PhilLibX::Imaging::ScratchImage::InitializeImage(Metadata^ metaData, array<Byte>^ buffer)
 {
+	// Validate it
+	if (!buffer || buffer->Length == 0)
+		throw gcnew ArgumentException("Pixel buffer is null or empty", "buffer");
+
+	// Pin it and copy straight from it
+	pin_ptr<Byte> bufferPtr = &buffer[0];
+	InitializeImage(metaData, IntPtr(bufferPtr), (Int64)buffer->Length);
+}
+
+void PhilLibX::Imaging::ScratchImage::InitializeImage(Metadata^ metaData, IntPtr buffer, Int64 length)
+{
+	// Validate it
+	if (buffer == IntPtr::Zero)
+		throw gcnew ArgumentNullException("buffer");
+
 	// Call base init
 	InitializeImage(metaData);
 
@@ -85,21 +266,59 @@ void PhilLibX::Imaging::ScratchImage::InitializeImage(Metadata^ metaData, array<
 		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::ScratchImage, result returned nullptr"));
 
 	// Validate the size
-	if(buffer->Length < (int)ScratchImagePointer->GetPixelsSize())
+	if(length < (Int64)ScratchImagePointer->GetPixelsSize())
 		throw gcnew DirectXException(String::Format("Input buffer size is less than DirectX::ScratchImage->GetPixelsSize()"));
 
 	// Copy Raw Data
-	Marshal::Copy(buffer, 0, IntPtr(ScratchImagePointer->GetPixels()), (int)ScratchImagePointer->GetPixelsSize());
+	memcpy(ScratchImagePointer->GetPixels(), buffer.ToPointer(), ScratchImagePointer->GetPixelsSize());
+}
+
+PhilLibX::Imaging::ScratchImage::ImageSpan PhilLibX::Imaging::ScratchImage::GetImageSpan(int mip, int item, int slice)
+{
+	// Validate it
+	if (!ScratchImagePointer)
+		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::ScratchImage, result returned nullptr"));
+
+	// Get the image
+	const DirectX::Image* img = ScratchImagePointer->GetImage((size_t)mip, (size_t)item, (size_t)slice);
+
+	// Validate it
+	if (!img)
+		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::Image, result returned nullptr"));
+
+	ImageSpan span;
+
+	span.Pixels     = IntPtr(img->pixels);
+	span.Width      = (Int64)img->width;
+	span.Height     = (Int64)img->height;
+	span.RowPitch   = (Int64)img->rowPitch;
+	span.SlicePitch = (Int64)img->slicePitch;
+	span.Format     = (DXGIFormat)img->format;
+
+	return span;
 }
 
 void PhilLibX::Imaging::ScratchImage::ClearLoadedImage()
 {
 	// Validate it and delete it if need be
 	if (ScratchImagePointer)
-		ScratchImagePointer->Release();
+	{
+		delete ScratchImagePointer;
+		ScratchImagePointer = nullptr;
+	}
 }
 
 void PhilLibX::Imaging::ScratchImage::ConvertImage(DXGIFormat format)
+{
+	ConvertImage(format, CompressionQuality::Default, false);
+}
+
+void PhilLibX::Imaging::ScratchImage::ConvertImage(DXGIFormat format, CompressionQuality quality)
+{
+	ConvertImage(format, quality, false);
+}
+
+void PhilLibX::Imaging::ScratchImage::ConvertImage(DXGIFormat format, CompressionQuality quality, bool parallelCompress)
 {
 	// Validate it
 	if (!ScratchImagePointer)
@@ -124,7 +343,7 @@ void PhilLibX::Imaging::ScratchImage::ConvertImage(DXGIFormat format)
 		if (FAILED(result))
 			throw gcnew Exception(String::Format("Failed to decompress image, return code: 0x{0:X}", result));
 		// Set it
-		ScratchImagePointer = newImage.release();
+		SetImage(newImage.release());
 
 	}
 	// Check is the image decompress, if not, compress it if necessary
@@ -135,13 +354,19 @@ void PhilLibX::Imaging::ScratchImage::ConvertImage(DXGIFormat format)
 		// Validate it
 		if (!newImage)
 			throw gcnew Exception("Failed to create new scratch image for image compression");
-		// Decompress the image
-		result = DirectX::Compress(ScratchImagePointer->GetImages(), ScratchImagePointer->GetImageCount(), metaData, (DXGI_FORMAT)format, DirectX::TEX_FILTER_FLAGS::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, *newImage);
+		// Build the compression flags, only BC6H/BC7 look at the quality
+		DWORD compressFlags = parallelCompress ? DirectX::TEX_COMPRESS_PARALLEL : DirectX::TEX_COMPRESS_DEFAULT;
+		if (quality == CompressionQuality::Fast)
+			compressFlags |= DirectX::TEX_COMPRESS_BC_FAST;
+		else if (quality == CompressionQuality::Quick)
+			compressFlags |= DirectX::TEX_COMPRESS_BC7_QUICK | DirectX::TEX_COMPRESS_BC_FAST;
+		// Compress the image
+		result = DirectX::Compress(ScratchImagePointer->GetImages(), ScratchImagePointer->GetImageCount(), metaData, (DXGI_FORMAT)format, compressFlags, DirectX::TEX_THRESHOLD_DEFAULT, *newImage);
 		// Check result
 		if (FAILED(result))
 			throw gcnew Exception(String::Format("Failed to compress image, return code: 0x{0:X}", result));
 		// Set it
-		ScratchImagePointer = newImage.release();
+		SetImage(newImage.release());
 	}
 	// Convert it
 	else if (metaData.format != (DXGI_FORMAT)format)
@@ -157,7 +382,7 @@ void PhilLibX::Imaging::ScratchImage::ConvertImage(DXGIFormat format)
 		if (FAILED(result))
 			throw gcnew Exception(String::Format("Failed to convert image, return code: 0x{0:X}", result));
 		// Set it
-		ScratchImagePointer = newImage.release();
+		SetImage(newImage.release());
 	}
 }
 
@@ -180,7 +405,7 @@ void PhilLibX::Imaging::ScratchImage::Resize(int width, int height)
 		throw gcnew Exception(String::Format("Failed to resize image, return code: 0x{0:X}", result));
 
 	// Set it
-	ScratchImagePointer = newImage.release();
+	SetImage(newImage.release());
 }
 
 void PhilLibX::Imaging::ScratchImage::GenerateMipMaps(int mipMapCount)
@@ -202,18 +427,30 @@ void PhilLibX::Imaging::ScratchImage::GenerateMipMaps(int mipMapCount)
 		throw gcnew Exception(String::Format("Failed to generated mip maps, return code: 0x{0:X}", result));
 
 	// Set it
-	ScratchImagePointer = newImage.release();
+	SetImage(newImage.release());
 }
 
 void PhilLibX::Imaging::ScratchImage::Load(array<Byte>^ buffer, ImageFormat format)
 {
+	// Validate it
+	if (!buffer || buffer->Length == 0)
+		throw gcnew ArgumentException("Image buffer is null or empty", "buffer");
+
+	// Pin it and let DirectXTex read it in place
+	pin_ptr<Byte> bufferPtr = &buffer[0];
+	Load(IntPtr(bufferPtr), (Int64)buffer->Length, format);
+}
+
+void PhilLibX::Imaging::ScratchImage::Load(IntPtr buffer, Int64 length, ImageFormat format)
+{
+	// Validate it
+	if (buffer == IntPtr::Zero || length <= 0)
+		throw gcnew ArgumentException("Image buffer is null or empty", "buffer");
+
 	// Results
 	HRESULT result;
-
-	// Unmanaged Buffer
-	std::unique_ptr<uint8_t[]> bufferPtr(new uint8_t[buffer->Length]);
-	// Copy it
-	Marshal::Copy(buffer, 0, IntPtr(bufferPtr.get()), buffer->Length);
+	// Native Buffer
+	auto bufferPtr = (const uint8_t*)buffer.ToPointer();
 
 	// Create Scratch Image
 	std::unique_ptr<DirectX::ScratchImage> scratchImage(new (std::nothrow) DirectX::ScratchImage);
@@ -227,24 +464,35 @@ void PhilLibX::Imaging::ScratchImage::Load(array<Byte>^ buffer, ImageFormat form
 	case ImageFormat::DDS:
 	{
 		// Load it
-		result = DirectX::LoadFromDDSMemory(bufferPtr.get(), (size_t)buffer->Length, DirectX::DDS_FLAGS::DDS_FLAGS_NONE, nullptr, *scratchImage);
+		result = DirectX::LoadFromDDSMemory(bufferPtr, (size_t)length, DirectX::DDS_FLAGS::DDS_FLAGS_NONE, nullptr, *scratchImage);
+		// Done
+		break;
+	}
+	case ImageFormat::PNG:
+	{
+		// Decode it with MiniZ, WIC handles what it doesn't (interlaced files)
+		result = PngCodec::Decode(bufferPtr, (size_t)length, *scratchImage);
+		if (result != HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED))
+			break;
+		scratchImage->Release();
+		// Load it
+		result = DirectX::LoadFromWICMemory(bufferPtr, (size_t)length, DirectX::WIC_FLAGS_NONE, nullptr, *scratchImage);
 		// Done
 		break;
 	}
 	case ImageFormat::TIF:
 	case ImageFormat::JPG:
-	case ImageFormat::PNG:
 	case ImageFormat::BMP:
 	{
 		// Load it
-		result = DirectX::LoadFromWICMemory(bufferPtr.get(), (size_t)buffer->Length, DirectX::WIC_FLAGS_NONE, nullptr, *scratchImage);
+		result = DirectX::LoadFromWICMemory(bufferPtr, (size_t)length, DirectX::WIC_FLAGS_NONE, nullptr, *scratchImage);
 		// Done
 		break;
 	}
 	case ImageFormat::TGA:
 	{
 		// Load it
-		result = DirectX::LoadFromTGAMemory(bufferPtr.get(), (size_t)buffer->Length, nullptr, *scratchImage);
+		result = DirectX::LoadFromTGAMemory(bufferPtr, (size_t)length, nullptr, *scratchImage);
 		// Done
 		break;
 	}
@@ -254,7 +502,7 @@ void PhilLibX::Imaging::ScratchImage::Load(array<Byte>^ buffer, ImageFormat form
 		throw gcnew Exception(String::Format("Failed to save image, return code: 0x{0:X}", result));
 
 	// Set it
-	ScratchImagePointer = scratchImage.release();
+	SetImage(scratchImage.release());
 }
 
 void PhilLibX::Imaging::ScratchImage::Load(String^ filePath)
@@ -264,6 +512,13 @@ void PhilLibX::Imaging::ScratchImage::Load(String^ filePath)
 
 void PhilLibX::Imaging::ScratchImage::Load(String^ filePath, ImageFormat format)
 {
+	// PNGs are decoded from memory
+	if (format == ImageFormat::PNG)
+	{
+		Load(System::IO::File::ReadAllBytes(filePath), format);
+		return;
+	}
+
 	// Results
 	HRESULT result;
 	// Output Path
@@ -289,7 +544,6 @@ void PhilLibX::Imaging::ScratchImage::Load(String^ filePath, ImageFormat format)
 	}
 	case ImageFormat::TIF:
 	case ImageFormat::JPG:
-	case ImageFormat::PNG:
 	case ImageFormat::BMP:
 	{
 		// Save it
@@ -311,7 +565,7 @@ void PhilLibX::Imaging::ScratchImage::Load(String^ filePath, ImageFormat format)
 		throw gcnew Exception(String::Format("Failed to save image, return code: 0x{0:X}", result));
 
 	// Set it
-	ScratchImagePointer = scratchImage.release();
+	SetImage(scratchImage.release());
 }
 
 void PhilLibX::Imaging::ScratchImage::Save(String^ filePath)
@@ -321,6 +575,15 @@ void PhilLibX::Imaging::ScratchImage::Save(String^ filePath)
 
 void PhilLibX::Imaging::ScratchImage::Save(String^ filePath, ImageFormat format)
 {
+	Save(filePath, format, PngCompression::Default);
+}
+
+void PhilLibX::Imaging::ScratchImage::Save(String^ filePath, ImageFormat format, PngCompression compression)
+{
+	// Resolve it
+	if (format == ImageFormat::Automatic)
+		format = GetImageFormatForExtension(System::IO::Path::GetExtension(filePath));
+
 	// Validate it
 	if (!ScratchImagePointer)
 		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::ScratchImage, result returned nullptr"));
@@ -365,8 +628,13 @@ void PhilLibX::Imaging::ScratchImage::Save(String^ filePath, ImageFormat format)
 	}
 	case ImageFormat::PNG:
 	{
+		// Deflate levels for each compression setting
+		const int levels[] = { 6, 3, 1, 9 };
+		// Validate it
+		if ((int)compression < 0 || (int)compression >= (int)_countof(levels))
+			throw gcnew ArgumentOutOfRangeException("compression");
 		// Save it
-		result = DirectX::SaveToWICFile(*images, DirectX::WIC_FLAGS::WIC_FLAGS_NONE, DirectX::GetWICCodec(DirectX::WIC_CODEC_PNG), filePathStd.data());
+		result = SaveToPNGFile(*images, levels[(int)compression], filePathStd.data());
 		// Done
 		break;
 	}
@@ -391,6 +659,28 @@ void PhilLibX::Imaging::ScratchImage::Save(String^ filePath, ImageFormat format)
 		throw gcnew Exception(String::Format("Failed to save image, return code: 0x{0:X}", result));
 }
 
+PhilLibX::Imaging::ScratchImage::Metadata^ PhilLibX::Imaging::ScratchImage::GetMetadata()
+{
+	// Validate it
+	if (!ScratchImagePointer)
+		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::ScratchImage, result returned nullptr"));
+
+	auto nativeMetadata = ScratchImagePointer->GetMetadata();
+	auto metaData = gcnew Metadata();
+
+	metaData->Width      = (UInt64)nativeMetadata.width;
+	metaData->Height     = (UInt64)nativeMetadata.height;
+	metaData->Depth      = (UInt64)nativeMetadata.depth;
+	metaData->ArraySize  = (UInt64)nativeMetadata.arraySize;
+	metaData->MipLevels  = (UInt64)nativeMetadata.mipLevels;
+	metaData->MiscFlags  = (TexMiscFlags)nativeMetadata.miscFlags;
+	metaData->MiscFlags2 = (TexMiscFlags2)nativeMetadata.miscFlags2;
+	metaData->Format     = (DXGIFormat)nativeMetadata.format;
+	metaData->Dimension  = (TexDimension)nativeMetadata.dimension;
+
+	return metaData;
+}
+
 Bitmap^ PhilLibX::Imaging::ScratchImage::ToBitmap()
 {
 	return ToBitmap(0, 0, 0);
@@ -402,30 +692,64 @@ Bitmap^ PhilLibX::Imaging::ScratchImage::ToBitmap(int mip, int item, int slice)
 	if (!ScratchImagePointer)
 		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::ScratchImage, result returned nullptr"));
 
-	// Results
-	HRESULT result;
-
-	// Create blob
-	DirectX::Blob blob;
-	// Get the first image
+	// Get the image
 	const DirectX::Image* img = ScratchImagePointer->GetImage((size_t)mip, (size_t)item, (size_t)slice);
 
 	// Validate it
 	if (!img)
 		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::Image, result returned nullptr"));
 
-	// Save to PNG in-memory, then pass to .NET (let the DX Lib handle it)
-	result = DirectX::SaveToWICMemory(*img, DirectX::WIC_FLAGS_NONE, DirectX::GetWICCodec(DirectX::WIC_CODEC_PNG), blob);
-	// Check result
-	if (FAILED(result))
-		throw gcnew DirectXException(String::Format("Failed to save the WIC Image to memory via DirectX::SaveToWICMemory(...), return code: 0x{0:X}", result));
+	// 32bpp ARGB is B8G8R8A8 in memory, so we can write straight into the bitmap's bits
+	auto bitmap = gcnew Bitmap((int)img->width, (int)img->height, System::Drawing::Imaging::PixelFormat::Format32bppArgb);
 
-	// Allocate an array and copy into it
-	auto buffer = gcnew array<Byte>((int)blob.GetBufferSize());
-	Marshal::Copy(IntPtr(blob.GetBufferPointer()), buffer, 0, (int)buffer->Length);
+	try
+	{
+		auto bits = bitmap->LockBits(
+			System::Drawing::Rectangle(0, 0, (int)img->width, (int)img->height),
+			System::Drawing::Imaging::ImageLockMode::WriteOnly,
+			System::Drawing::Imaging::PixelFormat::Format32bppArgb);
+
+		try
+		{
+			WriteImageBGRA(*img, (uint8_t*)bits->Scan0.ToPointer(), (size_t)bits->Stride);
+		}
+		finally
+		{
+			bitmap->UnlockBits(bits);
+		}
+	}
+	catch (System::Exception^)
+	{
+		// Nobody else has the bitmap yet, so release it before passing the error on
+		delete bitmap;
+		throw;
+	}
 
 	// Return result
-	return gcnew Bitmap(gcnew System::IO::MemoryStream(buffer));
+	return bitmap;
 }
 
+void PhilLibX::Imaging::ScratchImage::CopyPixelsBGRA(int mip, int item, int slice, IntPtr buffer, int bufferSize, int stride)
+{
+	// Validate it
+	if (!ScratchImagePointer)
+		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::ScratchImage, result returned nullptr"));
 
+	// Get the image
+	const DirectX::Image* img = ScratchImagePointer->GetImage((size_t)mip, (size_t)item, (size_t)slice);
+
+	// Validate it
+	if (!img)
+		throw gcnew DirectXException(String::Format("Failed to aquire DirectX::Image, result returned nullptr"));
+
+	// Validate the buffer
+	if (buffer == IntPtr::Zero)
+		throw gcnew ArgumentNullException("buffer");
+	// Checked as signed first, a negative stride or size would pass once cast to size_t, both throw with E_INVALIDARG
+	if (stride <= 0 || (size_t)stride < img->width * 4)
+		throw gcnew ArgumentException("Stride is not positive or is less than the width of the image * 4", "stride");
+	if (bufferSize <= 0 || (size_t)bufferSize < (size_t)stride * (img->height - 1) + img->width * 4)
+		throw gcnew ArgumentException("Buffer is too small for the image at the given stride", "bufferSize");
+
+	WriteImageBGRA(*img, (uint8_t*)buffer.ToPointer(), (size_t)stride);
+}
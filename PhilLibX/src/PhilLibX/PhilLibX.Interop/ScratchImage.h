@@ -44,6 +44,12 @@ namespace PhilLibX
 			/// </summary>
 			DirectX::ScratchImage* ScratchImagePointer;
 
+			/// <summary>
+			/// Takes ownership of the given native DirectX::ScratchImage, deleting the current one
+			/// </summary>
+			/// <param name="image">Image to take ownership of</param>
+			void SetImage(DirectX::ScratchImage* image);
+
 			/// <summary>
 			/// Sets custom properties for JPG Images (for use with LoadFromWICMemory(...))
 			/// </summary>
@@ -72,6 +78,40 @@ namespace PhilLibX
 				(void)props->Write(1, &options, &varValues);
 			}
 		public:
+			/// <summary>
+			/// Gets the number of bytes of pixel memory currently held by all images
+			/// </summary>
+			static property Int64 CurrentBytes { Int64 get() { return ScratchImagePool::GetCurrentBytes(); } }
+
+			/// <summary>
+			/// Gets the highest number of bytes of pixel memory held by all images at once
+			/// </summary>
+			static property Int64 PeakBytes { Int64 get() { return ScratchImagePool::GetPeakBytes(); } }
+
+			/// <summary>
+			/// Gets the number of bytes of freed pixel memory kept for reuse
+			/// </summary>
+			static property Int64 PooledBytes { Int64 get() { return ScratchImagePool::GetPooledBytes(); } }
+
+			/// <summary>
+			/// Gets or Sets the maximum number of bytes of freed pixel memory kept for reuse
+			/// </summary>
+			static property Int64 MaxPooledBytes
+			{
+				Int64 get() { return ScratchImagePool::GetMaxPooledBytes(); }
+				void set(Int64 value) { ScratchImagePool::SetMaxPooledBytes(value); }
+			}
+
+			/// <summary>
+			/// Frees all pixel memory kept for reuse
+			/// </summary>
+			static void TrimPool() { ScratchImagePool::Trim(); }
+
+			/// <summary>
+			/// Resets <see cref="PeakBytes"/> to <see cref="CurrentBytes"/>
+			/// </summary>
+			static void ResetPeakBytes() { ScratchImagePool::ResetPeakBytes(); }
+
 			/// <summary>
 			/// DDS/DXGI Formats
 			/// </summary>
@@ -239,6 +279,34 @@ namespace PhilLibX
 				BMP,
 			};
 
+			/// <summary>
+			/// BC6H/BC7 compression quality
+			/// </summary>
+			enum class CompressionQuality
+			{
+				// Full mode and partition search
+				Default,
+				// Best partition only, restricted BC7 modes and an early-out on small errors
+				Fast,
+				// BC7 mode 6 only, for previews
+				Quick,
+			};
+
+			/// <summary>
+			/// PNG deflate level
+			/// </summary>
+			enum class PngCompression
+			{
+				// Level 6
+				Default,
+				// Level 3
+				Fast,
+				// Level 1, for previews and intermediate files
+				Fastest,
+				// Level 9
+				Best,
+			};
+
 			/// <summary>
 			/// Gets the output format for the given extension, if unrecognized, DDS is returned
 			/// </summary>
@@ -283,6 +351,19 @@ namespace PhilLibX
 				TexDimension Dimension;
 			};
 
+			/// <summary>
+			/// A view of a single native image's pixel memory, valid until the <see cref="ScratchImage"/> is changed or cleared
+			/// </summary>
+			value struct ImageSpan
+			{
+				IntPtr Pixels;
+				Int64 Width;
+				Int64 Height;
+				Int64 RowPitch;    // Bytes per row, or per row of blocks for compressed formats
+				Int64 SlicePitch;  // Bytes in the whole image
+				DXGIFormat Format;
+			};
+
 			/// <summary>
 			/// Initializes an instance of the <see cref="ScratchImage"/> class with the given params
 			/// </summary>
@@ -329,6 +410,14 @@ namespace PhilLibX
 			/// <param name="buffer">Pixel buffer to apply to the image</param>
 			void InitializeImage(Metadata^ metaData, array<Byte>^ buffer);
 
+			/// <summary>
+			/// Initializes the native DirectX::ScratchImage with the params and given raw image buffer, copying it directly from the pointer
+			/// </summary>
+			/// <param name="metaData">Metadata to initialize the image with</param>
+			/// <param name="buffer">Pointer to the pixel buffer, i.e. pinned or memory-mapped data</param>
+			/// <param name="length">Length of the pixel buffer in bytes</param>
+			void InitializeImage(Metadata^ metaData, IntPtr buffer, Int64 length);
+
 			/// <summary>
 			/// Destructs the currently loaded native DirectX::ScratchImage
 			/// </summary>
@@ -340,6 +429,30 @@ namespace PhilLibX
 			/// <param name="format"><see cref="DXGIFormat"/><see cref="DXGIFormat"/> to convert the image to</param>
 			void ConvertImage(DXGIFormat format);
 
+			/// <summary>
+			/// Converts the native DirectX::ScratchImage to the given format with the given BC6H/BC7 compression quality
+			/// </summary>
+			/// <param name="format"><see cref="DXGIFormat"/> to convert the image to</param>
+			/// <param name="quality"><see cref="CompressionQuality"/> to compress with if the format is BC6H/BC7</param>
+			void ConvertImage(DXGIFormat format, CompressionQuality quality);
+
+		internal:
+			/// <summary>
+			/// Converts the native DirectX::ScratchImage to the given format, optionally compressing blocks with OpenMP
+			/// </summary>
+			/// <param name="format"><see cref="DXGIFormat"/> to convert the image to</param>
+			/// <param name="quality"><see cref="CompressionQuality"/> to compress with if the format is BC6H/BC7</param>
+			/// <param name="parallelCompress">Whether or not to compress across OpenMP threads</param>
+			void ConvertImage(DXGIFormat format, CompressionQuality quality, bool parallelCompress);
+
+			/// <summary>
+			/// Initializes an instance of the <see cref="ScratchImage"/> class that takes ownership of the given native DirectX::ScratchImage
+			/// </summary>
+			/// <param name="image">Image to take ownership of</param>
+			ScratchImage(DirectX::ScratchImage* image);
+
+		public:
+
 			/// <summary>
 			/// Resizes the native DirectX::ScratchImage to the given width and height
 			/// </summary>
@@ -360,6 +473,14 @@ namespace PhilLibX
 			/// <param name="format">The <see cref="ImageFormat"/>/Type of the Image</param>
 			void Load(array<Byte>^ buffer, ImageFormat format);
 
+			/// <summary>
+			/// Loads the buffer into the <see cref="ScratchImage"/> from the given image buffer and type, the buffer is read in place
+			/// </summary>
+			/// <param name="buffer">Pointer to the image file buffer, i.e. pinned or memory-mapped data</param>
+			/// <param name="length">Length of the image file buffer in bytes</param>
+			/// <param name="format">The <see cref="ImageFormat"/>/Type of the Image</param>
+			void Load(IntPtr buffer, Int64 length, ImageFormat format);
+
 			/// <summary>
 			/// Loads the file into the <see cref="ScratchImage"/> from the given image path
 			/// </summary>
@@ -386,6 +507,27 @@ namespace PhilLibX
 			/// <param name="format">The <see cref="ImageFormat"/>/Type of the Image</param>
 			void Save(String^ filePath, ImageFormat format);
 
+			/// <summary>
+			/// Saves the <see cref="ScratchImage"/> to the given image path and type with the given PNG compression
+			/// </summary>
+			/// <param name="filePath">Image file path</param>
+			/// <param name="format">The <see cref="ImageFormat"/>/Type of the Image, Automatic resolves it from the extension</param>
+			/// <param name="compression">Deflate level used if saving to PNG</param>
+			void Save(String^ filePath, ImageFormat format, PngCompression compression);
+
+			/// <summary>
+			/// Gets the metadata of the native DirectX::ScratchImage
+			/// </summary>
+			Metadata^ GetMetadata();
+
+			/// <summary>
+			/// Gets a view of the given mip/slice's native pixel memory without copying it
+			/// </summary>
+			/// <param name="mip">Mip Map to get</param>
+			/// <param name="item">Item to get</param>
+			/// <param name="slice">Slice to get</param>
+			ImageSpan GetImageSpan(int mip, int item, int slice);
+
 			/// <summary>
 			/// Converts the first mip/image and slice of the native DirectX::ScratchImage to a .NET <see cref="Bitmap"/>
 			/// </summary>
@@ -399,10 +541,26 @@ namespace PhilLibX
 			/// <param name="slice">Slice to convert</param>
 			Bitmap^ ToBitmap(int mip, int item, int slice);
 
+			/// <summary>
+			/// Copies the given mip/slice of the native DirectX::ScratchImage into a caller supplied buffer as 32bpp B8G8R8A8 rows, i.e. a pinned preview buffer
+			/// </summary>
+			/// <param name="mip">Mip Map to copy</param>
+			/// <param name="item">Item to copy</param>
+			/// <param name="slice">Slice to copy</param>
+			/// <param name="buffer">Pointer to the buffer</param>
+			/// <param name="bufferSize">Size of the buffer in bytes</param>
+			/// <param name="stride">Bytes between the start of each row in the buffer, at least width * 4</param>
+			void CopyPixelsBGRA(int mip, int item, int slice, IntPtr buffer, int bufferSize, int stride);
+
 			/// <summary>
 			/// Destructs the ScratchImage and deletes the native DirectX::ScratchImage
 			/// </summary>
 			~ScratchImage();
+
+			/// <summary>
+			/// Deletes the native DirectX::ScratchImage if the ScratchImage wasn't disposed
+			/// </summary>
+			!ScratchImage();
 		};
 	}
 }
@@ -0,0 +1,208 @@
+#include "stdafx.h"
+#pragma warning(disable : 4561) // __fastcall' incompatible with the '/clr' option: converting to '__stdcall
+#include <vector>
+#include "DirectXTex.h"
+#include "ScratchImagePool.h"
+
+#pragma managed(push, off)
+
+namespace
+{
+	// Allocations smaller than this go straight to the heap
+	const size_t MinPooledSize = 0x10000;
+	// Log2 of the smallest pooled size - 1
+	const unsigned long MinPooledShift = 15;
+	// 4 classes per power of 2, so a buffer is never more than 25% larger than requested
+	const size_t ClassCount = 4 * (sizeof(size_t) * 8 - MinPooledShift);
+
+	SRWLOCK PoolLock = SRWLOCK_INIT;
+	std::vector<void*> FreeLists[ClassCount];
+
+	int64_t CurrentBytes = 0;
+	int64_t PeakBytes = 0;
+	int64_t PooledBytes = 0;
+	int64_t MaxPooledBytes = 0x10000000;
+
+	/// <summary>
+	/// Gets the size class of the allocation, returns false if it isn't pooled
+	/// </summary>
+	bool GetSizeClass(size_t size, size_t& index, size_t& classSize)
+	{
+		if (size < MinPooledSize)
+			return false;
+
+		unsigned long msb = 0;
+		for (size_t value = size - 1; value >>= 1;)
+			msb++;
+
+		// size is in (2^msb, 2^(msb + 1)], round it up to a quarter of that range
+		size_t step = (size_t)1 << (msb - 2);
+		size_t steps = (size + step - 1) >> (msb - 2);
+
+		index = (msb - MinPooledShift) * 4 + (steps - 5);
+		classSize = steps << (msb - 2);
+		return true;
+	}
+
+	/// <summary>
+	/// Frees pooled memory until the pool is under the given size, must hold the lock
+	/// </summary>
+	void TrimTo(int64_t maxBytes)
+	{
+		for (size_t i = ClassCount; i-- > 0 && PooledBytes > maxBytes;)
+		{
+			auto& freeList = FreeLists[i];
+			size_t classSize = (size_t)((i % 4) + 5) << (i / 4 + MinPooledShift - 2);
+
+			while (!freeList.empty() && PooledBytes > maxBytes)
+			{
+				_aligned_free(freeList.back());
+				freeList.pop_back();
+				PooledBytes -= classSize;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Installs the pool when the module is loaded, before any native code can create an image
+	/// </summary>
+	struct PoolInstaller
+	{
+		PoolInstaller()
+		{
+			PhilLibX::Imaging::ScratchImagePool::Install();
+		}
+	} Installer;
+}
+
+void PhilLibX::Imaging::ScratchImagePool::Install()
+{
+	DirectX::SetPixelAllocator(Allocate, Free);
+}
+
+void* __cdecl PhilLibX::Imaging::ScratchImagePool::Allocate(size_t size)
+{
+	size_t index = 0;
+	size_t classSize = size;
+	bool pooled = GetSizeClass(size, index, classSize);
+	void* memory = nullptr;
+
+	AcquireSRWLockExclusive(&PoolLock);
+
+	if (pooled && !FreeLists[index].empty())
+	{
+		memory = FreeLists[index].back();
+		FreeLists[index].pop_back();
+		PooledBytes -= classSize;
+	}
+
+	CurrentBytes += classSize;
+	if (CurrentBytes > PeakBytes)
+		PeakBytes = CurrentBytes;
+
+	ReleaseSRWLockExclusive(&PoolLock);
+
+	if (!memory)
+	{
+		memory = _aligned_malloc(classSize, 16);
+
+		// Give back what we counted
+		if (!memory)
+		{
+			AcquireSRWLockExclusive(&PoolLock);
+			CurrentBytes -= classSize;
+			ReleaseSRWLockExclusive(&PoolLock);
+		}
+	}
+
+	return memory;
+}
+
+void __cdecl PhilLibX::Imaging::ScratchImagePool::Free(void* memory, size_t size)
+{
+	if (!memory)
+		return;
+
+	size_t index = 0;
+	size_t classSize = size;
+	bool pooled = GetSizeClass(size, index, classSize);
+
+	AcquireSRWLockExclusive(&PoolLock);
+
+	CurrentBytes -= classSize;
+
+	if (pooled && PooledBytes + (int64_t)classSize <= MaxPooledBytes)
+	{
+		try
+		{
+			FreeLists[index].push_back(memory);
+			PooledBytes += classSize;
+			memory = nullptr;
+		}
+		catch (const std::bad_alloc&)
+		{
+			// Just free it
+		}
+	}
+
+	ReleaseSRWLockExclusive(&PoolLock);
+
+	if (memory)
+		_aligned_free(memory);
+}
+
+void PhilLibX::Imaging::ScratchImagePool::Trim()
+{
+	AcquireSRWLockExclusive(&PoolLock);
+	TrimTo(0);
+	ReleaseSRWLockExclusive(&PoolLock);
+}
+
+void PhilLibX::Imaging::ScratchImagePool::ResetPeakBytes()
+{
+	AcquireSRWLockExclusive(&PoolLock);
+	PeakBytes = CurrentBytes;
+	ReleaseSRWLockExclusive(&PoolLock);
+}
+
+int64_t PhilLibX::Imaging::ScratchImagePool::GetCurrentBytes()
+{
+	AcquireSRWLockShared(&PoolLock);
+	auto result = CurrentBytes;
+	ReleaseSRWLockShared(&PoolLock);
+	return result;
+}
+
+int64_t PhilLibX::Imaging::ScratchImagePool::GetPeakBytes()
+{
+	AcquireSRWLockShared(&PoolLock);
+	auto result = PeakBytes;
+	ReleaseSRWLockShared(&PoolLock);
+	return result;
+}
+
+int64_t PhilLibX::Imaging::ScratchImagePool::GetPooledBytes()
+{
+	AcquireSRWLockShared(&PoolLock);
+	auto result = PooledBytes;
+	ReleaseSRWLockShared(&PoolLock);
+	return result;
+}
+
+int64_t PhilLibX::Imaging::ScratchImagePool::GetMaxPooledBytes()
+{
+	AcquireSRWLockShared(&PoolLock);
+	auto result = MaxPooledBytes;
+	ReleaseSRWLockShared(&PoolLock);
+	return result;
+}
+
+void PhilLibX::Imaging::ScratchImagePool::SetMaxPooledBytes(int64_t value)
+{
+	AcquireSRWLockExclusive(&PoolLock);
+	MaxPooledBytes = value < 0 ? 0 : value;
+	TrimTo(MaxPooledBytes);
+	ReleaseSRWLockExclusive(&PoolLock);
+}
+
+#pragma managed(pop)
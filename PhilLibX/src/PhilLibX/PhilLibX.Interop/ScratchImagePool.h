@@ -0,0 +1,94 @@
+// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: ScratchImagePool.h
+// Author: Philip/Scobalula
+// Description: A size class pool for DirectX::ScratchImage pixel memory
+#pragma once
+
+namespace PhilLibX
+{
+	namespace Imaging
+	{
+		/// <summary>
+		/// A size class pool for DirectX::ScratchImage pixel memory
+		///
+		/// Freed buffers are kept per size class and handed back out on the next allocation of
+		/// that class, so batch jobs that convert/resize image after image reuse the same memory
+		/// rather than growing the heap. Small allocations aren't pooled.
+		/// </summary>
+		class ScratchImagePool
+		{
+		public:
+			/// <summary>
+			/// Installs the pool as the DirectXTex pixel allocator, done when the module is loaded,
+			/// images that allocated before it's installed are still freed by the default allocator
+			/// </summary>
+			static void Install();
+
+			/// <summary>
+			/// Allocates 16-byte aligned pixel memory
+			/// </summary>
+			static void* __cdecl Allocate(size_t size);
+
+			/// <summary>
+			/// Returns pixel memory to the pool, or frees it if it isn't pooled or the pool is full
+			/// </summary>
+			static void __cdecl Free(void* memory, size_t size);
+
+			/// <summary>
+			/// Frees all memory held by the pool
+			/// </summary>
+			static void Trim();
+
+			/// <summary>
+			/// Resets the peak to the current number of bytes
+			/// </summary>
+			static void ResetPeakBytes();
+
+			/// <summary>
+			/// Gets the number of bytes currently allocated to images
+			/// </summary>
+			static int64_t GetCurrentBytes();
+
+			/// <summary>
+			/// Gets the highest number of bytes allocated to images at once
+			/// </summary>
+			static int64_t GetPeakBytes();
+
+			/// <summary>
+			/// Gets the number of bytes held by the pool for reuse
+			/// </summary>
+			static int64_t GetPooledBytes();
+
+			/// <summary>
+			/// Gets the maximum number of bytes the pool holds for reuse
+			/// </summary>
+			static int64_t GetMaxPooledBytes();
+
+			/// <summary>
+			/// Sets the maximum number of bytes the pool holds for reuse, trimming it if it's over
+			/// </summary>
+			static void SetMaxPooledBytes(int64_t value);
+		};
+	}
+}
@@ -0,0 +1,142 @@
+#include "stdafx.h"
+#pragma warning(disable : 4561) // __fastcall' incompatible with the '/clr' option: converting to '__stdcall
+#include <omp.h>
+#include "DirectXTex.h"
+#include "ScratchImagePool.h"
+#include "ScratchImage.h"
+#include "DirectXException.h"
+#include "TextureBatch.h"
+
+using namespace System::Diagnostics;
+using namespace System::Threading;
+
+PhilLibX::Imaging::TextureBatch::TextureBatch()
+{
+	JobList = gcnew List<TextureJob^>();
+	WorkerCount = Environment::ProcessorCount;
+}
+
+void PhilLibX::Imaging::TextureBatch::Add(TextureJob^ job)
+{
+	// Validate it
+	if (!job)
+		throw gcnew ArgumentNullException("job");
+
+	JobList->Add(job);
+}
+
+int PhilLibX::Imaging::TextureBatch::Run()
+{
+	auto stopwatch = Stopwatch::StartNew();
+
+	// Largest first, sizes are looked up once rather than per comparison
+	auto sizes = gcnew array<Int64>(JobList->Count);
+	Queue = JobList->ToArray();
+
+	for (int i = 0; i < Queue->Length; i++)
+	{
+		auto info = gcnew System::IO::FileInfo(Queue[i]->InputPath);
+		sizes[i] = info->Exists ? -info->Length : 0;
+	}
+
+	Array::Sort(sizes, Queue);
+
+	int cores = Environment::ProcessorCount;
+	int workerCount = Math::Max(1, Math::Min(WorkerCount, Queue->Length));
+
+	NextJob = -1;
+	CompressThreads = Math::Max(1, cores / workerCount);
+
+	auto workers = gcnew array<Thread^>(workerCount);
+
+	for (int i = 0; i < workerCount; i++)
+	{
+		workers[i] = gcnew Thread(gcnew ThreadStart(this, &TextureBatch::Worker));
+		workers[i]->Name = "Texture Worker " + i;
+		workers[i]->IsBackground = true;
+		workers[i]->Start();
+	}
+
+	for each (auto worker in workers)
+		worker->Join();
+
+	ElapsedTime = stopwatch->Elapsed;
+
+	int failed = 0;
+
+	for each (auto job in Queue)
+		if (!job->Succeeded || job->CompletedError)
+			failed++;
+
+	Queue = nullptr;
+	return failed;
+}
+
+void PhilLibX::Imaging::TextureBatch::Worker()
+{
+	// Applies to parallel regions started on this thread, i.e. the block compressor
+	omp_set_num_threads(CompressThreads);
+
+	while (true)
+	{
+		int index = Interlocked::Increment(NextJob);
+
+		if (index >= Queue->Length)
+			break;
+
+		RunJob(Queue[index]);
+
+		// A throwing handler must not take the worker, and the rest of its queue, with it
+		try
+		{
+			JobCompleted(Queue[index]);
+		}
+		catch (Exception^ e)
+		{
+			Queue[index]->CompletedError = e;
+		}
+	}
+}
+
+void PhilLibX::Imaging::TextureBatch::RunJob(TextureJob^ job)
+{
+	auto stopwatch = Stopwatch::StartNew();
+
+	job->Succeeded = false;
+	job->Error = nullptr;
+	job->CompletedError = nullptr;
+	job->LoadTime = TimeSpan::Zero;
+	job->ProcessTime = TimeSpan::Zero;
+	job->SaveTime = TimeSpan::Zero;
+
+	try
+	{
+		// Disposed at the end of the scope so its pixels go back to the pool
+		ScratchImage image(job->InputPath);
+		job->LoadTime = stopwatch->Elapsed;
+		stopwatch->Restart();
+
+		bool resize = job->Width > 0 && job->Height > 0;
+
+		// Resizing and mip generation need uncompressed pixels
+		if ((resize || job->GenerateMipMaps) && DirectX::IsCompressed((DXGI_FORMAT)image.GetMetadata()->Format))
+			image.ConvertImage(ScratchImage::DXGIFormat::R8G8B8A8UNORM);
+		if (resize)
+			image.Resize(job->Width, job->Height);
+		if (job->GenerateMipMaps)
+			image.GenerateMipMaps(job->MipMapCount);
+		if (job->Format != ScratchImage::DXGIFormat::UNKNOWN)
+			image.ConvertImage(job->Format, job->Quality, CompressThreads > 1);
+
+		job->ProcessTime = stopwatch->Elapsed;
+		stopwatch->Restart();
+
+		image.Save(job->OutputPath, job->OutputFormat, job->PngCompression);
+		job->SaveTime = stopwatch->Elapsed;
+		job->Succeeded = true;
+	}
+	catch (Exception^ e)
+	{
+		job->Error = e->Message;
+	}
+}
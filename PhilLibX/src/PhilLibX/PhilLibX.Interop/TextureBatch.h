@@ -0,0 +1,224 @@
+// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: TextureBatch.h
+// Author: Philip/Scobalula
+// Description: Converts many textures at once across a pool of workers
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace PhilLibX
+{
+	namespace Imaging
+	{
+		/// <summary>
+		/// A texture to convert as part of a <see cref="TextureBatch"/>
+		/// </summary>
+		public ref class TextureJob
+		{
+		public:
+			/// <summary>
+			/// Gets or Sets the image to load
+			/// </summary>
+			property String^ InputPath;
+
+			/// <summary>
+			/// Gets or Sets the format to convert the image to, Unknown keeps the input format
+			/// </summary>
+			property ScratchImage::DXGIFormat Format;
+
+			/// <summary>
+			/// Gets or Sets the BC6H/BC7 compression quality
+			/// </summary>
+			property ScratchImage::CompressionQuality Quality;
+
+			/// <summary>
+			/// Gets or Sets the width to resize the image to, 0 keeps the input size
+			/// </summary>
+			property int Width;
+
+			/// <summary>
+			/// Gets or Sets the height to resize the image to, 0 keeps the input size
+			/// </summary>
+			property int Height;
+
+			/// <summary>
+			/// Gets or Sets whether or not to generate mip maps
+			/// </summary>
+			property bool GenerateMipMaps;
+
+			/// <summary>
+			/// Gets or Sets the number of mip maps to generate, 0 generates the full chain
+			/// </summary>
+			property int MipMapCount;
+
+			/// <summary>
+			/// Gets or Sets the path to save the result to
+			/// </summary>
+			property String^ OutputPath;
+
+			/// <summary>
+			/// Gets or Sets the format to save the result as, Automatic resolves it from the output extension
+			/// </summary>
+			property ScratchImage::ImageFormat OutputFormat;
+
+			/// <summary>
+			/// Gets or Sets the deflate level used if saving to PNG
+			/// </summary>
+			property ScratchImage::PngCompression PngCompression;
+
+			/// <summary>
+			/// Gets whether or not the job succeeded
+			/// </summary>
+			property bool Succeeded;
+
+			/// <summary>
+			/// Gets the error if the job failed
+			/// </summary>
+			property String^ Error;
+
+			/// <summary>
+			/// Gets the exception thrown by a <see cref="TextureBatch::JobCompleted"/> handler for this job, if any
+			/// </summary>
+			property Exception^ CompletedError;
+
+			/// <summary>
+			/// Gets the time spent loading the image
+			/// </summary>
+			property TimeSpan LoadTime;
+
+			/// <summary>
+			/// Gets the time spent resizing, generating mip maps and converting the image
+			/// </summary>
+			property TimeSpan ProcessTime;
+
+			/// <summary>
+			/// Gets the time spent saving the image
+			/// </summary>
+			property TimeSpan SaveTime;
+
+			/// <summary>
+			/// Gets the total time spent on the job
+			/// </summary>
+			property TimeSpan TotalTime { TimeSpan get() { return LoadTime + ProcessTime + SaveTime; } }
+
+			/// <summary>
+			/// Initializes an instance of the <see cref="TextureJob"/> class
+			/// </summary>
+			TextureJob() {}
+
+			/// <summary>
+			/// Initializes an instance of the <see cref="TextureJob"/> class with the given input, format and output
+			/// </summary>
+			/// <param name="inputPath">Image to load</param>
+			/// <param name="format">Format to convert the image to</param>
+			/// <param name="outputPath">Path to save the result to</param>
+			TextureJob(String^ inputPath, ScratchImage::DXGIFormat format, String^ outputPath)
+			{
+				InputPath = inputPath;
+				Format = format;
+				OutputPath = outputPath;
+			}
+		};
+
+		/// <summary>
+		/// Converts many textures at once across a pool of workers
+		///
+		/// Jobs are started largest input first so one big texture doesn't finish long after the
+		/// rest. When there are fewer workers than cores the leftover cores are given to the OpenMP
+		/// block compressor of each worker, so the total thread count stays at the core count.
+		/// </summary>
+		public ref class TextureBatch
+		{
+		private:
+			/// <summary>
+			/// Jobs to run
+			/// </summary>
+			List<TextureJob^>^ JobList;
+
+			/// <summary>
+			/// Jobs in the order they're started
+			/// </summary>
+			array<TextureJob^>^ Queue;
+
+			/// <summary>
+			/// Index of the next job in the queue
+			/// </summary>
+			int NextJob;
+
+			/// <summary>
+			/// OpenMP threads each worker compresses with
+			/// </summary>
+			int CompressThreads;
+
+			/// <summary>
+			/// Runs jobs from the queue until it's empty
+			/// </summary>
+			void Worker();
+
+			/// <summary>
+			/// Runs a single job, recording its timings and result
+			/// </summary>
+			void RunJob(TextureJob^ job);
+
+		public:
+			/// <summary>
+			/// Gets or Sets the maximum number of workers, defaults to the number of cores
+			/// </summary>
+			property int WorkerCount;
+
+			/// <summary>
+			/// Gets the jobs in the batch
+			/// </summary>
+			property IList<TextureJob^>^ Jobs { IList<TextureJob^>^ get() { return JobList; } }
+
+			/// <summary>
+			/// Gets the time the last run took
+			/// </summary>
+			property TimeSpan ElapsedTime;
+
+			/// <summary>
+			/// Raised on a worker thread after each job finishes
+			/// </summary>
+			event Action<TextureJob^>^ JobCompleted;
+
+			/// <summary>
+			/// Initializes an instance of the <see cref="TextureBatch"/> class
+			/// </summary>
+			TextureBatch();
+
+			/// <summary>
+			/// Adds a job to the batch
+			/// </summary>
+			/// <param name="job">Job to add</param>
+			void Add(TextureJob^ job);
+
+			/// <summary>
+			/// Runs every job in the batch, blocks until they're done
+			/// </summary>
+			/// <returns>Number of jobs that failed or whose completed handler threw</returns>
+			int Run();
+		};
+	}
+}
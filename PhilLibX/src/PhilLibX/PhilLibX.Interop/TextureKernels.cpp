@@ -0,0 +1,409 @@
+#include "stdafx.h"
+#pragma warning(disable : 4561) // __fastcall' incompatible with the '/clr' option: converting to '__stdcall
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+#include <Windows.h>
+#include "TextureKernels.h"
+
+#pragma managed(push, off)
+
+namespace
+{
+	// Rows handed to a worker at a time
+	const int BandRows = 32;
+
+	// Normal Z by red/green, and the legacy specular/albedo scales by mask/channel, built with
+	// the same double math as Texturing so the output matches it exactly
+	uint8_t NormalZTable[256][256];
+	uint8_t ScaleTable[256][256];
+	uint8_t InverseScaleTable[256][256];
+
+	INIT_ONCE TablesInitOnce = INIT_ONCE_STATIC_INIT;
+
+	BOOL CALLBACK InitializeTables(PINIT_ONCE initOnce, PVOID parameter, PVOID* context)
+	{
+		for (int x = 0; x < 256; x++)
+		{
+			for (int y = 0; y < 256; y++)
+			{
+				double X = 2.0 * (x / 255.0000) - 1;
+				double Y = 2.0 * (y / 255.0000) - 1;
+				double Z = 0.0000000;
+
+				if ((1 - (X * X) - (Y * Y)) > 0)
+					Z = sqrt(1 - (X * X) - (Y * Y));
+
+				double value = (Z + 1.0) / 2.0;
+				NormalZTable[x][y] = (uint8_t)((value < 0.0 ? 0.0 : value > 1.0 ? 1.0 : value) * 255);
+			}
+		}
+
+		for (int mask = 0; mask < 256; mask++)
+		{
+			double amount = mask / 255.0;
+
+			for (int value = 0; value < 256; value++)
+			{
+				ScaleTable[mask][value] = (uint8_t)(value * amount);
+				InverseScaleTable[mask][value] = (uint8_t)(value * (1 - amount));
+			}
+		}
+
+		return TRUE;
+	}
+
+	/// <summary>
+	/// Kernel inputs and outputs
+	/// </summary>
+	struct KernelArgs
+	{
+		const uint8_t* Source;
+		int SourceBpp;
+		const uint8_t* Mask;
+		int MaskBpp;
+		int Width;
+		uint8_t* Outputs[4];
+		int Channel;
+		int ClampValue;
+	};
+
+	typedef void(*RowKernel)(const KernelArgs& args, int y, const uint32_t* source, const uint32_t* mask);
+
+	/// <summary>
+	/// Bands shared by the workers
+	/// </summary>
+	struct BandJob
+	{
+		RowKernel Kernel;
+		const KernelArgs* Args;
+		int Height;
+		LONG BandCount;
+		volatile LONG NextBand;
+		volatile LONG Failed;
+	};
+
+	/// <summary>
+	/// Gets a row as 32bpp BGRA, 24bpp rows are expanded into the scratch row
+	/// </summary>
+	const uint32_t* LoadRow(uint32_t* scratch, const uint8_t* row, int width, int bpp)
+	{
+		if (bpp == 4)
+			return (const uint32_t*)row;
+
+		for (int x = 0; x < width; x++, row += 3)
+			scratch[x] = 0xFF000000 | ((uint32_t)row[2] << 16) | ((uint32_t)row[1] << 8) | row[0];
+
+		return scratch;
+	}
+
+	/// <summary>
+	/// Thread pool worker, takes bands until there are none left
+	/// </summary>
+	VOID CALLBACK BandWorker(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work)
+	{
+		auto job = (BandJob*)context;
+		auto& args = *job->Args;
+
+		std::unique_ptr<uint32_t[]> scratch(new (std::nothrow) uint32_t[(size_t)args.Width * 2]);
+		if (!scratch)
+		{
+			InterlockedExchange(&job->Failed, 1);
+			return;
+		}
+
+		for (LONG band = InterlockedIncrement(&job->NextBand) - 1; band < job->BandCount; band = InterlockedIncrement(&job->NextBand) - 1)
+		{
+			int last = (std::min)(((int)band + 1) * BandRows, job->Height);
+
+			for (int y = (int)band * BandRows; y < last; y++)
+			{
+				const uint32_t* source = nullptr;
+				const uint32_t* mask = nullptr;
+
+				if (args.Source)
+					source = LoadRow(scratch.get(), args.Source + (size_t)y * args.Width * args.SourceBpp, args.Width, args.SourceBpp);
+				if (args.Mask)
+					mask = LoadRow(scratch.get() + args.Width, args.Mask + (size_t)y * args.Width * args.MaskBpp, args.Width, args.MaskBpp);
+
+				job->Kernel(args, y, source, mask);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Runs the kernel over every row in bands across the thread pool
+	/// </summary>
+	HRESULT RunBands(RowKernel kernel, const KernelArgs& args, int height)
+	{
+		InitOnceExecuteOnce(&TablesInitOnce, InitializeTables, nullptr, nullptr);
+
+		BandJob job = {};
+		job.Kernel = kernel;
+		job.Args = &args;
+		job.Height = height;
+		job.BandCount = (LONG)((height + BandRows - 1) / BandRows);
+
+		PTP_WORK work = job.BandCount > 1 ? CreateThreadpoolWork(BandWorker, &job, nullptr) : nullptr;
+
+		if (work)
+		{
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+
+			LONG workers = (std::min)(job.BandCount, (LONG)info.dwNumberOfProcessors);
+
+			for (LONG i = 0; i < workers; i++)
+				SubmitThreadpoolWork(work);
+
+			WaitForThreadpoolWorkCallbacks(work, FALSE);
+			CloseThreadpoolWork(work);
+		}
+		else
+		{
+			BandWorker(nullptr, &job, nullptr);
+		}
+
+		return job.Failed ? E_OUTOFMEMORY : S_OK;
+	}
+
+	inline bool ValidBpp(int bpp)
+	{
+		return bpp == 3 || bpp == 4;
+	}
+
+	inline uint32_t* OutputRow(const KernelArgs& args, int output, int y)
+	{
+		return (uint32_t*)args.Outputs[output] + (size_t)y * args.Width;
+	}
+
+	/// <summary>
+	/// Broadcasts the channel at the given shift to a gray pixel
+	/// </summary>
+	inline __m128i Gray(__m128i pixels, int shift)
+	{
+		__m128i value = _mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(0xFF));
+		__m128i rg = _mm_or_si128(value, _mm_slli_epi32(value, 8));
+		return _mm_or_si128(_mm_or_si128(rg, _mm_slli_epi32(value, 16)), _mm_set1_epi32((int)0xFF000000));
+	}
+
+	inline uint32_t Gray(uint32_t pixel, int shift)
+	{
+		return ((pixel >> shift) & 0xFF) * 0x010101 | 0xFF000000;
+	}
+
+	void SplitAllChannelsRow(const KernelArgs& args, int y, const uint32_t* source, const uint32_t* mask)
+	{
+		uint32_t* red = OutputRow(args, 0, y);
+		uint32_t* green = OutputRow(args, 1, y);
+		uint32_t* blue = OutputRow(args, 2, y);
+		uint32_t* alpha = OutputRow(args, 3, y);
+		int x = 0;
+
+		for (; x + 4 <= args.Width; x += 4)
+		{
+			__m128i pixels = _mm_loadu_si128((const __m128i*)(source + x));
+			_mm_storeu_si128((__m128i*)(red + x), Gray(pixels, 16));
+			_mm_storeu_si128((__m128i*)(green + x), Gray(pixels, 8));
+			_mm_storeu_si128((__m128i*)(blue + x), Gray(pixels, 0));
+			_mm_storeu_si128((__m128i*)(alpha + x), Gray(pixels, 24));
+		}
+
+		for (; x < args.Width; x++)
+		{
+			red[x] = Gray(source[x], 16);
+			green[x] = Gray(source[x], 8);
+			blue[x] = Gray(source[x], 0);
+			alpha[x] = Gray(source[x], 24);
+		}
+	}
+
+	void SplitColorAndAlphaRow(const KernelArgs& args, int y, const uint32_t* source, const uint32_t* mask)
+	{
+		const __m128i opaque = _mm_set1_epi32((int)0xFF000000);
+		uint32_t* color = OutputRow(args, 0, y);
+		uint32_t* alpha = OutputRow(args, 1, y);
+		int x = 0;
+
+		for (; x + 4 <= args.Width; x += 4)
+		{
+			__m128i pixels = _mm_loadu_si128((const __m128i*)(source + x));
+			_mm_storeu_si128((__m128i*)(color + x), _mm_or_si128(pixels, opaque));
+			_mm_storeu_si128((__m128i*)(alpha + x), Gray(pixels, 24));
+		}
+
+		for (; x < args.Width; x++)
+		{
+			color[x] = source[x] | 0xFF000000;
+			alpha[x] = Gray(source[x], 24);
+		}
+	}
+
+	void SplitNormalGlossOcclusionRow(const KernelArgs& args, int y, const uint32_t* source, const uint32_t* mask)
+	{
+		uint32_t* normal = OutputRow(args, 0, y);
+		uint32_t* gloss = OutputRow(args, 1, y);
+		uint32_t* occlusion = OutputRow(args, 2, y);
+		int x = 0;
+
+		for (; x + 4 <= args.Width; x += 4)
+		{
+			__m128i pixels = _mm_loadu_si128((const __m128i*)(source + x));
+			_mm_storeu_si128((__m128i*)(gloss + x), Gray(pixels, 16));
+			_mm_storeu_si128((__m128i*)(occlusion + x), Gray(pixels, 0));
+		}
+
+		for (; x < args.Width; x++)
+		{
+			gloss[x] = Gray(source[x], 16);
+			occlusion[x] = Gray(source[x], 0);
+		}
+
+		// Green and alpha hold X and Y
+		for (x = 0; x < args.Width; x++)
+		{
+			uint32_t normalX = (source[x] >> 8) & 0xFF;
+			uint32_t normalY = source[x] >> 24;
+			normal[x] = 0xFF000000 | (normalX << 16) | (normalY << 8) | NormalZTable[normalX][normalY];
+		}
+	}
+
+	void ExpandNormalMapRow(const KernelArgs& args, int y, const uint32_t* source, const uint32_t* mask)
+	{
+		uint8_t* row = args.Outputs[0] + (size_t)y * args.Width * args.SourceBpp;
+
+		if (args.SourceBpp == 4)
+		{
+			for (int x = 0; x < args.Width; x++, row += 4)
+			{
+				row[0] = NormalZTable[row[2]][row[1]];
+				row[3] = 0xFF;
+			}
+		}
+		else
+		{
+			for (int x = 0; x < args.Width; x++, row += 3)
+				row[0] = NormalZTable[row[2]][row[1]];
+		}
+	}
+
+	void SplitSpecularAlbedoRow(const KernelArgs& args, int y, const uint32_t* source, const uint32_t* mask)
+	{
+		// Red, green, blue, alpha
+		const int shifts[] = { 16, 8, 0, 24 };
+		uint32_t* albedo = OutputRow(args, 0, y);
+		uint32_t* specular = OutputRow(args, 1, y);
+		uint8_t clampValue = (uint8_t)(std::max)(args.ClampValue, 0);
+
+		for (int x = 0; x < args.Width; x++)
+		{
+			uint32_t pixel = source[x];
+			uint32_t amount = args.Channel >= 0 && args.Channel < 4 ? (mask[x] >> shifts[args.Channel]) & 0xFF : 0xFF;
+
+			// Less than half metallic keeps its color and gets a flat specular
+			if (amount < 128)
+			{
+				albedo[x] = pixel;
+				specular[x] = 0xFF383838;
+				continue;
+			}
+
+			const uint8_t* scale = ScaleTable[amount];
+			const uint8_t* inverseScale = InverseScaleTable[amount];
+			uint32_t result = 0xFF000000;
+			uint32_t color = pixel & 0xFF000000;
+
+			for (int shift = 0; shift < 24; shift += 8)
+			{
+				uint32_t channel = (pixel >> shift) & 0xFF;
+				result |= (uint32_t)(std::max)(scale[channel], clampValue) << shift;
+				color |= (uint32_t)inverseScale[channel] << shift;
+			}
+
+			albedo[x] = color;
+			specular[x] = result;
+		}
+	}
+}
+
+HRESULT __cdecl TextureKernels_ExpandNormalMap(uint8_t* pixels, int width, int height, int bytesPerPixel)
+{
+	if (!pixels || width <= 0 || height <= 0 || !ValidBpp(bytesPerPixel))
+		return E_INVALIDARG;
+
+	KernelArgs args = {};
+	args.SourceBpp = bytesPerPixel;
+	args.Width = width;
+	args.Outputs[0] = pixels;
+
+	return RunBands(ExpandNormalMapRow, args, height);
+}
+
+HRESULT __cdecl TextureKernels_SplitNormalGlossOcclusion(const uint8_t* source, int width, int height, int bytesPerPixel, uint8_t* normal, uint8_t* gloss, uint8_t* occlusion)
+{
+	if (!source || !normal || !gloss || !occlusion || width <= 0 || height <= 0 || !ValidBpp(bytesPerPixel))
+		return E_INVALIDARG;
+
+	KernelArgs args = {};
+	args.Source = source;
+	args.SourceBpp = bytesPerPixel;
+	args.Width = width;
+	args.Outputs[0] = normal;
+	args.Outputs[1] = gloss;
+	args.Outputs[2] = occlusion;
+
+	return RunBands(SplitNormalGlossOcclusionRow, args, height);
+}
+
+HRESULT __cdecl TextureKernels_SplitColorAndAlpha(const uint8_t* source, int width, int height, int bytesPerPixel, uint8_t* color, uint8_t* alpha)
+{
+	if (!source || !color || !alpha || width <= 0 || height <= 0 || !ValidBpp(bytesPerPixel))
+		return E_INVALIDARG;
+
+	KernelArgs args = {};
+	args.Source = source;
+	args.SourceBpp = bytesPerPixel;
+	args.Width = width;
+	args.Outputs[0] = color;
+	args.Outputs[1] = alpha;
+
+	return RunBands(SplitColorAndAlphaRow, args, height);
+}
+
+HRESULT __cdecl TextureKernels_SplitAllChannels(const uint8_t* source, int width, int height, int bytesPerPixel, uint8_t* red, uint8_t* green, uint8_t* blue, uint8_t* alpha)
+{
+	if (!source || !red || !green || !blue || !alpha || width <= 0 || height <= 0 || !ValidBpp(bytesPerPixel))
+		return E_INVALIDARG;
+
+	KernelArgs args = {};
+	args.Source = source;
+	args.SourceBpp = bytesPerPixel;
+	args.Width = width;
+	args.Outputs[0] = red;
+	args.Outputs[1] = green;
+	args.Outputs[2] = blue;
+	args.Outputs[3] = alpha;
+
+	return RunBands(SplitAllChannelsRow, args, height);
+}
+
+HRESULT __cdecl TextureKernels_SplitSpecularAlbedo(const uint8_t* source, int sourceBytesPerPixel, const uint8_t* mask, int maskBytesPerPixel, int width, int height, int channel, int clampValue, uint8_t* albedo, uint8_t* specular)
+{
+	if (!source || !mask || !albedo || !specular || width <= 0 || height <= 0 || !ValidBpp(sourceBytesPerPixel) || !ValidBpp(maskBytesPerPixel) || clampValue > 255)
+		return E_INVALIDARG;
+
+	KernelArgs args = {};
+	args.Source = source;
+	args.SourceBpp = sourceBytesPerPixel;
+	args.Mask = mask;
+	args.MaskBpp = maskBytesPerPixel;
+	args.Width = width;
+	args.Outputs[0] = albedo;
+	args.Outputs[1] = specular;
+	args.Channel = channel;
+	args.ClampValue = clampValue;
+
+	return RunBands(SplitSpecularAlbedoRow, args, height);
+}
+
+#pragma managed(pop)
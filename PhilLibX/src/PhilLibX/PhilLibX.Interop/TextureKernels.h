@@ -0,0 +1,56 @@
+// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: TextureKernels.h
+// Author: Philip/Scobalula
+// Description: Row-major channel split kernels for BitmapX pixel buffers, exported for PhilLibX's Texturing
+#pragma once
+
+// Sources are 24bpp BGR or 32bpp BGRA rows with no padding, outputs are always 32bpp BGRA
+// Each returns S_OK, E_INVALIDARG or E_OUTOFMEMORY
+extern "C"
+{
+	/// <summary>
+	/// Replaces blue with the normal's Z calculated from red and green, and alpha with 255, in place
+	/// </summary>
+	__declspec(dllexport) HRESULT __cdecl TextureKernels_ExpandNormalMap(uint8_t* pixels, int width, int height, int bytesPerPixel);
+
+	/// <summary>
+	/// Splits a green/alpha normal, red gloss and blue occlusion map
+	/// </summary>
+	__declspec(dllexport) HRESULT __cdecl TextureKernels_SplitNormalGlossOcclusion(const uint8_t* source, int width, int height, int bytesPerPixel, uint8_t* normal, uint8_t* gloss, uint8_t* occlusion);
+
+	/// <summary>
+	/// Splits the color and alpha channels
+	/// </summary>
+	__declspec(dllexport) HRESULT __cdecl TextureKernels_SplitColorAndAlpha(const uint8_t* source, int width, int height, int bytesPerPixel, uint8_t* color, uint8_t* alpha);
+
+	/// <summary>
+	/// Splits every channel into a gray map
+	/// </summary>
+	__declspec(dllexport) HRESULT __cdecl TextureKernels_SplitAllChannels(const uint8_t* source, int width, int height, int bytesPerPixel, uint8_t* red, uint8_t* green, uint8_t* blue, uint8_t* alpha);
+
+	/// <summary>
+	/// Splits albedo and specular maps using a channel of the mask as the metallic amount
+	/// </summary>
+	__declspec(dllexport) HRESULT __cdecl TextureKernels_SplitSpecularAlbedo(const uint8_t* source, int sourceBytesPerPixel, const uint8_t* mask, int maskBytesPerPixel, int width, int height, int channel, int clampValue, uint8_t* albedo, uint8_t* specular);
+}
@@ -0,0 +1,211 @@
+﻿﻿// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: BytePatternTests.cs
+// Author: Philip/Scobalula
+// Description: Tests for BytePattern and BinaryReader.FindBytes.
+using System;
+using System.Collections.Generic;
+using System.IO;
+using PhilLibX.IO;
+
+namespace PhilLibX.Tests
+{
+    /// <summary>
+    /// Tests for BytePattern and BinaryReader.FindBytes, every search is checked against a
+    /// byte by byte scan of the same data.
+    /// </summary>
+    internal static class BytePatternTests
+    {
+        /// <summary>
+        /// Bytes BinaryReader.FindBytes reads per chunk, matches around it straddle two reads
+        /// </summary>
+        private const int ChunkSize = 1048576;
+
+        /// <summary>
+        /// Gets the tests to run
+        /// </summary>
+        public static IEnumerable<KeyValuePair<string, Action>> GetTests()
+        {
+            yield return new KeyValuePair<string, Action>("Wildcards", Wildcards);
+            yield return new KeyValuePair<string, Action>("PatternLongerThanBuffer", PatternLongerThanBuffer);
+            yield return new KeyValuePair<string, Action>("FindBytesAcrossChunks", FindBytesAcrossChunks);
+            yield return new KeyValuePair<string, Action>("FindBytesFirstOccurence", FindBytesFirstOccurence);
+            yield return new KeyValuePair<string, Action>("FindBytesShortStream", FindBytesShortStream);
+        }
+
+        private static void Wildcards()
+        {
+            var data = RandomBytes(4096, 1);
+
+            foreach (var pattern in new[] { "?? ?? 01 02", "01 02 ?? ??", "? 01 ? 02 ?", "??" })
+            {
+                var needle = Parse(pattern);
+
+                // Put a match at the very start and end so the wildcards sit on the buffer's edges
+                Place(data, needle, 0);
+                Place(data, needle, data.Length - needle.Length);
+
+                var expected = Scan(data, 0, data.Length, needle);
+                var actual = new List<long>();
+                var bytePattern = new BytePattern(needle);
+
+                for (int index = bytePattern.IndexOf(data, 0, data.Length); index >= 0; index = bytePattern.IndexOf(data, index + 1, data.Length))
+                    actual.Add(index);
+
+                AssertEqual(actual.ToArray(), expected, pattern);
+            }
+        }
+
+        private static void PatternLongerThanBuffer()
+        {
+            var data = new byte[] { 1, 2, 3, 4 };
+
+            Assert(new BytePattern(new byte[] { 1, 2, 3, 4, 5 }).IndexOf(data, 0, data.Length) == -1, "Longer than the buffer");
+            Assert(new BytePattern(new byte[] { 3, 4 }).IndexOf(data, 3, data.Length) == -1, "Longer than what remains");
+            Assert(new BytePattern(new byte[] { 3, 4 }).IndexOf(data, 2, data.Length) == 2, "Exactly what remains");
+            Assert(new BytePattern(new byte[] { 2, 3 }).IndexOf(data, 0, 2) == -1, "Past the end index");
+        }
+
+        private static void FindBytesAcrossChunks()
+        {
+            var needle = RandomBytes(9, 2);
+
+            // The first read fills the buffer, which has room for the needle after the chunk
+            for (int boundary = ChunkSize; boundary <= ChunkSize + needle.Length; boundary += needle.Length)
+            {
+                for (int shift = 1; shift < needle.Length; shift++)
+                {
+                    var data = RandomBytes(ChunkSize * 2 + 100, 3);
+                    Place(data, needle, boundary - shift);
+                    Place(data, needle, 0);
+                    Place(data, needle, data.Length - needle.Length);
+
+                    AssertEqual(Find(data, needle, false), Scan(data, 0, data.Length, needle), "Match at " + (boundary - shift));
+                }
+            }
+        }
+
+        private static void FindBytesFirstOccurence()
+        {
+            var needle = RandomBytes(6, 4);
+            var data = RandomBytes(ChunkSize + 4096, 5);
+
+            Place(data, needle, ChunkSize - 2);
+            Place(data, needle, ChunkSize + 100);
+
+            var expected = Scan(data, 0, data.Length, needle);
+
+            Assert(expected.Length >= 2, "Expected at least two matches");
+            AssertEqual(Find(data, needle, true), new[] { expected[0] }, "First occurence");
+            AssertEqual(Find(data, needle, false), expected, "All occurences");
+        }
+
+        private static void FindBytesShortStream()
+        {
+            var needle = new byte[] { 1, 2, 3, 4, 5, 6 };
+
+            AssertEqual(Find(new byte[] { 1, 2, 3 }, needle, false), new long[0], "Stream shorter than the needle");
+            AssertEqual(Find(new byte[] { 0, 1, 2, 3, 4, 5 }, needle, false), new long[0], "Needle cut off by the end");
+            AssertEqual(Find(new byte[] { 0, 1, 2, 3, 4, 5, 6 }, needle, false), new long[] { 1 }, "Needle at the end");
+        }
+
+        /// <summary>
+        /// Searches the data with BinaryReader.FindBytes from a non-zero position
+        /// </summary>
+        private static long[] Find(byte[] data, byte[] needle, bool firstOccurence)
+        {
+            var padded = new byte[data.Length + 3];
+            Buffer.BlockCopy(data, 0, padded, 3, data.Length);
+
+            using (var reader = new BinaryReader(new MemoryStream(padded)))
+            {
+                reader.BaseStream.Position = 3;
+                return Array.ConvertAll(reader.FindBytes(needle, firstOccurence), x => x - 3);
+            }
+        }
+
+        /// <summary>
+        /// Finds every match byte by byte
+        /// </summary>
+        internal static long[] Scan(byte[] data, long baseAddress, int length, IList<byte?> needle)
+        {
+            var results = new List<long>();
+
+            for (int i = 0; i + needle.Count <= length; i++)
+            {
+                int j = 0;
+
+                while (j < needle.Count && (!needle[j].HasValue || needle[j].Value == data[i + j]))
+                    j++;
+
+                if (j == needle.Count)
+                    results.Add(baseAddress + i);
+            }
+
+            return results.ToArray();
+        }
+
+        private static long[] Scan(byte[] data, long baseAddress, int length, byte[] needle)
+        {
+            return Scan(data, baseAddress, length, Array.ConvertAll(needle, x => (byte?)x));
+        }
+
+        private static byte?[] Parse(string pattern)
+        {
+            var split = pattern.Split(' ');
+            return Array.ConvertAll(split, x => x.StartsWith("?") ? (byte?)null : Convert.ToByte(x, 16));
+        }
+
+        private static void Place(byte[] data, IList<byte?> needle, int offset)
+        {
+            for (int i = 0; i < needle.Count; i++)
+                data[offset + i] = needle[i] ?? 0xCC;
+        }
+
+        private static void Place(byte[] data, byte[] needle, int offset)
+        {
+            Buffer.BlockCopy(needle, 0, data, offset, needle.Length);
+        }
+
+        private static byte[] RandomBytes(int count, int seed)
+        {
+            var result = new byte[count];
+            new Random(seed).NextBytes(result);
+            return result;
+        }
+
+        private static void Assert(bool condition, string message)
+        {
+            if (!condition)
+                throw new Exception(message);
+        }
+
+        internal static void AssertEqual(long[] actual, long[] expected, string message)
+        {
+            Assert(actual.Length == expected.Length, string.Format("{0}: {1} matches, expected {2}", message, actual.Length, expected.Length));
+
+            for (int i = 0; i < actual.Length; i++)
+                Assert(actual[i] == expected[i], string.Format("{0}: match {1} is 0x{2:X}, expected 0x{3:X}", message, i, actual[i], expected[i]));
+        }
+    }
+}
@@ -0,0 +1,257 @@
+﻿﻿// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: ProcessReaderTests.cs
+// Author: Philip/Scobalula
+// Description: Tests for ProcessReader against a stand-in process.
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using PhilLibX.IO;
+
+namespace PhilLibX.Tests
+{
+    /// <summary>
+    /// Tests for ProcessReader against a stand-in process, each test runs with the page cache
+    /// off and on.
+    /// </summary>
+    internal class ProcessReaderTests : IDisposable
+    {
+        /// <summary>
+        /// The stand-in process
+        /// </summary>
+        private readonly Process StandIn;
+
+        /// <summary>
+        /// Address of the stand-in's mapping
+        /// </summary>
+        private readonly long Address;
+
+        /// <summary>
+        /// Address of the stand-in's unreadable page
+        /// </summary>
+        private long Unreadable => Address + (StandInProcess.PageCount - 1) * MemoryUtil.PageSize;
+
+        /// <summary>
+        /// Starts the stand-in process
+        /// </summary>
+        public ProcessReaderTests()
+        {
+            var self = Process.GetCurrentProcess().MainModule.FileName;
+            var arguments = "--stand-in";
+
+            // Under "dotnet PhilLibX.Tests.dll" the main module is the host, pass the assembly on
+            if (System.IO.Path.GetFileNameWithoutExtension(self) == "dotnet")
+                arguments = "\"" + typeof(ProcessReaderTests).Assembly.Location + "\" " + arguments;
+
+            StandIn = Process.Start(new ProcessStartInfo(self, arguments)
+            {
+                UseShellExecute = false,
+                RedirectStandardInput = true,
+                RedirectStandardOutput = true,
+            });
+
+            Address = long.Parse(StandIn.StandardOutput.ReadLine().Substring(2), NumberStyles.HexNumber);
+        }
+
+        /// <summary>
+        /// Gets the tests to run
+        /// </summary>
+        public IEnumerable<KeyValuePair<string, Action<ProcessReader>>> GetTests()
+        {
+            yield return new KeyValuePair<string, Action<ProcessReader>>("Primitives", Primitives);
+            yield return new KeyValuePair<string, Action<ProcessReader>>("StringAcrossPages", StringAcrossPages);
+            yield return new KeyValuePair<string, Action<ProcessReader>>("Batch", Batch);
+            yield return new KeyValuePair<string, Action<ProcessReader>>("ShortRead", ShortRead);
+            yield return new KeyValuePair<string, Action<ProcessReader>>("Invalidate", Invalidate);
+            yield return new KeyValuePair<string, Action<ProcessReader>>("EvictionKeepsNeededPages", EvictionKeepsNeededPages);
+            yield return new KeyValuePair<string, Action<ProcessReader>>("FindBytes", FindBytes);
+        }
+
+        /// <summary>
+        /// Creates a reader for the stand-in
+        /// </summary>
+        public ProcessReader CreateReader(bool cacheEnabled)
+        {
+            return new ProcessReader(StandIn) { CacheEnabled = cacheEnabled };
+        }
+
+        private void Primitives(ProcessReader reader)
+        {
+            var expected = Expected(0x10, 8);
+
+            Assert(reader.ReadInt64(Address + 0x10) == BitConverter.ToInt64(expected, 0), "ReadInt64");
+            Assert(reader.ReadUInt32(Address + 0x10) == BitConverter.ToUInt32(expected, 0), "ReadUInt32");
+            Assert(reader.ReadInt16(Address + 0x10) == BitConverter.ToInt16(expected, 0), "ReadInt16");
+            Assert(reader.ReadDouble(Address + 0x10).Equals(BitConverter.ToDouble(expected, 0)), "ReadDouble");
+
+            // Crosses into the second page
+            var crossing = Expected(MemoryUtil.PageSize - 2, 4);
+            Assert(reader.ReadInt32(Address + MemoryUtil.PageSize - 2) == BitConverter.ToInt32(crossing, 0), "ReadInt32 across pages");
+        }
+
+        private void StringAcrossPages(ProcessReader reader)
+        {
+            Assert(reader.ReadNullTerminatedString(Address + StandInProcess.TextOffset) == StandInProcess.Text, "Full buffer");
+            Assert(reader.ReadNullTerminatedString(Address + StandInProcess.TextOffset, 3) == StandInProcess.Text, "Small buffer");
+        }
+
+        private void Batch(ProcessReader reader)
+        {
+            var ranges = new List<MemoryRange>();
+
+            for (int i = 0; i < 2000; i++)
+                ranges.Add(new MemoryRange(Address + (i * 37) % (2 * MemoryUtil.PageSize), 1 + i % 300));
+
+            var results = reader.ReadBatch(ranges);
+
+            for (int i = 0; i < ranges.Count; i++)
+                AssertEqual(results[i], Expected((int)(ranges[i].Address - Address), ranges[i].Length), "Range " + i);
+        }
+
+        private void ShortRead(ProcessReader reader)
+        {
+            var buffer = new byte[16];
+
+            // The cache reads whole pages so it returns the readable part, a direct read fails as a whole
+            var read = reader.ReadBytes(Unreadable - 8, buffer, 0, 16);
+
+            Assert(read == (reader.CacheEnabled ? 8 : 0), "Read into the unreadable page returned " + read);
+            AssertEqual(new ArraySegment<byte>(buffer, 0, read).ToArray(), Expected((int)(Unreadable - 8 - Address), read), "Readable part");
+            Assert(reader.ReadBytes(Unreadable, buffer, 0, 4) == 0, "Read of the unreadable page");
+
+            // Nothing can be read, so the string is empty rather than garbage
+            Assert(reader.ReadNullTerminatedString(Unreadable) == string.Empty, "String from the unreadable page");
+        }
+
+        private void Invalidate(ProcessReader reader)
+        {
+            var before = reader.ReadInt64(Address);
+
+            Flip();
+
+            // A cached reader keeps serving the old page until it's told the memory changed
+            if (reader.CacheEnabled)
+            {
+                Assert(reader.ReadInt64(Address) == before, "Cached value");
+                reader.Invalidate(Address, 8);
+            }
+
+            Assert(reader.ReadInt64(Address) == ~before, "New value");
+
+            Flip();
+        }
+
+        private void EvictionKeepsNeededPages(ProcessReader reader)
+        {
+            reader.MaxCachedPages = 1;
+
+            // Caches the first page, then needs it again alongside the second
+            reader.ReadInt32(Address);
+
+            var buffer = new byte[8];
+            Assert(reader.ReadBytes(Address + MemoryUtil.PageSize - 4, buffer, 0, 8) == 8, "Read across the evicted boundary");
+            AssertEqual(buffer, Expected(MemoryUtil.PageSize - 4, 8), "Data across the evicted boundary");
+        }
+
+        private void FindBytes(ProcessReader reader)
+        {
+            const int chunkSize = 0x800;
+
+            var memory = Expected(0, (StandInProcess.PageCount - 1) * MemoryUtil.PageSize);
+            var end = Address + StandInProcess.PageCount * MemoryUtil.PageSize;
+
+            // The stand-in's bytes step by 7 and by 8 every 256 bytes, so a needle that crosses
+            // 0x800 is unique and straddles the first chunk, one that doesn't repeats in every chunk
+            var unique = Array.ConvertAll(Expected(chunkSize - 3, 8), x => (byte?)x);
+            var repeated = new byte?[] { null, memory[0x11], memory[0x12], null };
+            var wildcards = (byte?[])unique.Clone();
+            wildcards[0] = null;
+            wildcards[wildcards.Length - 1] = null;
+
+            foreach (var needle in new[] { unique, repeated, wildcards })
+            {
+                var expected = BytePatternTests.Scan(memory, Address, memory.Length, needle);
+
+                Assert(expected.Length > 0, "Expected a match");
+                BytePatternTests.AssertEqual(reader.FindBytes(needle, Address, end, false, chunkSize), expected, "All matches");
+                BytePatternTests.AssertEqual(reader.FindBytes(needle, Address, end, true, chunkSize), new[] { expected[0] }, "First match");
+            }
+        }
+
+        /// <summary>
+        /// Has the stand-in invert its first 8 bytes
+        /// </summary>
+        private void Flip()
+        {
+            StandIn.StandardInput.WriteLine("flip");
+            StandIn.StandardInput.Flush();
+            StandIn.StandardOutput.ReadLine();
+        }
+
+        /// <summary>
+        /// Gets the bytes the stand-in wrote at the given offset
+        /// </summary>
+        private static byte[] Expected(int offset, int count)
+        {
+            var result = new byte[count];
+            var text = System.Text.Encoding.ASCII.GetBytes(StandInProcess.Text + "\0");
+
+            for (int i = 0; i < count; i++)
+            {
+                var position = offset + i;
+
+                if (position >= StandInProcess.TextOffset && position < StandInProcess.TextOffset + text.Length)
+                    result[i] = text[position - StandInProcess.TextOffset];
+                else
+                    result[i] = StandInProcess.GetByte(position);
+            }
+
+            return result;
+        }
+
+        private static void Assert(bool condition, string message)
+        {
+            if (!condition)
+                throw new Exception(message);
+        }
+
+        private static void AssertEqual(byte[] actual, byte[] expected, string message)
+        {
+            Assert(actual.Length == expected.Length, message + ": length");
+
+            for (int i = 0; i < actual.Length; i++)
+                Assert(actual[i] == expected[i], string.Format("{0}: byte {1} is 0x{2:X2}, expected 0x{3:X2}", message, i, actual[i], expected[i]));
+        }
+
+        /// <summary>
+        /// Closes the stand-in
+        /// </summary>
+        public void Dispose()
+        {
+            StandIn.StandardInput.Close();
+            StandIn.WaitForExit();
+            StandIn.Dispose();
+        }
+    }
+}
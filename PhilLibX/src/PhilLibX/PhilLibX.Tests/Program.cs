@@ -0,0 +1,90 @@
+﻿// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: Program.cs
+// Author: Philip/Scobalula
+// Description: Runs the PhilLibX tests.
+using System;
+using PhilLibX.IO;
+
+namespace PhilLibX.Tests
+{
+    /// <summary>
+    /// Runs the PhilLibX tests, the exit code is the number of failures
+    /// </summary>
+    internal static class Program
+    {
+        private static int Main(string[] args)
+        {
+            if (args.Length > 0 && args[0] == "--stand-in")
+                return StandInProcess.Run();
+
+            var failures = 0;
+
+            foreach (var test in BytePatternTests.GetTests())
+            {
+                var name = "BytePattern." + test.Key;
+
+                try
+                {
+                    test.Value();
+                    Console.WriteLine("PASS {0}", name);
+                }
+                catch (Exception e)
+                {
+                    Console.WriteLine("FAIL {0}: {1}", name, e.Message);
+                    failures++;
+                }
+            }
+
+            if (!MemoryUtil.IsLinux)
+            {
+                Console.WriteLine("The stand-in process tests only run on Linux");
+                return failures;
+            }
+
+            using (var tests = new ProcessReaderTests())
+            {
+                foreach (var test in tests.GetTests())
+                {
+                    foreach (var cacheEnabled in new[] { false, true })
+                    {
+                        var name = string.Format("ProcessReader.{0} (cache {1})", test.Key, cacheEnabled ? "on" : "off");
+
+                        try
+                        {
+                            test.Value(tests.CreateReader(cacheEnabled));
+                            Console.WriteLine("PASS {0}", name);
+                        }
+                        catch (Exception e)
+                        {
+                            Console.WriteLine("FAIL {0}: {1}", name, e.Message);
+                            failures++;
+                        }
+                    }
+                }
+            }
+
+            return failures;
+        }
+    }
+}
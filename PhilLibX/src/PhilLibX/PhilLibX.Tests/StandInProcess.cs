@@ -0,0 +1,116 @@
+﻿﻿// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: StandInProcess.cs
+// Author: Philip/Scobalula
+// Description: A process with known memory for the ProcessReader tests to read.
+using System;
+using System.Runtime.InteropServices;
+using System.Text;
+using PhilLibX.IO;
+
+namespace PhilLibX.Tests
+{
+    /// <summary>
+    /// A process with known memory for the ProcessReader tests to read.
+    /// 
+    /// Maps <see cref="PageCount"/> pages, the last of which can't be read, fills them with
+    /// <see cref="GetByte"/>, writes <see cref="Text"/> across the first page boundary, and prints
+    /// the address of the mapping. Each "flip" line on stdin inverts the first 8 bytes, it exits
+    /// once stdin is closed.
+    /// </summary>
+    internal static class StandInProcess
+    {
+        /// <summary>
+        /// Number of pages mapped, the last one is PROT_NONE
+        /// </summary>
+        public const int PageCount = 4;
+
+        /// <summary>
+        /// Offset of the null terminated text, it crosses from the first page into the second
+        /// </summary>
+        public const int TextOffset = 0x1000 - 5;
+
+        /// <summary>
+        /// Text written across the page boundary
+        /// </summary>
+        public const string Text = "cross page string";
+
+        private const int PROT_NONE = 0;
+        private const int PROT_READ = 1;
+        private const int PROT_WRITE = 2;
+        private const int MAP_PRIVATE = 0x02;
+        private const int MAP_ANONYMOUS = 0x20;
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern IntPtr mmap(IntPtr address, UIntPtr length, int protection, int flags, int fd, IntPtr offset);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int mprotect(IntPtr address, UIntPtr length, int protection);
+
+        /// <summary>
+        /// Gets the byte the stand-in writes at the given offset
+        /// </summary>
+        public static byte GetByte(int offset) => (byte)(offset * 7 + (offset >> 8));
+
+        /// <summary>
+        /// Runs the stand-in until stdin is closed
+        /// </summary>
+        public static int Run()
+        {
+            var size = new UIntPtr((uint)(PageCount * MemoryUtil.PageSize));
+            var address = mmap(IntPtr.Zero, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, IntPtr.Zero);
+
+            if (address == new IntPtr(-1))
+                return 2;
+
+            var data = new byte[(PageCount - 1) * MemoryUtil.PageSize];
+
+            for (int i = 0; i < data.Length; i++)
+                data[i] = GetByte(i);
+
+            var text = Encoding.ASCII.GetBytes(Text);
+            Buffer.BlockCopy(text, 0, data, TextOffset, text.Length);
+            data[TextOffset + text.Length] = 0;
+
+            Marshal.Copy(data, 0, address, data.Length);
+
+            if (mprotect(address + data.Length, new UIntPtr((uint)MemoryUtil.PageSize), PROT_NONE) != 0)
+                return 2;
+
+            Console.WriteLine("0x{0:X}", address.ToInt64());
+
+            string line;
+
+            while ((line = Console.ReadLine()) != null)
+            {
+                if (line == "flip")
+                {
+                    Marshal.WriteInt64(address, ~Marshal.ReadInt64(address));
+                    Console.WriteLine("ok");
+                }
+            }
+
+            return 0;
+        }
+    }
+}
@@ -35,6 +35,99 @@ namespace PhilLibX
     /// </summary>
     public static class Bytes
     {
+        /// <summary>
+        /// Largest scratch buffer kept per thread, larger requests get a new array
+        /// </summary>
+        private const int MaxScratchSize = 0x100000;
+
+        /// <summary>
+        /// Per thread buffer for reads that would otherwise allocate
+        /// </summary>
+        [ThreadStatic]
+        private static byte[] ScratchBuffer;
+
+        /// <summary>
+        /// Caches whether or not a type is blittable
+        /// </summary>
+        /// <typeparam name="T">Type</typeparam>
+        private static class BlittableType<T>
+        {
+            /// <summary>
+            /// Whether or not arrays of the type can be pinned, which means its memory layout matches its marshaled layout
+            /// </summary>
+            public static readonly bool Value = Check();
+
+            private static bool Check()
+            {
+                try
+                {
+                    GCHandle.Alloc(new T[1], GCHandleType.Pinned).Free();
+                    return true;
+                }
+                catch (ArgumentException)
+                {
+                    return false;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Caches the size of a type in raw data
+        /// </summary>
+        /// <typeparam name="T">Type</typeparam>
+        private static class TypeSize<T>
+        {
+            /// <summary>
+            /// Size in bytes, primitives use their in memory size as bool and char marshal differently
+            /// </summary>
+            public static readonly int Value = typeof(T).IsPrimitive ? Buffer.ByteLength(new T[1]) : Marshal.SizeOf<T>();
+        }
+
+        /// <summary>
+        /// Gets the size of the type in raw data
+        /// </summary>
+        /// <typeparam name="T">Type</typeparam>
+        /// <returns>Size in bytes</returns>
+        public static int SizeOf<T>()
+        {
+            return TypeSize<T>.Value;
+        }
+
+        /// <summary>
+        /// Checks if the type is blittable, i.e. can be copied to and from raw bytes without marshaling
+        /// </summary>
+        /// <typeparam name="T">Type</typeparam>
+        /// <returns>True if blittable, otherwise false</returns>
+        public static bool IsBlittable<T>()
+        {
+            return BlittableType<T>.Value;
+        }
+
+        /// <summary>
+        /// Gets a buffer of at least the given size, reused by the calling thread so only valid until its next call
+        /// </summary>
+        /// <param name="size">Minimum size</param>
+        /// <returns>Buffer</returns>
+        public static byte[] GetScratchBuffer(int size)
+        {
+            if (size > MaxScratchSize)
+                return new byte[size];
+
+            var buffer = ScratchBuffer;
+
+            if (buffer == null || buffer.Length < size)
+            {
+                // Grow in powers of two so a few growing reads don't reallocate each time
+                int newSize = 256;
+                while (newSize < size)
+                    newSize <<= 1;
+
+                ScratchBuffer = buffer = new byte[newSize];
+            }
+
+            return buffer;
+        }
+
         /// <summary>
         /// Reads a null terminated string from a byte array
         /// </summary>
@@ -72,10 +165,15 @@ namespace PhilLibX
         {
             // Get handles
             GCHandle handle = GCHandle.Alloc(data, GCHandleType.Pinned);
-            T structure = (T)Marshal.PtrToStructure(handle.AddrOfPinnedObject(), typeof(T));
-            handle.Free();
-            // Return result
-            return structure;
+
+            try
+            {
+                return (T)Marshal.PtrToStructure(handle.AddrOfPinnedObject(), typeof(T));
+            }
+            finally
+            {
+                handle.Free();
+            }
         }
 
         /// <summary>
@@ -87,12 +185,79 @@ namespace PhilLibX
         /// <returns>Resulting Structure</returns>
         public static T BytesToStruct<T>(byte[] data, int startIndex)
         {
-            // Size of Struct
-            int size = Marshal.SizeOf<T>();
-            byte[] buffer = new byte[size];
-            Buffer.BlockCopy(data, startIndex, buffer, 0, size);
-            // Return result
-            return BytesToStruct<T>(buffer);
+            if (startIndex < 0 || startIndex + Marshal.SizeOf<T>() > data.Length)
+                throw new ArgumentOutOfRangeException(nameof(startIndex));
+
+            // Pin the source rather than copying out of it
+            GCHandle handle = GCHandle.Alloc(data, GCHandleType.Pinned);
+
+            try
+            {
+                return (T)Marshal.PtrToStructure(handle.AddrOfPinnedObject() + startIndex, typeof(T));
+            }
+            finally
+            {
+                handle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Converts an array of bytes to an array of structs, blittable structs are copied straight across
+        /// </summary>
+        /// <typeparam name="T">Struct Type</typeparam>
+        /// <param name="data">Raw data</param>
+        /// <param name="startIndex">Start index to convert from</param>
+        /// <param name="count">Number of structs</param>
+        /// <returns>Resulting Structures</returns>
+        public static T[] BytesToArray<T>(byte[] data, int startIndex, int count)
+        {
+            int size = SizeOf<T>();
+            var result = new T[count];
+
+            if (startIndex < 0 || startIndex + (long)size * count > data.Length)
+                throw new ArgumentOutOfRangeException(nameof(startIndex));
+
+            if (count == 0)
+                return result;
+
+            if (IsBlittable<T>())
+            {
+                // Layout matches, one copy into the pinned result
+                GCHandle resultHandle = GCHandle.Alloc(result, GCHandleType.Pinned);
+
+                try
+                {
+                    Marshal.Copy(data, startIndex, resultHandle.AddrOfPinnedObject(), size * count);
+                }
+                finally
+                {
+                    resultHandle.Free();
+                }
+            }
+            else if (typeof(T).IsPrimitive)
+            {
+                // bool and char, same layout but not blittable
+                Buffer.BlockCopy(data, startIndex, result, 0, size * count);
+            }
+            else
+            {
+                // Needs marshaling, but only pin the source once
+                GCHandle handle = GCHandle.Alloc(data, GCHandleType.Pinned);
+
+                try
+                {
+                    var address = handle.AddrOfPinnedObject() + startIndex;
+
+                    for (int i = 0; i < count; i++)
+                        result[i] = (T)Marshal.PtrToStructure(address + i * size, typeof(T));
+                }
+                finally
+                {
+                    handle.Free();
+                }
+            }
+
+            return result;
         }
 
         /// <summary>
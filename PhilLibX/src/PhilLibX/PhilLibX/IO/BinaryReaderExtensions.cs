@@ -120,27 +120,39 @@ namespace PhilLibX.IO
         public static T[] ReadArray<T>(this BinaryReader br, int count)
         {
             // Get Byte Count
-            var size = count * Marshal.SizeOf<T>();
-            // Allocate Array
-            var result = new T[count];
-            // Check for primitives, we can use BlockCopy for them
-            if (typeof(T).IsPrimitive)
+            var size = count * Bytes.SizeOf<T>();
+            // Blittable types can be read straight into the array
+            if (Bytes.IsBlittable<T>())
             {
-                // Copy
-                Buffer.BlockCopy(br.ReadBytes(size), 0, result, 0, size);
-            }
-            // Slightly more complex structures, we can use the struct functs
-            else
-            {
-                // Loop through
-                for (int i = 0; i < count; i++)
+                // Allocate Array
+                var result = new T[count];
+                // Pin it and fill it a chunk at a time through the scratch buffer
+                GCHandle handle = GCHandle.Alloc(result, GCHandleType.Pinned);
+
+                try
+                {
+                    var address = handle.AddrOfPinnedObject();
+                    var buffer = Bytes.GetScratchBuffer(Math.Min(size, 0x100000));
+
+                    for (int offset = 0; offset < size;)
+                    {
+                        int chunk = Math.Min(size - offset, buffer.Length);
+                        br.ReadFully(buffer, chunk);
+                        Marshal.Copy(buffer, 0, address + offset, chunk);
+                        offset += chunk;
+                    }
+                }
+                finally
                 {
-                    // Read it into result
-                    result[i] = br.ReadStruct<T>();
+                    handle.Free();
                 }
+
+                return result;
             }
-            // Done
-            return result;
+            // Everything else is read in one go and converted
+            var data = Bytes.GetScratchBuffer(size);
+            br.ReadFully(data, size);
+            return Bytes.BytesToArray<T>(data, 0, count);
         }
 
         /// <summary>
@@ -151,11 +163,29 @@ namespace PhilLibX.IO
         /// <returns></returns>
         public static T ReadStruct<T>(this BinaryReader br)
         {
-            byte[] data = br.ReadBytes(Marshal.SizeOf<T>());
-            GCHandle handle = GCHandle.Alloc(data, GCHandleType.Pinned);
-            T theStructure = (T)Marshal.PtrToStructure(handle.AddrOfPinnedObject(), typeof(T));
-            handle.Free();
-            return theStructure;
+            int size = Marshal.SizeOf<T>();
+            byte[] data = Bytes.GetScratchBuffer(size);
+            br.ReadFully(data, size);
+            return Bytes.BytesToStruct<T>(data);
+        }
+
+        /// <summary>
+        /// Reads exactly the given number of bytes into the start of the buffer
+        /// </summary>
+        /// <param name="br">Reader</param>
+        /// <param name="buffer">Buffer to read into</param>
+        /// <param name="count">Number of bytes</param>
+        public static void ReadFully(this BinaryReader br, byte[] buffer, int count)
+        {
+            for (int offset = 0; offset < count;)
+            {
+                int bytesRead = br.Read(buffer, offset, count - offset);
+
+                if (bytesRead == 0)
+                    throw new EndOfStreamException();
+
+                offset += bytesRead;
+            }
         }
 
         /// <summary>
@@ -243,55 +273,41 @@ namespace PhilLibX.IO
             // List of offsets in file.
             List<long> offsets = new List<long>();
 
-            // Buffer
-            byte[] buffer = new byte[1048576];
+            // Pattern to search for
+            BytePattern pattern = new BytePattern(needle);
+
+            // Buffer, with room for the tail of the last read
+            byte[] buffer = new byte[1048576 + needle.Length];
 
             // Bytes Read
             int bytesRead = 0;
 
-            // Starting Offset
-            long readBegin = br.BaseStream.Position;
-
-            // Needle Index
-            int needleIndex = 0;
+            // Bytes carried over from the last read
+            int carried = 0;
 
-            // Byte Array Index
-            int bufferIndex = 0;
+            // Offset of the start of the buffer
+            long bufferBegin = br.BaseStream.Position;
 
-            // Read chunk of file
-            while ((bytesRead = br.BaseStream.Read(buffer, 0, buffer.Length)) != 0)
+            // Read chunk of file after the carried bytes
+            while ((bytesRead = br.BaseStream.Read(buffer, carried, buffer.Length - carried)) != 0)
             {
-                // Loop through byte array
-                for (bufferIndex = 0; bufferIndex < bytesRead; bufferIndex++)
-                {
-                    // Check if current bytes match
-                    if (needle[needleIndex] == buffer[bufferIndex])
-                    {
-                        // Increment
-                        needleIndex++;
-
-                        // Check if we have a match
-                        if (needleIndex == needle.Length)
-                        {
-                            // Add Offset
-                            offsets.Add(readBegin + bufferIndex + 1 - needle.Length);
+                int count = carried + bytesRead;
 
-                            // Reset Index
-                            needleIndex = 0;
+                // Find all matches that fit in what we have
+                for (int index = pattern.IndexOf(buffer, 0, count); index >= 0; index = pattern.IndexOf(buffer, index + 1, count))
+                {
+                    // Add Offset
+                    offsets.Add(bufferBegin + index);
 
-                            // If only first occurence, end search
-                            if (firstOccurence)
-                                return offsets.ToArray();
-                        }
-                    }
-                    else
-                    {
-                        // Reset Index
-                        needleIndex = 0;
-                    }
+                    // If only first occurence, end search
+                    if (firstOccurence)
+                        return offsets.ToArray();
                 }
-                // Set next offset
-                readBegin += bytesRead;
+
+                // Carry over the tail, it could be the start of a match that straddles the next read
+                carried = Math.Min(needle.Length - 1, count);
+                Buffer.BlockCopy(buffer, count - carried, buffer, 0, carried);
+                bufferBegin += count - carried;
             }
             // Return offsets as an array
             return offsets.ToArray();
@@ -0,0 +1,141 @@
+﻿// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: IO/BytePattern.cs
+// Author: Philip/Scobalula
+// Description: A byte pattern with wildcards that can be searched for with Boyer-Moore-Horspool.
+using System;
+using System.Globalization;
+
+namespace PhilLibX.IO
+{
+    /// <summary>
+    /// A byte pattern with wildcards that can be searched for with Boyer-Moore-Horspool.
+    /// </summary>
+    public class BytePattern
+    {
+        /// <summary>
+        /// Pattern bytes, wildcards are 0
+        /// </summary>
+        private readonly byte[] Bytes;
+
+        /// <summary>
+        /// Whether or not each byte must match, false for wildcards
+        /// </summary>
+        private readonly bool[] Mask;
+
+        /// <summary>
+        /// How far to move for the byte under the last position of the pattern
+        /// </summary>
+        private readonly int[] Shift = new int[256];
+
+        /// <summary>
+        /// Gets the length of the pattern
+        /// </summary>
+        public int Length => Bytes.Length;
+
+        /// <summary>
+        /// Initializes a Byte Pattern
+        /// </summary>
+        /// <param name="needle">Bytes to search for, null for wildcards</param>
+        public BytePattern(byte?[] needle)
+        {
+            if (needle == null || needle.Length == 0)
+                throw new ArgumentException("Pattern must have at least one byte", nameof(needle));
+
+            Bytes = new byte[needle.Length];
+            Mask = new bool[needle.Length];
+
+            int last = needle.Length - 1;
+            int lastWildcard = -1;
+
+            for (int i = 0; i < needle.Length; i++)
+            {
+                Mask[i] = needle[i].HasValue;
+                Bytes[i] = needle[i] ?? 0;
+
+                if (!Mask[i] && i < last)
+                    lastWildcard = i;
+            }
+
+            // A wildcard matches any byte, so no byte can move us past it
+            for (int i = 0; i < Shift.Length; i++)
+                Shift[i] = last - lastWildcard;
+
+            for (int i = 0; i < last; i++)
+            {
+                if (Mask[i])
+                    Shift[Bytes[i]] = Math.Min(Shift[Bytes[i]], last - i);
+            }
+        }
+
+        /// <summary>
+        /// Initializes a Byte Pattern with no wildcards
+        /// </summary>
+        /// <param name="needle">Bytes to search for</param>
+        public BytePattern(byte[] needle) : this(Array.ConvertAll(needle, x => (byte?)x)) { }
+
+        /// <summary>
+        /// Parses a pattern in the form "48 8B ?? 05", ? or ?? are wildcards
+        /// </summary>
+        /// <param name="pattern">Pattern string</param>
+        /// <returns>Resulting pattern</returns>
+        public static BytePattern Parse(string pattern)
+        {
+            var split = pattern.Split(new[] { ' ' }, StringSplitOptions.RemoveEmptyEntries);
+            var needle = new byte?[split.Length];
+
+            for (int i = 0; i < split.Length; i++)
+            {
+                if (split[i] != "?" && split[i] != "??")
+                    needle[i] = byte.Parse(split[i], NumberStyles.HexNumber);
+            }
+
+            return new BytePattern(needle);
+        }
+
+        /// <summary>
+        /// Finds the first match that fits entirely within the given range of the buffer
+        /// </summary>
+        /// <param name="buffer">Buffer to search</param>
+        /// <param name="start">Index to start at</param>
+        /// <param name="end">Index to end at, exclusive</param>
+        /// <returns>Index of the match, -1 if not found</returns>
+        public int IndexOf(byte[] buffer, int start, int end)
+        {
+            int last = Bytes.Length - 1;
+
+            for (int i = start; i <= end - Bytes.Length; i += Shift[buffer[i + last]])
+            {
+                int j = last;
+
+                while (j >= 0 && (!Mask[j] || Bytes[j] == buffer[i + j]))
+                    j--;
+
+                if (j < 0)
+                    return i;
+            }
+
+            return -1;
+        }
+    }
+}
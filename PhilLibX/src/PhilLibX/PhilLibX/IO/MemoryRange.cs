@@ -0,0 +1,54 @@
+﻿// ------------------------------------------------------------------------
+// PhilLibX - My Utility Library
+// Copyright(c) 2018 Philip/Scobalula
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// ------------------------------------------------------------------------
+// File: IO/MemoryRange.cs
+// Author: Philip/Scobalula
+// Description: A range of memory in another process to read in a batch.
+namespace PhilLibX.IO
+{
+    /// <summary>
+    /// A range of memory in another process to read in a batch.
+    /// </summary>
+    public struct MemoryRange
+    {
+        /// <summary>
+        /// Address of the data to be read.
+        /// </summary>
+        public long Address;
+
+        /// <summary>
+        /// Number of bytes to be read.
+        /// </summary>
+        public int Length;
+
+        /// <summary>
+        /// Initializes a Memory Range
+        /// </summary>
+        /// <param name="address">Address of the data to be read.</param>
+        /// <param name="length">Number of bytes to be read.</param>
+        public MemoryRange(long address, int length)
+        {
+            Address = address;
+            Length = length;
+        }
+    }
+}
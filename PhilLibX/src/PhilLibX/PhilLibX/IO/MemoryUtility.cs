@@ -51,6 +51,47 @@ namespace PhilLibX.IO
         /// </summary>
         public const int ProcessVMOperation = 0x0008;
 
+        /// <summary>
+        /// Size of a page, reads that must not fail over unmapped memory don't cross these
+        /// </summary>
+        public const int PageSize = 0x1000;
+
+        /// <summary>
+        /// Maximum number of ranges process_vm_readv accepts in one call (IOV_MAX)
+        /// </summary>
+        private const int MaxIOVecs = 1024;
+
+        /// <summary>
+        /// Gets whether or not process memory is read with process_vm_readv rather than ReadProcessMemory
+        /// </summary>
+        public static bool IsLinux => Environment.OSVersion.Platform == PlatformID.Unix;
+
+        /// <summary>
+        /// Buffer for reading primitives without allocating
+        /// </summary>
+        [ThreadStatic]
+        private static byte[] Scratch;
+
+        /// <summary>
+        /// Default number of bytes read per chunk when scanning
+        /// </summary>
+        public const int ScanChunkSize = 0x100000;
+
+        /// <summary>
+        /// Region state of committed pages
+        /// </summary>
+        private const uint MemCommit = 0x1000;
+
+        /// <summary>
+        /// Page protection that can't be read
+        /// </summary>
+        private const uint PageNoAccess = 0x01;
+
+        /// <summary>
+        /// Page protection that faults on first access
+        /// </summary>
+        private const uint PageGuard = 0x100;
+
         /// <summary>
         /// Reads bytes from a Processes Memory and returns a byte array of read data.
         /// </summary>
@@ -68,6 +109,163 @@ namespace PhilLibX.IO
             return buffer;
         }
 
+        /// <summary>
+        /// Reads bytes from a Processes Memory into the given buffer.
+        /// </summary>
+        /// <param name="processHandle">A handle to the process with memory that is being read. The handle must have PROCESS_VM_READ access to the process.</param>
+        /// <param name="address">The address of the data to be read.</param>
+        /// <param name="buffer">Buffer to read into</param>
+        /// <param name="offset">Offset within the buffer</param>
+        /// <param name="count">The number of bytes to be read from the specified process.</param>
+        /// <returns>Number of bytes read</returns>
+        public static int ReadBytes(IntPtr processHandle, long address, byte[] buffer, int offset, int count)
+        {
+            int bytesRead;
+
+            if (offset == 0)
+            {
+                NativeMethods.ReadProcessMemory((int)processHandle, address, buffer, count, out bytesRead);
+                return bytesRead;
+            }
+
+            GCHandle handle = GCHandle.Alloc(buffer, GCHandleType.Pinned);
+
+            try
+            {
+                NativeMethods.ReadProcessMemory((int)processHandle, address, handle.AddrOfPinnedObject() + offset, count, out bytesRead);
+                return bytesRead;
+            }
+            finally
+            {
+                handle.Free();
+            }
+        }
+
+        /// <summary>
+        /// Reads each range from a Processes Memory into the buffer one after another, ranges that can't be read are left untouched.
+        /// </summary>
+        /// <param name="processHandle">A handle to the process with memory that is being read. The handle must have PROCESS_VM_READ access to the process.</param>
+        /// <param name="ranges">Ranges to read</param>
+        /// <param name="buffer">Buffer to read into, must fit the total length of the ranges</param>
+        /// <param name="offset">Offset within the buffer</param>
+        /// <returns>Number of bytes read for each range</returns>
+        public static int[] ReadBatch(IntPtr processHandle, IList<MemoryRange> ranges, byte[] buffer, int offset)
+        {
+            var results = new int[ranges.Count];
+            GCHandle handle = GCHandle.Alloc(buffer, GCHandleType.Pinned);
+
+            try
+            {
+                var bufferAddress = handle.AddrOfPinnedObject();
+
+                // Windows has no scatter read, but pinning once still saves a pin per range
+                for (int i = 0; i < ranges.Count; i++)
+                {
+                    NativeMethods.ReadProcessMemory((int)processHandle, ranges[i].Address, bufferAddress + offset, ranges[i].Length, out results[i]);
+                    offset += ranges[i].Length;
+                }
+            }
+            finally
+            {
+                handle.Free();
+            }
+
+            return results;
+        }
+
+        /// <summary>
+        /// Reads bytes from a Processes Memory into the given buffer using process_vm_readv (Linux).
+        /// </summary>
+        /// <param name="processID">ID of the process with memory that is being read.</param>
+        /// <param name="address">The address of the data to be read.</param>
+        /// <param name="buffer">Buffer to read into</param>
+        /// <param name="offset">Offset within the buffer</param>
+        /// <param name="count">The number of bytes to be read from the specified process.</param>
+        /// <returns>Number of bytes read</returns>
+        public static int ReadBytesLinux(int processID, long address, byte[] buffer, int offset, int count)
+        {
+            return ReadBatchLinux(processID, new[] { new MemoryRange(address, count) }, buffer, offset)[0];
+        }
+
+        /// <summary>
+        /// Reads each range from a Processes Memory into the buffer one after another using process_vm_readv (Linux),
+        /// up to 1024 ranges are read per call, ranges that can't be read are left untouched.
+        /// </summary>
+        /// <param name="processID">ID of the process with memory that is being read.</param>
+        /// <param name="ranges">Ranges to read</param>
+        /// <param name="buffer">Buffer to read into, must fit the total length of the ranges</param>
+        /// <param name="offset">Offset within the buffer</param>
+        /// <returns>Number of bytes read for each range</returns>
+        public static int[] ReadBatchLinux(int processID, IList<MemoryRange> ranges, byte[] buffer, int offset)
+        {
+            var results = new int[ranges.Count];
+            var local = new NativeMethods.IOVec[1];
+            var remote = new NativeMethods.IOVec[Math.Min(ranges.Count, MaxIOVecs)];
+            GCHandle handle = GCHandle.Alloc(buffer, GCHandleType.Pinned);
+
+            try
+            {
+                var bufferAddress = handle.AddrOfPinnedObject();
+                int index = 0;
+
+                while (index < ranges.Count)
+                {
+                    int count = Math.Min(ranges.Count - index, MaxIOVecs);
+                    long total = 0;
+
+                    for (int i = 0; i < count; i++)
+                    {
+                        remote[i].Base = new IntPtr(ranges[index + i].Address);
+                        remote[i].Length = new UIntPtr((uint)ranges[index + i].Length);
+                        total += ranges[index + i].Length;
+                    }
+
+                    // One local buffer covering all of them, the remote ranges fill it back to back
+                    local[0].Base = bufferAddress + offset;
+                    local[0].Length = new UIntPtr((ulong)total);
+
+                    long bytesRead = (long)NativeMethods.process_vm_readv(processID, local, new UIntPtr(1), remote, new UIntPtr((uint)count), UIntPtr.Zero);
+
+                    // Ranges are read in order and never split, so everything before the first short range was read
+                    int done = 0;
+
+                    while (done < count && bytesRead >= ranges[index + done].Length)
+                    {
+                        results[index + done] = ranges[index + done].Length;
+                        bytesRead -= ranges[index + done].Length;
+                        offset += ranges[index + done].Length;
+                        done++;
+                    }
+
+                    // Skip the range that failed and carry on after it
+                    if (done < count)
+                    {
+                        offset += ranges[index + done].Length;
+                        done++;
+                    }
+
+                    index += done;
+                }
+            }
+            finally
+            {
+                handle.Free();
+            }
+
+            return results;
+        }
+
+        /// <summary>
+        /// Reads a small value into the thread's scratch buffer, zeroed if the read fails
+        /// </summary>
+        private static byte[] ReadScratch(IntPtr processHandle, long address, int numBytes)
+        {
+            var buffer = Scratch ?? (Scratch = new byte[8]);
+            Array.Clear(buffer, 0, numBytes);
+            NativeMethods.ReadProcessMemory((int)processHandle, address, buffer, numBytes, out int bytesRead);
+            return buffer;
+        }
+
         /// <summary>
         /// Reads a 64Bit Integer from a Processes Memory
         /// </summary>
@@ -76,7 +274,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public static long ReadInt64(IntPtr processHandle, long address)
         {
-            return BitConverter.ToInt64(ReadBytes(processHandle, address, 8), 0);
+            return BitConverter.ToInt64(ReadScratch(processHandle, address, 8), 0);
         }
 
         /// <summary>
@@ -87,7 +285,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public static ulong ReadUInt64(IntPtr processHandle, long address)
         {
-            return BitConverter.ToUInt64(ReadBytes(processHandle, address, 8), 0);
+            return BitConverter.ToUInt64(ReadScratch(processHandle, address, 8), 0);
         }
 
         /// <summary>
@@ -98,7 +296,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public static int ReadInt32(IntPtr processHandle, long address)
         {
-            return BitConverter.ToInt32(ReadBytes(processHandle, address, 4), 0);
+            return BitConverter.ToInt32(ReadScratch(processHandle, address, 4), 0);
         }
 
         /// <summary>
@@ -109,7 +307,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public static uint ReadUInt32(IntPtr processHandle, long address)
         {
-            return BitConverter.ToUInt32(ReadBytes(processHandle, address, 4), 0);
+            return BitConverter.ToUInt32(ReadScratch(processHandle, address, 4), 0);
         }
 
         /// <summary>
@@ -120,7 +318,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public static short ReadInt16(IntPtr processHandle, long address)
         {
-            return BitConverter.ToInt16(ReadBytes(processHandle, address, 4), 0);
+            return BitConverter.ToInt16(ReadScratch(processHandle, address, 2), 0);
         }
 
         /// <summary>
@@ -131,7 +329,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public static ushort ReadUInt16(IntPtr processHandle, long address)
         {
-            return BitConverter.ToUInt16(ReadBytes(processHandle, address, 2), 0);
+            return BitConverter.ToUInt16(ReadScratch(processHandle, address, 2), 0);
         }
 
         /// <summary>
@@ -142,7 +340,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public static float ReadSingle(IntPtr processHandle, long address)
         {
-            return BitConverter.ToSingle(ReadBytes(processHandle, address, 2), 0);
+            return BitConverter.ToSingle(ReadScratch(processHandle, address, 4), 0);
         }
 
         /// <summary>
@@ -153,7 +351,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public static double ReadDouble(IntPtr processHandle, long address)
         {
-            return BitConverter.ToDouble(ReadBytes(processHandle, address, 8), 0);
+            return BitConverter.ToDouble(ReadScratch(processHandle, address, 8), 0);
         }
 
         /// <summary>
@@ -161,26 +359,42 @@ namespace PhilLibX.IO
         /// </summary>
         /// <param name="processHandle">Process Handle Pointer</param>
         /// <param name="address">Memory Address</param>
-        /// <param name="bufferSize">Buffer Read Size</param>
+        /// <param name="bufferSize">Maximum bytes per read, reads never cross a page so a string near unmapped memory still reads</param>
         /// <returns>Resulting String</returns>
-        public static string ReadNullTerminatedString(IntPtr processHandle, long address, int bufferSize = 0xFF)
+        public static string ReadNullTerminatedString(IntPtr processHandle, long address, int bufferSize = PageSize)
         {
-            List<byte> result = new List<byte>();
-
-            byte[] buffer = ReadBytes(processHandle, address, bufferSize);
+            byte[] buffer = new byte[Math.Max(bufferSize, 1)];
+            byte[] result = null;
+            int resultSize = 0;
 
             while (true)
             {
-                for (int i = 0; i < buffer.Length; i++)
-                {
-                    if (buffer[i] == 0x0)
-                        return Encoding.ASCII.GetString(result.ToArray());
+                int count = (int)Math.Min(buffer.Length, PageSize - (address & (PageSize - 1)));
 
-                    result.Add(buffer[i]);
-                }
+                if (ReadBytes(processHandle, address, buffer, 0, count) != count)
+                    break;
+
+                int end = Array.IndexOf(buffer, (byte)0, 0, count);
+
+                // Most strings fit in the first read
+                if (end >= 0 && result == null)
+                    return Encoding.ASCII.GetString(buffer, 0, end);
+
+                int size = end >= 0 ? end : count;
 
-                buffer = ReadBytes(processHandle, address += bufferSize, bufferSize);
+                if (result == null || resultSize + size > result.Length)
+                    Array.Resize(ref result, Math.Max((resultSize + size) * 2, 64));
+
+                Buffer.BlockCopy(buffer, 0, result, resultSize, size);
+                resultSize += size;
+
+                if (end >= 0)
+                    break;
+
+                address += count;
             }
+
+            return result == null ? string.Empty : Encoding.ASCII.GetString(result, 0, resultSize);
         }
 
         /// <summary>
@@ -192,77 +406,247 @@ namespace PhilLibX.IO
         /// <returns>Resulting Struct</returns>
         public static T ReadStruct<T>(IntPtr processHandle, long address)
         {
-            byte[] data = ReadBytes(processHandle, address, Marshal.SizeOf<T>());
-            GCHandle handle = GCHandle.Alloc(data, GCHandleType.Pinned);
-            T theStructure = (T)Marshal.PtrToStructure(handle.AddrOfPinnedObject(), typeof(T));
-            handle.Free();
-            return theStructure;
+            int size = Marshal.SizeOf<T>();
+            byte[] data = Bytes.GetScratchBuffer(size);
+            Array.Clear(data, 0, size);
+            ReadBytes(processHandle, address, data, 0, size);
+            return Bytes.BytesToStruct<T>(data);
+        }
+
+        /// <summary>
+        /// Reads an array of structs from a Processes Memory, blittable structs are read straight into the array in one call
+        /// </summary>
+        /// <typeparam name="T">Struct Type</typeparam>
+        /// <param name="processHandle">Process Handle Pointer</param>
+        /// <param name="address">Memory Address</param>
+        /// <param name="count">Number of structs</param>
+        /// <returns>Resulting Structs</returns>
+        public static T[] ReadArray<T>(IntPtr processHandle, long address, int count)
+        {
+            int size = Bytes.SizeOf<T>() * count;
+
+            if (Bytes.IsBlittable<T>())
+            {
+                var result = new T[count];
+                GCHandle handle = GCHandle.Alloc(result, GCHandleType.Pinned);
+
+                try
+                {
+                    NativeMethods.ReadProcessMemory((int)processHandle, address, handle.AddrOfPinnedObject(), size, out int bytesRead);
+                }
+                finally
+                {
+                    handle.Free();
+                }
+
+                return result;
+            }
+
+            byte[] data = Bytes.GetScratchBuffer(size);
+            Array.Clear(data, 0, size);
+            ReadBytes(processHandle, address, data, 0, size);
+            return Bytes.BytesToArray<T>(data, 0, count);
         }
 
         /// <summary>
         /// Searches for bytes in a processes memory.
         /// </summary>
-        /// <param name="processHandle">A handle to the process with memory that is being read. The handle must have PROCESS_VM_READ access to the process.</param>
-        /// <param name="needle">Byte Sequence to scan for.</param>
+        /// <param name="processHandle">A handle to the process with memory that is being read. The handle must have PROCESS_VM_READ and PROCESS_QUERY_INFORMATION access to the process.</param>
+        /// <param name="needle">Byte Sequence to scan for, null bytes are wildcards.</param>
         /// <param name="startAddress">Address to start the search at.</param>
         /// <param name="endAddress">Address to end the search at.</param>
         /// <param name="bufferSize">Byte Buffer Size</param>
         /// <param name="firstMatch">If we should stop the search at the first result.</param>
-        /// <returns></returns>
-        public static long[] FindBytes(IntPtr processHandle, byte?[] needle, long startAddress, long endAddress, bool firstMatch = false, int bufferSize = 0xFFFF)
+        /// <returns>Results in ascending order</returns>
+        public static long[] FindBytes(IntPtr processHandle, byte?[] needle, long startAddress, long endAddress, bool firstMatch = false, int bufferSize = ScanChunkSize)
         {
-            List<long> results = new List<long>();
-            long searchAddress = startAddress;
+            var chunks = GetScanChunks(GetReadableRegions(processHandle, startAddress, endAddress), needle.Length, bufferSize);
+            return CollectMatches(chunks, new BytePattern(needle), (address, buffer, count) => ReadBytes(processHandle, address, buffer, 0, count), firstMatch);
+        }
 
-            int needleIndex = 0;
-            int bufferIndex = 0;
+        /// <summary>
+        /// Searches for bytes in a processes memory, scanning its committed regions in parallel.
+        /// </summary>
+        /// <param name="processHandle">A handle to the process with memory that is being read. The handle must have PROCESS_VM_READ and PROCESS_QUERY_INFORMATION access to the process.</param>
+        /// <param name="pattern">Pattern to scan for.</param>
+        /// <param name="startAddress">Address to start the search at.</param>
+        /// <param name="endAddress">Address to end the search at.</param>
+        /// <param name="onMatch">Called with the address of each match as it's found, from multiple threads and in no particular order.</param>
+        /// <param name="bufferSize">Bytes read per chunk.</param>
+        public static void FindBytes(IntPtr processHandle, BytePattern pattern, long startAddress, long endAddress, Action<long> onMatch, int bufferSize = ScanChunkSize)
+        {
+            var chunks = GetScanChunks(GetReadableRegions(processHandle, startAddress, endAddress), pattern.Length, bufferSize);
+            ScanChunks(chunks, pattern, (address, buffer, count) => ReadBytes(processHandle, address, buffer, 0, count), onMatch, false);
+        }
 
-            while (true)
+        /// <summary>
+        /// Gets the committed, readable regions of a processes memory within the given range, adjacent regions are merged.
+        /// </summary>
+        /// <param name="processHandle">A handle to the process with PROCESS_QUERY_INFORMATION access.</param>
+        /// <param name="startAddress">Start of the range.</param>
+        /// <param name="endAddress">End of the range, exclusive.</param>
+        /// <returns>Start and end address pairs</returns>
+        public static List<KeyValuePair<long, long>> GetReadableRegions(IntPtr processHandle, long startAddress, long endAddress)
+        {
+            var regions = new List<KeyValuePair<long, long>>();
+            var size = new IntPtr(Marshal.SizeOf<NativeMethods.MemoryBasicInformation>());
+            long address = startAddress;
+
+            while (address < endAddress && NativeMethods.VirtualQueryEx(processHandle, new IntPtr(address), out var info, size) != IntPtr.Zero)
             {
-                try
+                long regionStart = (long)info.BaseAddress;
+                long regionEnd = regionStart + (long)(ulong)info.RegionSize;
+
+                if (regionEnd <= address)
+                    break;
+
+                if (info.State == MemCommit && info.Protect != 0 && (info.Protect & (PageNoAccess | PageGuard)) == 0)
+                    AddRegion(regions, Math.Max(regionStart, startAddress), Math.Min(regionEnd, endAddress));
+
+                address = regionEnd;
+            }
+
+            return regions;
+        }
+
+        /// <summary>
+        /// Gets the readable regions of a processes memory within the given range from /proc/pid/maps (Linux), adjacent regions are merged.
+        /// </summary>
+        /// <param name="processID">ID of the process.</param>
+        /// <param name="startAddress">Start of the range.</param>
+        /// <param name="endAddress">End of the range, exclusive.</param>
+        /// <returns>Start and end address pairs</returns>
+        public static List<KeyValuePair<long, long>> GetReadableRegionsLinux(int processID, long startAddress, long endAddress)
+        {
+            var regions = new List<KeyValuePair<long, long>>();
+
+            // Each line is "start-end perms offset dev inode path"
+            foreach (var line in System.IO.File.ReadLines("/proc/" + processID + "/maps"))
+            {
+                var split = line.Split(' ');
+                var range = split[0].Split('-');
+
+                if (split.Length < 2 || range.Length != 2 || split[1][0] != 'r')
+                    continue;
+
+                long regionStart = long.Parse(range[0], System.Globalization.NumberStyles.HexNumber);
+                long regionEnd = long.Parse(range[1], System.Globalization.NumberStyles.HexNumber);
+
+                if (regionEnd > startAddress && regionStart < endAddress)
+                    AddRegion(regions, Math.Max(regionStart, startAddress), Math.Min(regionEnd, endAddress));
+            }
+
+            return regions;
+        }
+
+        /// <summary>
+        /// Splits regions into chunks to scan, each chunk overlaps the next by the length of the pattern minus one
+        /// so matches that straddle them are found once, by the chunk they start in.
+        /// </summary>
+        /// <param name="regions">Start and end address pairs.</param>
+        /// <param name="patternLength">Length of the pattern.</param>
+        /// <param name="chunkSize">Bytes each chunk owns.</param>
+        /// <returns>Chunks in ascending order</returns>
+        public static List<MemoryRange> GetScanChunks(List<KeyValuePair<long, long>> regions, int patternLength, int chunkSize)
+        {
+            var chunks = new List<MemoryRange>();
+            chunkSize = Math.Max(chunkSize, patternLength);
+
+            foreach (var region in regions)
+            {
+                for (long address = region.Key; address < region.Value; address += chunkSize)
                 {
-                    byte[] buffer = ReadBytes(processHandle, searchAddress, bufferSize);
+                    long length = Math.Min(chunkSize + patternLength - 1, region.Value - address);
 
-                    for (bufferIndex = 0; bufferIndex < buffer.Length; bufferIndex++)
-                    {
-                        if (needle[needleIndex] == null)
-                        {
-                            needleIndex++;
-                            continue;
-                        }
-
-                        if (needle[needleIndex] == buffer[bufferIndex])
-                        {
-                            needleIndex++;
-
-                            if (needleIndex == needle.Length)
-                            {
-                                results.Add(searchAddress + bufferIndex - needle.Length + 1);
-
-                                if (firstMatch)
-                                    return results.ToArray();
-
-                                needleIndex = 0;
-                            }
-                        }
-                        else
-                        {
-                            needleIndex = 0;
-                        }
-                    }
+                    if (length >= patternLength)
+                        chunks.Add(new MemoryRange(address, (int)length));
                 }
-                catch
+            }
+
+            return chunks;
+        }
+
+        /// <summary>
+        /// Scans the chunks in parallel and returns the matches in ascending order.
+        /// </summary>
+        /// <param name="chunks">Chunks from GetScanChunks.</param>
+        /// <param name="pattern">Pattern to scan for.</param>
+        /// <param name="read">Reads the given number of bytes at an address into the buffer, returns the number read.</param>
+        /// <param name="firstMatch">If we should only return the lowest match.</param>
+        /// <returns>Results</returns>
+        public static long[] CollectMatches(List<MemoryRange> chunks, BytePattern pattern, Func<long, byte[], int, int> read, bool firstMatch)
+        {
+            var results = new List<long>();
+
+            ScanChunks(chunks, pattern, read, address =>
+            {
+                lock (results)
                 {
-                    break;
+                    results.Add(address);
                 }
+            }, firstMatch);
 
-                searchAddress += bufferSize;
+            results.Sort();
 
-                if (searchAddress > endAddress)
-                    break;
-            }
+            if (firstMatch && results.Count > 1)
+                results.RemoveRange(1, results.Count - 1);
 
             return results.ToArray();
         }
+
+        /// <summary>
+        /// Scans the chunks in parallel on the thread pool, each worker reuses its own buffer.
+        /// </summary>
+        /// <param name="chunks">Chunks from GetScanChunks.</param>
+        /// <param name="pattern">Pattern to scan for.</param>
+        /// <param name="read">Reads the given number of bytes at an address into the buffer, returns the number read.</param>
+        /// <param name="onMatch">Called with the address of each match, from multiple threads.</param>
+        /// <param name="firstMatch">If we should stop once the lowest match is known, chunks before it still report theirs.</param>
+        public static void ScanChunks(List<MemoryRange> chunks, BytePattern pattern, Func<long, byte[], int, int> read, Action<long> onMatch, bool firstMatch)
+        {
+            int bufferSize = 0;
+
+            foreach (var chunk in chunks)
+                bufferSize = Math.Max(bufferSize, chunk.Length);
+
+            System.Threading.Tasks.Parallel.For(0, chunks.Count, () => new byte[bufferSize], (i, state, buffer) =>
+            {
+                // Break still runs chunks below the one that matched, skip the rest
+                if (state.ShouldExitCurrentIteration && state.LowestBreakIteration < i)
+                    return buffer;
+
+                var chunk = chunks[i];
+                int count = read(chunk.Address, buffer, chunk.Length);
+
+                for (int index = pattern.IndexOf(buffer, 0, count); index >= 0; index = pattern.IndexOf(buffer, index + 1, count))
+                {
+                    onMatch(chunk.Address + index);
+
+                    if (firstMatch)
+                    {
+                        state.Break();
+                        break;
+                    }
+                }
+
+                return buffer;
+            }, buffer => { });
+        }
+
+        /// <summary>
+        /// Adds a region, merging it with the previous one if they're adjacent
+        /// </summary>
+        private static void AddRegion(List<KeyValuePair<long, long>> regions, long start, long end)
+        {
+            if (start >= end)
+                return;
+
+            int last = regions.Count - 1;
+
+            if (last >= 0 && regions[last].Value == start)
+                regions[last] = new KeyValuePair<long, long>(regions[last].Key, end);
+            else
+                regions.Add(new KeyValuePair<long, long>(start, end));
+        }
     }
 }
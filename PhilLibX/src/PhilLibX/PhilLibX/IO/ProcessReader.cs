@@ -24,15 +24,42 @@
 // Author: Philip/Scobalula
 // Description: A class to help with reading the memory of other processes.
 using System;
+using System.Collections.Generic;
 using System.Diagnostics;
+using System.Text;
 
 namespace PhilLibX.IO
 {
     /// <summary>
     /// A class to help with reading the memory of other processes.
+    /// 
+    /// Reads use ReadProcessMemory on Windows and process_vm_readv on Linux. With the page cache
+    /// enabled, reads are served from whole pages that are only read from the process once, until
+    /// they are invalidated, so walking structures doesn't cost a call per field.
     /// </summary>
     public class ProcessReader
     {
+        /// <summary>
+        /// Maximum number of contiguous missing pages to load in one range
+        /// </summary>
+        private const int MaxPagesPerRange = 64;
+
+        /// <summary>
+        /// Buffer for reading primitives without allocating
+        /// </summary>
+        [ThreadStatic]
+        private static byte[] Scratch;
+
+        /// <summary>
+        /// Cached pages by address, null if the page couldn't be read
+        /// </summary>
+        private readonly Dictionary<long, byte[]> Pages = new Dictionary<long, byte[]>();
+
+        /// <summary>
+        /// Internal Process ID Property, used on Linux
+        /// </summary>
+        private int _ProcessID { get; set; }
+
         /// <summary>
         /// Internal Process Property
         /// </summary>
@@ -52,7 +79,10 @@ namespace PhilLibX.IO
             set
             {
                 _Process = value;
-                _Handle = _Process.Handle;
+                _ProcessID = _Process.Id;
+                // There's no handle to open on Linux, process_vm_readv takes the ID
+                _Handle = MemoryUtil.IsLinux ? IntPtr.Zero : _Process.Handle;
+                Invalidate();
             }
         }
 
@@ -61,6 +91,21 @@ namespace PhilLibX.IO
         /// </summary>
         public IntPtr Handle { get { return _Handle; } }
 
+        /// <summary>
+        /// Gets or Sets whether or not reads are served from the page cache, call Invalidate when the memory may have changed
+        /// </summary>
+        public bool CacheEnabled { get; set; }
+
+        /// <summary>
+        /// Gets or Sets the maximum number of pages to cache before the cache is cleared
+        /// </summary>
+        public int MaxCachedPages { get; set; } = 0x4000;
+
+        /// <summary>
+        /// Gets the number of reads made to the process
+        /// </summary>
+        public long ReadCalls { get; private set; }
+
         /// <summary>
         /// Initalizes a Process Reader with a Process
         /// </summary>
@@ -77,7 +122,108 @@ namespace PhilLibX.IO
         /// <returns>Bytes read</returns>
         public byte[] ReadBytes(long address, int numBytes)
         {
-            return MemoryUtil.ReadBytes(Handle, address, numBytes);
+            byte[] buffer = new byte[numBytes];
+            ReadBytes(address, buffer, 0, numBytes);
+            return buffer;
+        }
+
+        /// <summary>
+        /// Reads bytes from the Processes Memory into the given buffer
+        /// </summary>
+        /// <param name="address">The address of the data to be read.</param>
+        /// <param name="buffer">Buffer to read into</param>
+        /// <param name="offset">Offset within the buffer</param>
+        /// <param name="count">The number of bytes to be read.</param>
+        /// <returns>Number of bytes read, less than count if the read reached memory that can't be read</returns>
+        public int ReadBytes(long address, byte[] buffer, int offset, int count)
+        {
+            if (!CacheEnabled)
+            {
+                return ReadDirect(address, buffer, offset, count);
+            }
+
+            lock (Pages)
+            {
+                // Most reads are small and already cached, only build the range sets on a miss
+                if (!IsCached(address, count))
+                    LoadPages(new[] { new MemoryRange(address, count) });
+
+                return CopyFromPages(address, buffer, offset, count);
+            }
+        }
+
+        /// <summary>
+        /// Reads a list of ranges from the Processes Memory in as few calls as possible, on Linux up to 1024 ranges are
+        /// read per call. Ranges that can't be read are returned as zeros.
+        /// </summary>
+        /// <param name="ranges">Ranges to read</param>
+        /// <returns>Data for each range</returns>
+        public byte[][] ReadBatch(IList<MemoryRange> ranges)
+        {
+            var results = new byte[ranges.Count][];
+
+            if (CacheEnabled)
+            {
+                lock (Pages)
+                {
+                    // Load every page the ranges need at once, then copy out of them
+                    LoadPages(ranges);
+
+                    for (int i = 0; i < ranges.Count; i++)
+                    {
+                        results[i] = new byte[ranges[i].Length];
+                        CopyFromPages(ranges[i].Address, results[i], 0, ranges[i].Length);
+                    }
+                }
+
+                return results;
+            }
+
+            long total = 0;
+
+            foreach (var range in ranges)
+                total += range.Length;
+
+            var buffer = new byte[total];
+            ReadBatchDirect(ranges, buffer);
+
+            int offset = 0;
+
+            for (int i = 0; i < ranges.Count; i++)
+            {
+                results[i] = new byte[ranges[i].Length];
+                Buffer.BlockCopy(buffer, offset, results[i], 0, ranges[i].Length);
+                offset += ranges[i].Length;
+            }
+
+            return results;
+        }
+
+        /// <summary>
+        /// Drops all cached pages
+        /// </summary>
+        public void Invalidate()
+        {
+            lock (Pages)
+            {
+                Pages.Clear();
+            }
+        }
+
+        /// <summary>
+        /// Drops the cached pages that overlap the given range
+        /// </summary>
+        /// <param name="address">Start of the range that may have changed</param>
+        /// <param name="length">Length of the range</param>
+        public void Invalidate(long address, long length)
+        {
+            lock (Pages)
+            {
+                for (long page = PageOf(address); page < address + length; page += MemoryUtil.PageSize)
+                {
+                    Pages.Remove(page);
+                }
+            }
         }
 
         /// <summary>
@@ -87,7 +233,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public long ReadInt64(long address)
         {
-            return MemoryUtil.ReadInt64(Handle, address);
+            return BitConverter.ToInt64(ReadScratch(address, 8), 0);
         }
 
         /// <summary>
@@ -97,7 +243,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public ulong ReadUInt64(long address)
         {
-            return MemoryUtil.ReadUInt64(Handle, address);
+            return BitConverter.ToUInt64(ReadScratch(address, 8), 0);
         }
 
         /// <summary>
@@ -107,7 +253,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public int ReadInt32(long address)
         {
-            return MemoryUtil.ReadInt32(Handle, address);
+            return BitConverter.ToInt32(ReadScratch(address, 4), 0);
         }
 
         /// <summary>
@@ -117,7 +263,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public uint ReadUInt32(long address)
         {
-            return MemoryUtil.ReadUInt32(Handle, address);
+            return BitConverter.ToUInt32(ReadScratch(address, 4), 0);
         }
 
         /// <summary>
@@ -127,7 +273,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public short ReadInt16(long address)
         {
-            return MemoryUtil.ReadInt16(Handle, address);
+            return BitConverter.ToInt16(ReadScratch(address, 2), 0);
         }
 
         /// <summary>
@@ -137,7 +283,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public ushort ReadUInt16(long address)
         {
-            return MemoryUtil.ReadUInt16(Handle, address);
+            return BitConverter.ToUInt16(ReadScratch(address, 2), 0);
         }
 
         /// <summary>
@@ -147,7 +293,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public float ReadSingle(long address)
         {
-            return MemoryUtil.ReadSingle(Handle, address);
+            return BitConverter.ToSingle(ReadScratch(address, 4), 0);
         }
 
         /// <summary>
@@ -157,7 +303,7 @@ namespace PhilLibX.IO
         /// <returns>Resulting Data</returns>
         public double ReadDouble(long address)
         {
-            return MemoryUtil.ReadDouble(Handle, address);
+            return BitConverter.ToDouble(ReadScratch(address, 8), 0);
         }
 
         /// <summary>
@@ -166,9 +312,34 @@ namespace PhilLibX.IO
         /// <param name="address">Memory Address</param>
         /// <param name="bufferSize">Buffer Read Size</param>
         /// <returns>Resulting String</returns>
-        public string ReadNullTerminatedString(long address, int bufferSize = 0xFF)
+        public string ReadNullTerminatedString(long address, int bufferSize = MemoryUtil.PageSize)
         {
-            return MemoryUtil.ReadNullTerminatedString(Handle, address, bufferSize);
+            byte[] buffer = new byte[Math.Max(bufferSize, 1)];
+            StringBuilder result = null;
+
+            while (true)
+            {
+                // Never cross a page, the next one may not be mapped
+                int count = (int)Math.Min(buffer.Length, MemoryUtil.PageSize - (address & (MemoryUtil.PageSize - 1)));
+
+                if (ReadBytes(address, buffer, 0, count) != count)
+                    break;
+
+                int end = Array.IndexOf(buffer, (byte)0, 0, count);
+
+                if (end >= 0 && result == null)
+                    return Encoding.ASCII.GetString(buffer, 0, end);
+
+                result = result ?? new StringBuilder();
+                result.Append(Encoding.ASCII.GetString(buffer, 0, end >= 0 ? end : count));
+
+                if (end >= 0)
+                    break;
+
+                address += count;
+            }
+
+            return result?.ToString() ?? string.Empty;
         }
 
         /// <summary>
@@ -179,7 +350,27 @@ namespace PhilLibX.IO
         /// <returns>Resulting Struct</returns>
         public T ReadStruct<T>(long address)
         {
-            return MemoryUtil.ReadStruct<T>(Handle, address);
+            int size = System.Runtime.InteropServices.Marshal.SizeOf<T>();
+            byte[] data = Bytes.GetScratchBuffer(size);
+            Array.Clear(data, 0, size);
+            ReadBytes(address, data, 0, size);
+            return Bytes.BytesToStruct<T>(data);
+        }
+
+        /// <summary>
+        /// Reads an array of structs from the Processes Memory in one read
+        /// </summary>
+        /// <typeparam name="T">Struct Type</typeparam>
+        /// <param name="address">Memory Address</param>
+        /// <param name="count">Number of structs</param>
+        /// <returns>Resulting Structs</returns>
+        public T[] ReadArray<T>(long address, int count)
+        {
+            int size = Bytes.SizeOf<T>() * count;
+            byte[] data = Bytes.GetScratchBuffer(size);
+            Array.Clear(data, 0, size);
+            ReadBytes(address, data, 0, size);
+            return Bytes.BytesToArray<T>(data, 0, count);
         }
 
         /// <summary>
@@ -190,10 +381,25 @@ namespace PhilLibX.IO
         /// <param name="endAddress">Address to end the search at.</param>
         /// <param name="firstMatch">If we should stop the search at the first result.</param>
         /// <param name="bufferSize">Byte Buffer Size</param>
-        /// <returns>Results</returns>
-        public long[] FindBytes(byte?[] needle, long startAddress, long endAddress, bool firstMatch = false, int bufferSize = 0xFFFF)
+        /// <returns>Results in ascending order</returns>
+        public long[] FindBytes(byte?[] needle, long startAddress, long endAddress, bool firstMatch = false, int bufferSize = MemoryUtil.ScanChunkSize)
         {
-            return MemoryUtil.FindBytes(Handle, needle, startAddress, endAddress, firstMatch, bufferSize);
+            var chunks = MemoryUtil.GetScanChunks(GetReadableRegions(startAddress, endAddress), needle.Length, bufferSize);
+            return MemoryUtil.CollectMatches(chunks, new BytePattern(needle), ReadForScan, firstMatch);
+        }
+
+        /// <summary>
+        /// Searches for a pattern in the Processes Memory, scanning its readable regions in parallel
+        /// </summary>
+        /// <param name="pattern">Pattern to scan for.</param>
+        /// <param name="startAddress">Address to start the search at.</param>
+        /// <param name="endAddress">Address to end the search at.</param>
+        /// <param name="onMatch">Called with the address of each match as it's found, from multiple threads and in no particular order.</param>
+        /// <param name="bufferSize">Bytes read per chunk.</param>
+        public void FindBytes(BytePattern pattern, long startAddress, long endAddress, Action<long> onMatch, int bufferSize = MemoryUtil.ScanChunkSize)
+        {
+            var chunks = MemoryUtil.GetScanChunks(GetReadableRegions(startAddress, endAddress), pattern.Length, bufferSize);
+            MemoryUtil.ScanChunks(chunks, pattern, ReadForScan, onMatch, false);
         }
 
         /// <summary>
@@ -213,5 +419,216 @@ namespace PhilLibX.IO
         {
             return (long)ActiveProcess?.MainModule.ModuleMemorySize;
         }
+
+        /// <summary>
+        /// Reads a small value into the thread's scratch buffer, zeroed if the read fails
+        /// </summary>
+        private byte[] ReadScratch(long address, int numBytes)
+        {
+            var buffer = Scratch ?? (Scratch = new byte[8]);
+            Array.Clear(buffer, 0, numBytes);
+            ReadBytes(address, buffer, 0, numBytes);
+            return buffer;
+        }
+
+        /// <summary>
+        /// Gets the readable regions of the process within the given range
+        /// </summary>
+        private List<KeyValuePair<long, long>> GetReadableRegions(long startAddress, long endAddress)
+        {
+            if (MemoryUtil.IsLinux)
+                return MemoryUtil.GetReadableRegionsLinux(_ProcessID, startAddress, endAddress);
+
+            return MemoryUtil.GetReadableRegions(Handle, startAddress, endAddress);
+        }
+
+        /// <summary>
+        /// Reads a chunk for scanning, scans bypass the page cache as they read far more than it holds
+        /// </summary>
+        private int ReadForScan(long address, byte[] buffer, int count)
+        {
+            if (MemoryUtil.IsLinux)
+                return MemoryUtil.ReadBytesLinux(_ProcessID, address, buffer, 0, count);
+
+            return MemoryUtil.ReadBytes(Handle, address, buffer, 0, count);
+        }
+
+        /// <summary>
+        /// Reads straight from the process
+        /// </summary>
+        private int ReadDirect(long address, byte[] buffer, int offset, int count)
+        {
+            ReadCalls++;
+
+            if (MemoryUtil.IsLinux)
+                return MemoryUtil.ReadBytesLinux(_ProcessID, address, buffer, offset, count);
+
+            return MemoryUtil.ReadBytes(Handle, address, buffer, offset, count);
+        }
+
+        /// <summary>
+        /// Reads the ranges straight from the process into the buffer back to back
+        /// </summary>
+        private int[] ReadBatchDirect(IList<MemoryRange> ranges, byte[] buffer)
+        {
+            if (MemoryUtil.IsLinux)
+            {
+                ReadCalls += (ranges.Count + 1023) / 1024;
+                return MemoryUtil.ReadBatchLinux(_ProcessID, ranges, buffer, 0);
+            }
+
+            ReadCalls += ranges.Count;
+            return MemoryUtil.ReadBatch(Handle, ranges, buffer, 0);
+        }
+
+        /// <summary>
+        /// Gets the address of the page holding the given address
+        /// </summary>
+        private static long PageOf(long address)
+        {
+            return address & ~(long)(MemoryUtil.PageSize - 1);
+        }
+
+        /// <summary>
+        /// Checks if every page of the range is cached. Caller must hold the lock.
+        /// </summary>
+        private bool IsCached(long address, int count)
+        {
+            for (long page = PageOf(address); page < address + count; page += MemoryUtil.PageSize)
+            {
+                if (!Pages.ContainsKey(page))
+                    return false;
+            }
+
+            return true;
+        }
+
+        /// <summary>
+        /// Loads any pages the ranges need that aren't cached, in one batch. Caller must hold the lock.
+        /// </summary>
+        private void LoadPages(IList<MemoryRange> ranges)
+        {
+            var needed = new HashSet<long>();
+            var missing = new SortedSet<long>();
+
+            foreach (var range in ranges)
+            {
+                for (long page = PageOf(range.Address); page < range.Address + range.Length; page += MemoryUtil.PageSize)
+                {
+                    if (needed.Add(page) && !Pages.ContainsKey(page))
+                        missing.Add(page);
+                }
+            }
+
+            if (missing.Count == 0)
+                return;
+
+            // Make room, but keep the pages this request is about to copy from
+            if (Pages.Count + missing.Count > MaxCachedPages)
+            {
+                var stale = new List<long>();
+
+                foreach (var page in Pages.Keys)
+                {
+                    if (!needed.Contains(page))
+                        stale.Add(page);
+                }
+
+                foreach (var page in stale)
+                    Pages.Remove(page);
+            }
+
+            // Merge runs of contiguous pages into single ranges
+            var runs = new List<MemoryRange>();
+
+            foreach (var page in missing)
+            {
+                int last = runs.Count - 1;
+
+                if (last >= 0 && runs[last].Address + runs[last].Length == page && runs[last].Length < MaxPagesPerRange * MemoryUtil.PageSize)
+                    runs[last] = new MemoryRange(runs[last].Address, runs[last].Length + MemoryUtil.PageSize);
+                else
+                    runs.Add(new MemoryRange(page, MemoryUtil.PageSize));
+            }
+
+            var buffer = new byte[missing.Count * MemoryUtil.PageSize];
+            var results = ReadBatchDirect(runs, buffer);
+            var retry = new List<MemoryRange>();
+            int offset = 0;
+
+            for (int i = 0; i < runs.Count; i++)
+            {
+                // A run that reaches unmapped memory fails as a whole, read its pages one by one
+                if (results[i] != runs[i].Length && runs[i].Length > MemoryUtil.PageSize)
+                {
+                    for (long page = runs[i].Address; page < runs[i].Address + runs[i].Length; page += MemoryUtil.PageSize)
+                        retry.Add(new MemoryRange(page, MemoryUtil.PageSize));
+                }
+                else
+                {
+                    StorePages(runs[i], buffer, offset, results[i] == runs[i].Length);
+                }
+
+                offset += runs[i].Length;
+            }
+
+            if (retry.Count > 0)
+            {
+                buffer = new byte[retry.Count * MemoryUtil.PageSize];
+                results = ReadBatchDirect(retry, buffer);
+
+                for (int i = 0; i < retry.Count; i++)
+                    StorePages(retry[i], buffer, i * MemoryUtil.PageSize, results[i] == MemoryUtil.PageSize);
+            }
+        }
+
+        /// <summary>
+        /// Splits a read run into cached pages, pages of a run that couldn't be read are cached as null
+        /// </summary>
+        private void StorePages(MemoryRange run, byte[] buffer, int offset, bool readable)
+        {
+            for (int i = 0; i < run.Length; i += MemoryUtil.PageSize)
+            {
+                byte[] page = null;
+
+                if (readable)
+                {
+                    page = new byte[MemoryUtil.PageSize];
+                    Buffer.BlockCopy(buffer, offset + i, page, 0, MemoryUtil.PageSize);
+                }
+
+                Pages[run.Address + i] = page;
+            }
+        }
+
+        /// <summary>
+        /// Copies cached data into the buffer up to the first page that couldn't be read, the pages must be loaded.
+        /// Caller must hold the lock.
+        /// </summary>
+        /// <returns>Number of bytes copied</returns>
+        private int CopyFromPages(long address, byte[] buffer, int offset, int count)
+        {
+            int copied = 0;
+
+            while (copied < count)
+            {
+                var page = PageOf(address);
+                var data = Pages[page];
+
+                if (data == null)
+                    break;
+
+                int pageOffset = (int)(address - page);
+                int size = Math.Min(count - copied, MemoryUtil.PageSize - pageOffset);
+
+                Buffer.BlockCopy(data, pageOffset, buffer, offset, size);
+
+                address += size;
+                offset += size;
+                copied += size;
+            }
+
+            return copied;
+        }
     }
 }
@@ -106,6 +106,11 @@ namespace PhilLibX.Imaging
         /// </summary>
         public int PixelCount { get { return Width * Height; } }
 
+        /// <summary>
+        /// Raw pixel buffer, BGR(A) rows with no padding, valid while the bits are locked
+        /// </summary>
+        internal byte[] PixelBuffer { get { return Pixels; } }
+
         /// <summary>
         /// Initializes BitmapX with a new Bitmap
         /// </summary>
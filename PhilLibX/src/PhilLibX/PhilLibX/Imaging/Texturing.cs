@@ -25,6 +25,7 @@
 // Description: Utilities for dealing with textures such as normal maps, merged specular/gloss maps, etc.
 using System;
 using System.Drawing;
+using System.Runtime.InteropServices;
 
 namespace PhilLibX.Imaging
 {
@@ -33,17 +34,52 @@ namespace PhilLibX.Imaging
     /// </summary>
     public class Texturing
     {
+        /// <summary>
+        /// Whether or not to use the native kernels in PhilLibX.Interop, cleared if they fail to load
+        /// </summary>
+        private static bool UseNativeKernels = true;
+
+        /// <summary>
+        /// Runs a native kernel if PhilLibX.Interop is available
+        /// </summary>
+        /// <param name="kernel">Kernel to run, returns an HRESULT</param>
+        /// <returns>True if the kernel ran, false if the managed path should be used</returns>
+        private static bool TryNativeKernel(Func<int> kernel)
+        {
+            if (!UseNativeKernels)
+                return false;
+
+            int result;
+
+            try
+            {
+                result = kernel();
+            }
+            catch (Exception e) when (e is DllNotFoundException || e is EntryPointNotFoundException || e is BadImageFormatException)
+            {
+                UseNativeKernels = false;
+                return false;
+            }
+
+            Marshal.ThrowExceptionForHR(result);
+            return true;
+        }
+
         /// <summary>
         /// Expands an XY normal map to XYZ
         /// </summary>
         /// <param name="bitmapSource">Bitmap to patch</param>
         public static void ExpandNormalMap(BitmapX bitmapSource)
         {
-            // Loop X/Width
-            for (int x = 0; x < bitmapSource.Width; x++)
+            // Use the native row kernels if we can
+            if (TryNativeKernel(() => NativeMethods.TextureKernels_ExpandNormalMap(bitmapSource.PixelBuffer, bitmapSource.Width, bitmapSource.Height, bitmapSource.BytesPerPixel)))
+                return;
+
+            // Loop Y/Height
+            for (int y = 0; y < bitmapSource.Height; y++)
             {
-                // Loop Y/Height
-                for (int y = 0; y < bitmapSource.Height; y++)
+                // Loop X/Width
+                for (int x = 0; x < bitmapSource.Width; x++)
                 {
                     // Get Original Color
                     var color = bitmapSource.GetPixel(x, y);
@@ -69,24 +105,30 @@ namespace PhilLibX.Imaging
             using (BitmapX glossMap = new BitmapX(bitmapSource.Width, bitmapSource.Height))
             using (BitmapX occlusionMap = new BitmapX(bitmapSource.Width, bitmapSource.Height))
             {
-                // Loop X/Width
-                for (int x = 0; x < bitmapSource.Width; x++)
+                // Use the native row kernels if we can
+                if (!TryNativeKernel(() => NativeMethods.TextureKernels_SplitNormalGlossOcclusion(
+                    bitmapSource.PixelBuffer, bitmapSource.Width, bitmapSource.Height, bitmapSource.BytesPerPixel,
+                    normalMap.PixelBuffer, glossMap.PixelBuffer, occlusionMap.PixelBuffer)))
                 {
                     // Loop Y/Height
                     for (int y = 0; y < bitmapSource.Height; y++)
                     {
-                        // Get Original Color
-                        var color = bitmapSource.GetPixel(x, y);
+                        // Loop X/Width
+                        for (int x = 0; x < bitmapSource.Width; x++)
+                        {
+                            // Get Original Color
+                            var color = bitmapSource.GetPixel(x, y);
 
-                        // Set Values
-                        var normalColor    = Color.FromArgb(color.G, color.A, CalculateNormalMapZValue(color.G, color.A));
-                        var glossColor     = Color.FromArgb(color.R, color.R, color.R);
-                        var occlusionColor = Color.FromArgb(color.B, color.B, color.B);
+                            // Set Values
+                            var normalColor    = Color.FromArgb(color.G, color.A, CalculateNormalMapZValue(color.G, color.A));
+                            var glossColor     = Color.FromArgb(color.R, color.R, color.R);
+                            var occlusionColor = Color.FromArgb(color.B, color.B, color.B);
 
-                        // Patch Pixels
-                        normalMap.SetPixel( x, y, normalColor);
-                        glossMap.SetPixel(x, y, glossColor);
-                        occlusionMap.SetPixel(x, y, occlusionColor);
+                            // Patch Pixels
+                            normalMap.SetPixel( x, y, normalColor);
+                            glossMap.SetPixel(x, y, glossColor);
+                            occlusionMap.SetPixel(x, y, occlusionColor);
+                        }
                     }
                 }
 
@@ -110,23 +152,28 @@ namespace PhilLibX.Imaging
             using (BitmapX rgbMap = new BitmapX(bitmapSource.Width, bitmapSource.Height))
             using (BitmapX alphaMap = new BitmapX(bitmapSource.Width, bitmapSource.Height))
             {
-
-                // Loop X/Width
-                for (int x = 0; x < bitmapSource.Width; x++)
+                // Use the native row kernels if we can
+                if (!TryNativeKernel(() => NativeMethods.TextureKernels_SplitColorAndAlpha(
+                    bitmapSource.PixelBuffer, bitmapSource.Width, bitmapSource.Height, bitmapSource.BytesPerPixel,
+                    rgbMap.PixelBuffer, alphaMap.PixelBuffer)))
                 {
                     // Loop Y/Height
                     for (int y = 0; y < bitmapSource.Height; y++)
                     {
-                        // Get Original Color
-                        var color = bitmapSource.GetPixel(x, y);
+                        // Loop X/Width
+                        for (int x = 0; x < bitmapSource.Width; x++)
+                        {
+                            // Get Original Color
+                            var color = bitmapSource.GetPixel(x, y);
 
-                        // Set Values
-                        var rgbColor = Color.FromArgb(color.R, color.G, color.B);
-                        var alphaColor = Color.FromArgb(color.A, color.A, color.A);
+                            // Set Values
+                            var rgbColor = Color.FromArgb(color.R, color.G, color.B);
+                            var alphaColor = Color.FromArgb(color.A, color.A, color.A);
 
-                        // Patch Pixels
-                        rgbMap.SetPixel(x, y, rgbColor);
-                        alphaMap.SetPixel(x, y, alphaColor);
+                            // Patch Pixels
+                            rgbMap.SetPixel(x, y, rgbColor);
+                            alphaMap.SetPixel(x, y, alphaColor);
+                        }
                     }
                 }
 
@@ -158,37 +205,42 @@ namespace PhilLibX.Imaging
             using (BitmapX albedoMap = new BitmapX(albedoSource.Width, albedoSource.Height))
             using (BitmapX specularMap = new BitmapX(albedoSource.Width, albedoSource.Height))
             {
-
-                // Loop X/Width
-                for (int x = 0; x < albedoSource.Width; x++)
+                // Use the native row kernels if we can
+                if (!TryNativeKernel(() => NativeMethods.TextureKernels_SplitSpecularAlbedo(
+                    albedoSource.PixelBuffer, albedoSource.BytesPerPixel, specularMaskSource.PixelBuffer, specularMaskSource.BytesPerPixel,
+                    albedoSource.Width, albedoSource.Height, channel, clampValue, albedoMap.PixelBuffer, specularMap.PixelBuffer)))
                 {
                     // Loop Y/Height
                     for (int y = 0; y < albedoSource.Height; y++)
                     {
-                        // Get Values 
-                        var albedoSourceColor = albedoSource.GetPixel(x, y);
-                        var specularMaskSourceColor = specularMaskSource.GetPixel(x, y);
+                        // Loop X/Width
+                        for (int x = 0; x < albedoSource.Width; x++)
+                        {
+                            // Get Values 
+                            var albedoSourceColor = albedoSource.GetPixel(x, y);
+                            var specularMaskSourceColor = specularMaskSource.GetPixel(x, y);
 
-                        // Specular/Metallic value
-                        double specularAmount = MathUtilities.Clamp(GetChannelByIndex(specularMaskSourceColor, channel) / 255.0, 1.0, 0.0);
+                            // Specular/Metallic value
+                            double specularAmount = MathUtilities.Clamp(GetChannelByIndex(specularMaskSourceColor, channel) / 255.0, 1.0, 0.0);
 
-                        // Color Map Value (if metalic will be black)
-                        double colorAmount = 1 - specularAmount;
+                            // Color Map Value (if metalic will be black)
+                            double colorAmount = 1 - specularAmount;
 
-                        // Set Values
-                        var specularColor = Color.FromArgb(
-                            specularAmount > 0.5 ? (int)MathUtilities.Clamp((albedoSourceColor.R * specularAmount), 255, clampValue) : 56,
-                            specularAmount > 0.5 ? (int)MathUtilities.Clamp((albedoSourceColor.G * specularAmount), 255, clampValue) : 56,
-                            specularAmount > 0.5 ? (int)MathUtilities.Clamp((albedoSourceColor.B * specularAmount), 255, clampValue) : 56);
-                        var albedoColor = Color.FromArgb(
-                            albedoSourceColor.A,
-                            colorAmount < 0.5 ? (int)(albedoSourceColor.R * colorAmount) : albedoSourceColor.R,
-                            colorAmount < 0.5 ? (int)(albedoSourceColor.G * colorAmount) : albedoSourceColor.G,
-                            colorAmount < 0.5 ? (int)(albedoSourceColor.B * colorAmount) : albedoSourceColor.B);
+                            // Set Values
+                            var specularColor = Color.FromArgb(
+                                specularAmount > 0.5 ? (int)MathUtilities.Clamp((albedoSourceColor.R * specularAmount), 255, clampValue) : 56,
+                                specularAmount > 0.5 ? (int)MathUtilities.Clamp((albedoSourceColor.G * specularAmount), 255, clampValue) : 56,
+                                specularAmount > 0.5 ? (int)MathUtilities.Clamp((albedoSourceColor.B * specularAmount), 255, clampValue) : 56);
+                            var albedoColor = Color.FromArgb(
+                                albedoSourceColor.A,
+                                colorAmount < 0.5 ? (int)(albedoSourceColor.R * colorAmount) : albedoSourceColor.R,
+                                colorAmount < 0.5 ? (int)(albedoSourceColor.G * colorAmount) : albedoSourceColor.G,
+                                colorAmount < 0.5 ? (int)(albedoSourceColor.B * colorAmount) : albedoSourceColor.B);
 
-                        // Patch Pixels
-                        albedoMap.SetPixel(x, y, albedoColor);
-                        specularMap.SetPixel(x, y, specularColor);
+                            // Patch Pixels
+                            albedoMap.SetPixel(x, y, albedoColor);
+                            specularMap.SetPixel(x, y, specularColor);
+                        }
                     }
                 }
 
@@ -219,27 +271,32 @@ namespace PhilLibX.Imaging
             using (BitmapX bMap = new BitmapX(bitmapSource.Width, bitmapSource.Height))
             using (BitmapX aMap = new BitmapX(bitmapSource.Width, bitmapSource.Height))
             {
-
-                // Loop X/Width
-                for (int x = 0; x < bitmapSource.Width; x++)
+                // Use the native row kernels if we can
+                if (!TryNativeKernel(() => NativeMethods.TextureKernels_SplitAllChannels(
+                    bitmapSource.PixelBuffer, bitmapSource.Width, bitmapSource.Height, bitmapSource.BytesPerPixel,
+                    rMap.PixelBuffer, gMap.PixelBuffer, bMap.PixelBuffer, aMap.PixelBuffer)))
                 {
                     // Loop Y/Height
                     for (int y = 0; y < bitmapSource.Height; y++)
                     {
-                        // Get Original Color
-                        var color = bitmapSource.GetPixel(x, y);
+                        // Loop X/Width
+                        for (int x = 0; x < bitmapSource.Width; x++)
+                        {
+                            // Get Original Color
+                            var color = bitmapSource.GetPixel(x, y);
 
-                        // Set Values
-                        var rCol = Color.FromArgb(color.R, color.R, color.R);
-                        var gCol = Color.FromArgb(color.G, color.G, color.G);
-                        var bCol = Color.FromArgb(color.B, color.B, color.B);
-                        var aCol = Color.FromArgb(color.A, color.A, color.A);
+                            // Set Values
+                            var rCol = Color.FromArgb(color.R, color.R, color.R);
+                            var gCol = Color.FromArgb(color.G, color.G, color.G);
+                            var bCol = Color.FromArgb(color.B, color.B, color.B);
+                            var aCol = Color.FromArgb(color.A, color.A, color.A);
 
-                        // Patch Pixels
-                        rMap.SetPixel(x, y, rCol);
-                        gMap.SetPixel(x, y, gCol);
-                        bMap.SetPixel(x, y, bCol);
-                        aMap.SetPixel(x, y, aCol);
+                            // Patch Pixels
+                            rMap.SetPixel(x, y, rCol);
+                            gMap.SetPixel(x, y, gCol);
+                            bMap.SetPixel(x, y, bCol);
+                            aMap.SetPixel(x, y, aCol);
+                        }
                     }
                 }
 
@@ -38,6 +38,11 @@ namespace PhilLibX
         /// </summary>
         private const string OodleLibraryPath = "oo2core_6_win64";
 
+        /// <summary>
+        /// PhilLibX Interop Library Path
+        /// </summary>
+        private const string InteropLibraryPath = "PhilLibX.Interop";
+
 
         /// <summary>
         /// Reads data from an area of memory in a specified process. The entire area to be read must be accessible or the operation fails.
@@ -58,6 +63,64 @@ namespace PhilLibX
                 out int lpNumberOfBytesRead
             );
 
+        /// <summary>
+        /// Reads data from an area of memory in a specified process. The entire area to be read must be accessible or the operation fails.
+        /// </summary>
+        /// <param name="hProcess">A handle to the process with memory that is being read. The handle must have PROCESS_VM_READ access to the process.</param>
+        /// <param name="lpBaseAddress">A pointer to the base address in the specified process from which to read.</param>
+        /// <param name="lpBuffer">A pointer to a pinned buffer that receives the contents from the address space of the specified process.</param>
+        /// <param name="nSize">The number of bytes to be read from the specified process.</param>
+        /// <param name="lpNumberOfBytesRead">A pointer to a variable that receives the number of bytes transferred into the specified buffer.</param>
+        /// <returns></returns>
+        [DllImport("kernel32.dll", SetLastError = true)]
+        public static extern bool ReadProcessMemory
+            (
+                int hProcess,
+                long lpBaseAddress,
+                IntPtr lpBuffer,
+                int nSize,
+                out int lpNumberOfBytesRead
+            );
+
+        /// <summary>
+        /// Describes a buffer for process_vm_readv
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        public struct IOVec
+        {
+            /// <summary>
+            /// Start address
+            /// </summary>
+            public IntPtr Base;
+
+            /// <summary>
+            /// Number of bytes
+            /// </summary>
+            public UIntPtr Length;
+        }
+
+        /// <summary>
+        /// Transfers data from the remote process to the local process (Linux). Elements are transferred in order and
+        /// never split, the call stops at the first remote element that can't be read.
+        /// </summary>
+        /// <param name="pid">ID of the process with memory that is being read.</param>
+        /// <param name="localIov">Local buffers to read into.</param>
+        /// <param name="liovcnt">Number of local buffers.</param>
+        /// <param name="remoteIov">Remote ranges to read from.</param>
+        /// <param name="riovcnt">Number of remote ranges, at most 1024.</param>
+        /// <param name="flags">Unused, must be 0.</param>
+        /// <returns>Number of bytes read, or -1 on error.</returns>
+        [DllImport("libc", SetLastError = true)]
+        public static extern IntPtr process_vm_readv
+            (
+                int pid,
+                IOVec[] localIov,
+                UIntPtr liovcnt,
+                IOVec[] remoteIov,
+                UIntPtr riovcnt,
+                UIntPtr flags
+            );
+
         /// <summary>
         /// Reads data from an area of memory in a specified process. The entire area to be read must be accessible or the operation fails.
         /// </summary>
@@ -77,6 +140,38 @@ namespace PhilLibX
                 out int lpNumberOfBytesRead
             );
 
+        /// <summary>
+        /// Information about a range of pages in the virtual address space of a process.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        public struct MemoryBasicInformation
+        {
+            public IntPtr BaseAddress;
+            public IntPtr AllocationBase;
+            public uint AllocationProtect;
+            public UIntPtr RegionSize;
+            public uint State;
+            public uint Protect;
+            public uint Type;
+        }
+
+        /// <summary>
+        /// Retrieves information about a range of pages within the virtual address space of a specified process.
+        /// </summary>
+        /// <param name="hProcess">A handle to the process whose memory information is queried. The handle must have PROCESS_QUERY_INFORMATION access.</param>
+        /// <param name="lpAddress">The base address of the region of pages to be queried.</param>
+        /// <param name="lpBuffer">Receives information about the specified page range.</param>
+        /// <param name="dwLength">The size of the buffer pointed to by the lpBuffer parameter, in bytes.</param>
+        /// <returns>The number of bytes returned in the information buffer, 0 past the end of the address space.</returns>
+        [DllImport("kernel32.dll", SetLastError = true)]
+        public static extern IntPtr VirtualQueryEx
+            (
+                IntPtr hProcess,
+                IntPtr lpAddress,
+                out MemoryBasicInformation lpBuffer,
+                IntPtr dwLength
+            );
+
         /// <summary>
         /// Opens an existing local process object.
         /// </summary>
@@ -97,5 +192,35 @@ namespace PhilLibX
         /// </summary>
         [DllImport(OodleLibraryPath, CallingConvention = CallingConvention.Cdecl)]
         public static extern long OodleLZ_Decompress(byte[] buffer, long bufferSize, byte[] result, long outputBufferSize, int a, int b, int c, long d, long e, long f, long g, long h, long i, int ThreadModule);
+
+        /// <summary>
+        /// Replaces blue with the normal's Z calculated from red and green, and alpha with 255, in place. Returns an HRESULT
+        /// </summary>
+        [DllImport(InteropLibraryPath, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextureKernels_ExpandNormalMap(byte[] pixels, int width, int height, int bytesPerPixel);
+
+        /// <summary>
+        /// Splits a green/alpha normal, red gloss and blue occlusion map into 32bpp buffers. Returns an HRESULT
+        /// </summary>
+        [DllImport(InteropLibraryPath, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextureKernels_SplitNormalGlossOcclusion(byte[] source, int width, int height, int bytesPerPixel, byte[] normal, byte[] gloss, byte[] occlusion);
+
+        /// <summary>
+        /// Splits the color and alpha channels into 32bpp buffers. Returns an HRESULT
+        /// </summary>
+        [DllImport(InteropLibraryPath, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextureKernels_SplitColorAndAlpha(byte[] source, int width, int height, int bytesPerPixel, byte[] color, byte[] alpha);
+
+        /// <summary>
+        /// Splits every channel into 32bpp gray buffers. Returns an HRESULT
+        /// </summary>
+        [DllImport(InteropLibraryPath, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextureKernels_SplitAllChannels(byte[] source, int width, int height, int bytesPerPixel, byte[] red, byte[] green, byte[] blue, byte[] alpha);
+
+        /// <summary>
+        /// Splits albedo and specular maps into 32bpp buffers using a channel of the mask. Returns an HRESULT
+        /// </summary>
+        [DllImport(InteropLibraryPath, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextureKernels_SplitSpecularAlbedo(byte[] source, int sourceBytesPerPixel, byte[] mask, int maskBytesPerPixel, int width, int height, int channel, int clampValue, byte[] albedo, byte[] specular);
     }
 }